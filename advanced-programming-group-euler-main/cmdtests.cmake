@@ -103,3 +103,33 @@ set_tests_properties(ThinSlabProjectionMinIP PROPERTIES TIMEOUT 60)
 set_tests_properties(ThinSlabSliceXZGaussian PROPERTIES TIMEOUT 120)
 set_tests_properties(ThinSlabProjectMIPMedian PROPERTIES TIMEOUT 120)
 
+
+# Raw volume format: export the stack once, then work from the mapped file
+add_test(NAME ExportRaw COMMAND APImageFilters
+         -d ${SOURCE_DIR}/Scans/TestVolume/vol --export-raw ${OUTPUT_DIR}/TestVolume.apv)
+add_test(NAME RawProjectionMIP COMMAND APImageFilters
+         -d ${OUTPUT_DIR}/TestVolume.apv --verify -p MIP ${OUTPUT_DIR}/projectionMIPraw.png)
+set_tests_properties(RawProjectionMIP PROPERTIES DEPENDS ExportRaw)
+# -f/-l on a raw volume must give the same slab as on the stack
+add_test(NAME RawThinSlabProjectionMIP COMMAND APImageFilters
+         -d ${OUTPUT_DIR}/TestVolume.apv -f 4 -l 28 -p MIP ${OUTPUT_DIR}/projectionMIPthinslabraw.png)
+set_tests_properties(RawThinSlabProjectionMIP PROPERTIES DEPENDS ExportRaw)
+add_test(NAME RawThinSlabMatchesStack COMMAND ${CMAKE_COMMAND} -E compare_files
+         ${OUTPUT_DIR}/projectionMIPthinslab.png ${OUTPUT_DIR}/projectionMIPthinslabraw.png)
+set_tests_properties(RawThinSlabMatchesStack PROPERTIES DEPENDS "ThinSlabProjectionMIP;RawThinSlabProjectionMIP")
+add_test(NAME ExportBricked COMMAND APImageFilters
+         -d ${SOURCE_DIR}/Scans/TestVolume/vol --export-bricked ${OUTPUT_DIR}/TestVolume.apb)
+add_test(NAME BrickedSliceYZ COMMAND APImageFilters
+         -d ${OUTPUT_DIR}/TestVolume.apb -s YZ 16 ${OUTPUT_DIR}/sliceYZbricked.png)
+set_tests_properties(BrickedSliceYZ PROPERTIES DEPENDS ExportBricked)
+# -f/-l on a bricked volume must give the same slab as on the stack
+add_test(NAME BrickedThinSlabProjectionMIP COMMAND APImageFilters
+         -d ${OUTPUT_DIR}/TestVolume.apb -f 4 -l 28 -p MIP ${OUTPUT_DIR}/projectionMIPthinslabbricked.png)
+set_tests_properties(BrickedThinSlabProjectionMIP PROPERTIES DEPENDS ExportBricked)
+add_test(NAME BrickedThinSlabMatchesStack COMMAND ${CMAKE_COMMAND} -E compare_files
+         ${OUTPUT_DIR}/projectionMIPthinslab.png ${OUTPUT_DIR}/projectionMIPthinslabbricked.png)
+set_tests_properties(BrickedThinSlabMatchesStack PROPERTIES DEPENDS "ThinSlabProjectionMIP;BrickedThinSlabProjectionMIP")
+
+# Lazily opened stack with a slice cache far smaller than the volume
+add_test(NAME CachedSliceXZ COMMAND APImageFilters
+         -d ${SOURCE_DIR}/Scans/TestVolume/vol --cache-mb 0 -s XZ 16 -p MIP ${OUTPUT_DIR}/sliceXZcached.png)
@@ -0,0 +1,80 @@
+/**
+ * @file AlignedAllocator.h
+ * @brief Declaration of the AlignedAllocator used for contiguous pixel and voxel buffers
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <limits>
+
+/**
+ * @brief Minimal standard-conforming allocator returning over-aligned memory
+ *
+ * Used with std::vector so that sample buffers start on a cache-line boundary,
+ * which keeps row pointers friendly to vectorised loads.
+ *
+ * @tparam T Element type
+ * @tparam Alignment Alignment in bytes (must be a power of two)
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    /**
+     * @brief Rebind helper so containers can allocate other element types
+     */
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /**
+     * @brief Allocate uninitialised storage for n elements
+     *
+     * @param n Number of elements
+     * @return T* Pointer aligned to Alignment bytes
+     * @throws std::bad_array_new_length If n is too large
+     */
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    /**
+     * @brief Release storage obtained from allocate()
+     *
+     * @param p Pointer returned by allocate()
+     */
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+#endif // ALIGNED_ALLOCATOR_H
@@ -0,0 +1,420 @@
+/**
+ * @file BrickedVolume.cpp
+ * @brief Implementation of the BrickedVolume class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "BrickedVolume.h"
+#include "Volume.h"
+#include "Image.h"
+#include "Slice.h"
+#include "ThreadPool.h"
+#include "projectionFunc/Projection.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// Anonymous namespace to keep the file format and codec local to this file
+namespace {
+    // On-disk header; the brick index follows it, then the brick data
+    struct BrickedHeader {
+        char magic[8];             ///< "APBRICKS"
+        std::uint32_t version;     ///< Format version (1)
+        std::uint32_t headerSize;  ///< Bytes before the brick index (64)
+        std::int32_t width;
+        std::int32_t height;
+        std::int32_t depth;
+        std::int32_t channels;
+        std::int32_t brickSize;
+        std::uint32_t reserved;
+        std::uint64_t brickCount;
+        std::uint64_t dataSize;    ///< Bytes of brick data after the index
+        unsigned char padding[8];
+    };
+    static_assert(sizeof(BrickedHeader) == 64, "Bricked volume header must be 64 bytes");
+
+    constexpr char BRICKED_MAGIC[8] = {'A', 'P', 'B', 'R', 'I', 'C', 'K', 'S'};
+    constexpr std::uint32_t BRICKED_VERSION = 1;
+    constexpr std::uint32_t CODEC_STORED = 0;      ///< Samples as they are
+    constexpr std::uint32_t CODEC_DELTA_RLE = 1;   ///< Channel-wise deltas, run-length encoded
+
+    // Runs shorter than this are cheaper as literals
+    constexpr int MIN_RUN = 3;
+    constexpr int MAX_RUN = 127 + MIN_RUN;
+    constexpr int MAX_LITERALS = 128;
+
+    // Replace every sample by its difference from the same channel of the previous voxel
+    void deltaEncode(std::vector<unsigned char>& samples, int channels) {
+        for (size_t i = samples.size(); i-- > static_cast<size_t>(channels);) {
+            samples[i] = static_cast<unsigned char>(samples[i] - samples[i - channels]);
+        }
+    }
+
+    void deltaDecode(unsigned char* samples, size_t count, int channels) {
+        for (size_t i = channels; i < count; ++i) {
+            samples[i] = static_cast<unsigned char>(samples[i] + samples[i - channels]);
+        }
+    }
+
+    // Control byte c < 128: c + 1 literal bytes follow.
+    // Control byte c >= 128: the next byte repeats c - 128 + MIN_RUN times.
+    void rleEncode(const std::vector<unsigned char>& input, std::vector<unsigned char>& output) {
+        output.clear();
+        size_t i = 0;
+        size_t literalStart = 0;
+        auto flushLiterals = [&](size_t end) {
+            while (literalStart < end) {
+                size_t count = std::min<size_t>(MAX_LITERALS, end - literalStart);
+                output.push_back(static_cast<unsigned char>(count - 1));
+                output.insert(output.end(), input.begin() + literalStart, input.begin() + literalStart + count);
+                literalStart += count;
+            }
+        };
+        while (i < input.size()) {
+            size_t run = 1;
+            while (i + run < input.size() && run < MAX_RUN && input[i + run] == input[i]) {
+                ++run;
+            }
+            if (run >= MIN_RUN) {
+                flushLiterals(i);
+                output.push_back(static_cast<unsigned char>(128 + run - MIN_RUN));
+                output.push_back(input[i]);
+                i += run;
+                literalStart = i;
+            } else {
+                i += run;
+            }
+        }
+        flushLiterals(input.size());
+    }
+
+    // Decode exactly `count` bytes; false if the data is malformed
+    bool rleDecode(const unsigned char* input, size_t size, unsigned char* output, size_t count) {
+        size_t in = 0;
+        size_t out = 0;
+        while (in < size && out < count) {
+            unsigned char control = input[in++];
+            if (control < 128) {
+                size_t literals = control + 1;
+                if (in + literals > size || out + literals > count) return false;
+                std::memcpy(output + out, input + in, literals);
+                in += literals;
+                out += literals;
+            } else {
+                size_t run = control - 128 + MIN_RUN;
+                if (in >= size || out + run > count) return false;
+                std::memset(output + out, input[in++], run);
+                out += run;
+            }
+        }
+        return in == size && out == count;
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// WRITING
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Compress every brick, then write the header, the index and the brick data
+bool BrickedVolume::save(const Volume& volume, const std::string& filename, int brickSize) {
+    static_assert(std::endian::native == std::endian::little, "Bricked volumes are stored little-endian");
+    if (brickSize < 1) {
+        throw std::invalid_argument("Brick size must be at least 1");
+    }
+
+    int width, height, depth;
+    std::tie(width, height, depth) = volume.getDimensions3D();
+    const int channels = volume.getChannels();
+    const int bricksX = (width + brickSize - 1) / brickSize;
+    const int bricksY = (height + brickSize - 1) / brickSize;
+    const int bricksZ = (depth + brickSize - 1) / brickSize;
+    const int brickCount = bricksX * bricksY * bricksZ;
+
+    std::vector<std::vector<unsigned char>> payloads(brickCount);
+    std::vector<std::uint32_t> codecs(brickCount);
+    ThreadPool::shared().parallelFor(0, brickCount, [&](int begin, int end) {
+        std::vector<unsigned char> samples;
+        for (int b = begin; b < end; ++b) {
+            int x0 = (b % bricksX) * brickSize;
+            int y0 = (b / bricksX % bricksY) * brickSize;
+            int z0 = (b / (bricksX * bricksY)) * brickSize;
+            int bw = std::min(brickSize, width - x0);
+            int bh = std::min(brickSize, height - y0);
+            int bd = std::min(brickSize, depth - z0);
+
+            // Gather the brick's rows into one compact run
+            size_t rowBytes = static_cast<size_t>(bw) * channels;
+            samples.resize(rowBytes * bh * bd);
+            unsigned char* dst = samples.data();
+            for (int z = z0; z < z0 + bd; ++z) {
+                for (int y = y0; y < y0 + bh; ++y) {
+                    std::memcpy(dst, volume.getVoxelPtr(x0, y, z), rowBytes);
+                    dst += rowBytes;
+                }
+            }
+
+            // Keep the encoded brick only if it is smaller
+            std::vector<unsigned char> raw = samples;
+            deltaEncode(samples, channels);
+            rleEncode(samples, payloads[b]);
+            if (payloads[b].size() < raw.size()) {
+                codecs[b] = CODEC_DELTA_RLE;
+            } else {
+                payloads[b] = std::move(raw);
+                codecs[b] = CODEC_STORED;
+            }
+        }
+    });
+
+    BrickedHeader header = {};
+    std::memcpy(header.magic, BRICKED_MAGIC, sizeof(BRICKED_MAGIC));
+    header.version = BRICKED_VERSION;
+    header.headerSize = sizeof(BrickedHeader);
+    header.width = width;
+    header.height = height;
+    header.depth = depth;
+    header.channels = channels;
+    header.brickSize = brickSize;
+    header.brickCount = brickCount;
+
+    std::vector<BrickEntry> entries(brickCount);
+    std::uint64_t offset = sizeof(BrickedHeader) + sizeof(BrickEntry) * entries.size();
+    for (int b = 0; b < brickCount; ++b) {
+        entries[b] = {offset, static_cast<std::uint32_t>(payloads[b].size()), codecs[b]};
+        offset += payloads[b].size();
+        header.dataSize += payloads[b].size();
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), sizeof(BrickEntry) * entries.size());
+    for (const auto& payload : payloads) {
+        out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// READING
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Map the file and validate the header and the brick index
+BrickedVolume::BrickedVolume(const std::string& filename)
+    : filename(filename), file(std::make_shared<MappedFile>(filename)) {
+    static_assert(sizeof(BrickEntry) == 16, "Brick index entries must be 16 bytes");
+
+    BrickedHeader header;
+    if (file->size() < sizeof(header)) {
+        throw std::runtime_error("Not a bricked volume file (too short): " + filename);
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, BRICKED_MAGIC, sizeof(BRICKED_MAGIC)) != 0) {
+        throw std::runtime_error("Not a bricked volume file: " + filename);
+    }
+    if (header.version != BRICKED_VERSION || header.headerSize != sizeof(BrickedHeader)) {
+        throw std::runtime_error("Unsupported bricked volume version " + std::to_string(header.version) +
+                                 ": " + filename);
+    }
+    if (header.width <= 0 || header.height <= 0 || header.depth <= 0 ||
+        header.channels <= 0 || header.channels > 4 || header.brickSize <= 0) {
+        throw std::runtime_error("Invalid bricked volume dimensions: " + filename);
+    }
+
+    width = header.width;
+    height = header.height;
+    depth = header.depth;
+    storedDepth = depth;
+    channels = header.channels;
+    brickSize = header.brickSize;
+    bricksX = (width + brickSize - 1) / brickSize;
+    bricksY = (height + brickSize - 1) / brickSize;
+    bricksZ = (storedDepth + brickSize - 1) / brickSize;
+
+    std::uint64_t expectedCount = static_cast<std::uint64_t>(bricksX) * bricksY * bricksZ;
+    if (header.brickCount != expectedCount ||
+        file->size() < sizeof(header) + sizeof(BrickEntry) * expectedCount) {
+        throw std::runtime_error("Bricked volume index is truncated: " + filename);
+    }
+    index.resize(expectedCount);
+    std::memcpy(index.data(), file->data() + sizeof(header), sizeof(BrickEntry) * expectedCount);
+    // Bricks must lie after the index; written this way the bounds test cannot overflow
+    std::uint64_t dataStart = sizeof(header) + sizeof(BrickEntry) * expectedCount;
+    for (const BrickEntry& entry : index) {
+        if (entry.offset < dataStart || entry.offset > file->size() ||
+            entry.size > file->size() - entry.offset || entry.codec > CODEC_DELTA_RLE) {
+            throw std::runtime_error("Bricked volume data is truncated: " + filename);
+        }
+    }
+}
+
+std::tuple<int, int, int> BrickedVolume::getDimensions3D() const {
+    return std::make_tuple(width, height, depth);
+}
+
+// Later reads see only the slab; stored slices are found by adding zOrigin
+void BrickedVolume::cropDepth(int firstZ, int lastZ) {
+    if (firstZ < 0 || lastZ >= depth || firstZ > lastZ) {
+        throw std::out_of_range("Slice range out of bounds: " + std::to_string(firstZ) + " to " +
+                                std::to_string(lastZ) + " (valid range: 0-" + std::to_string(depth - 1) + ")");
+    }
+    zOrigin += firstZ;
+    depth = lastZ - firstZ + 1;
+}
+
+int BrickedVolume::getChannels() const {
+    return channels;
+}
+
+int BrickedVolume::getBrickSize() const {
+    return brickSize;
+}
+
+std::size_t BrickedVolume::getBrickCount() const {
+    return index.size();
+}
+
+std::size_t BrickedVolume::getCompressedSize() const {
+    std::size_t total = 0;
+    for (const BrickEntry& entry : index) {
+        total += entry.size;
+    }
+    return total;
+}
+
+// Decode one brick into compact samples
+void BrickedVolume::decodeBrick(int bx, int by, int bz, std::vector<unsigned char>& samples) const {
+    const BrickEntry& entry = index[(static_cast<size_t>(bz) * bricksY + by) * bricksX + bx];
+    size_t count = static_cast<size_t>(std::min(brickSize, width - bx * brickSize)) *
+                   std::min(brickSize, height - by * brickSize) *
+                   std::min(brickSize, storedDepth - bz * brickSize) * channels;
+    samples.resize(count);
+    const unsigned char* data = file->data() + entry.offset;
+
+    if (entry.codec == CODEC_STORED) {
+        if (entry.size != count) {
+            throw std::runtime_error("Corrupt brick in " + filename);
+        }
+        std::memcpy(samples.data(), data, count);
+        return;
+    }
+    if (!rleDecode(data, entry.size, samples.data(), count)) {
+        throw std::runtime_error("Corrupt brick in " + filename);
+    }
+    deltaDecode(samples.data(), count, channels);
+}
+
+// Decode the whole volume
+std::unique_ptr<Volume> BrickedVolume::load() const {
+    return loadRegion(0, 0, 0, width, height, depth);
+}
+
+// Decode the bricks overlapping the region and copy their overlap into it
+std::unique_ptr<Volume> BrickedVolume::loadRegion(int x, int y, int z,
+                                                  int regionWidth, int regionHeight, int regionDepth) const {
+    if (regionWidth <= 0 || regionHeight <= 0 || regionDepth <= 0 || x < 0 || y < 0 || z < 0 ||
+        x + regionWidth > width || y + regionHeight > height || z + regionDepth > depth) {
+        throw std::out_of_range("Region is outside the bricked volume");
+    }
+    auto region = std::make_unique<Volume>(regionWidth, regionHeight, regionDepth, channels);
+    z += zOrigin;  // From here on, Z is in stored slices
+
+    // Range of bricks touched along each axis
+    const int bx0 = x / brickSize, bx1 = (x + regionWidth - 1) / brickSize;
+    const int by0 = y / brickSize, by1 = (y + regionHeight - 1) / brickSize;
+    const int bz0 = z / brickSize, bz1 = (z + regionDepth - 1) / brickSize;
+    const int spanX = bx1 - bx0 + 1;
+    const int spanY = by1 - by0 + 1;
+    const int touched = spanX * spanY * (bz1 - bz0 + 1);
+
+    // Bricks cover disjoint parts of the region, so each thread fills its own
+    ThreadPool::shared().parallelFor(0, touched, [&](int begin, int end) {
+        std::vector<unsigned char> samples;
+        for (int t = begin; t < end; ++t) {
+            int bx = bx0 + t % spanX;
+            int by = by0 + t / spanX % spanY;
+            int bz = bz0 + t / (spanX * spanY);
+            decodeBrick(bx, by, bz, samples);
+
+            // Brick extent, and its overlap with the region in volume coordinates
+            int brickX = bx * brickSize, brickY = by * brickSize, brickZ = bz * brickSize;
+            int brickWidth = std::min(brickSize, width - brickX);
+            int brickHeight = std::min(brickSize, height - brickY);
+            int xBegin = std::max(x, brickX), xEnd = std::min(x + regionWidth, brickX + brickWidth);
+            int yBegin = std::max(y, brickY), yEnd = std::min(y + regionHeight, brickY + brickHeight);
+            int zBegin = std::max(z, brickZ), zEnd = std::min(z + regionDepth, brickZ + brickSize);
+            size_t rowBytes = static_cast<size_t>(xEnd - xBegin) * channels;
+
+            for (int vz = zBegin; vz < zEnd; ++vz) {
+                for (int vy = yBegin; vy < yEnd; ++vy) {
+                    size_t src = ((static_cast<size_t>(vz - brickZ) * brickHeight + (vy - brickY)) * brickWidth +
+                                  (xBegin - brickX)) * channels;
+                    std::memcpy(region->getVoxelPtr(xBegin - x, vy - y, vz - z), samples.data() + src, rowBytes);
+                }
+            }
+        }
+    });
+    return region;
+}
+
+// Decode only the plane's bricks, then cut the slice out of that thin region
+Image BrickedVolume::extractSlice(const Slice& slice) const {
+    int position = slice.getPosition();
+    int limit = (slice.getPlane() == SlicePlane::XY) ? depth
+              : (slice.getPlane() == SlicePlane::XZ) ? height : width;
+    if (position < 0 || position >= limit) {
+        const char* axis = (slice.getPlane() == SlicePlane::XY) ? "Z"
+                         : (slice.getPlane() == SlicePlane::XZ) ? "Y" : "X";
+        throw std::out_of_range(std::string(axis) + "-position is out of range: " + std::to_string(position) +
+                                " (valid range: 0-" + std::to_string(limit - 1) + ")");
+    }
+
+    std::unique_ptr<Volume> plane;
+    switch (slice.getPlane()) {
+        case SlicePlane::XY: plane = loadRegion(0, 0, position, width, height, 1); break;
+        case SlicePlane::XZ: plane = loadRegion(0, position, 0, width, 1, depth); break;
+        case SlicePlane::YZ: plane = loadRegion(position, 0, 0, 1, height, depth); break;
+    }
+    Slice thin;
+    thin.setPlane(slice.getPlane());
+    thin.setPosition(0);
+    return thin.extract(*plane);
+}
+
+// Feed the slab to the projection's accumulator one layer of bricks at a time
+Image BrickedVolume::applyProjection(const Projection& projection) const {
+    int startZ, endZ;
+    std::tie(startZ, endZ) = projection.getSlabRange(depth);
+    auto accumulator = projection.createAccumulator(width, height, channels, endZ - startZ + 1);
+
+    std::vector<ConstImageView> planes;
+    for (int layerBegin = startZ; layerBegin <= endZ;) {
+        int layerEnd = std::min(endZ + 1, ((zOrigin + layerBegin) / brickSize + 1) * brickSize - zOrigin);
+        auto layer = loadRegion(0, 0, layerBegin, width, height, layerEnd - layerBegin);
+        planes.clear();
+        for (int z = 0; z < layer->getDepth(); ++z) {
+            planes.push_back(static_cast<const Volume&>(*layer).getViewXY(z));
+        }
+        accumulator->addSlices(planes);
+        layerBegin = layerEnd;
+    }
+    return accumulator->result();
+}
@@ -0,0 +1,192 @@
+/**
+ * @file BrickedVolume.h
+ * @brief Declaration of the BrickedVolume class, a compressed, randomly accessible volume file
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef BRICKED_VOLUME_H
+#define BRICKED_VOLUME_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Forward declarations
+class Volume;
+class Image;
+class Slice;
+class Projection;
+
+/**
+ * @brief Read access to a bricked volume file (.apb)
+ *
+ * A bricked file splits the volume into cubes of getBrickSize()³ voxels (smaller at the
+ * far edges), each compressed on its own, and keeps an index of where every brick
+ * starts. Reading a region, a slice or a slab only decompresses the bricks it
+ * intersects, so an XZ or YZ slice of a large study touches one row or column of bricks
+ * rather than the whole file.
+ *
+ * Bricks are compressed by predicting every sample from the same channel of the
+ * previous voxel in the brick and run-length encoding the differences, which suits the
+ * smooth backgrounds of CT scans. A brick that would not shrink is stored as is.
+ *
+ * The file is memory-mapped when opened; nothing is decoded up front.
+ */
+class BrickedVolume {
+public:
+    static constexpr int DEFAULT_BRICK_SIZE = 32; ///< Edge length of a brick in voxels
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // WRITING
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Write a volume as a bricked file
+     *
+     * Bricks are compressed concurrently on the shared ThreadPool.
+     *
+     * @param volume The volume to store
+     * @param filename The file to write
+     * @param brickSize Edge length of a brick in voxels
+     * @return bool True if the file was written successfully, false otherwise
+     * @throws std::invalid_argument If brickSize is less than 1
+     */
+    static bool save(const Volume& volume, const std::string& filename, int brickSize = DEFAULT_BRICK_SIZE);
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // READING
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Open a bricked file and read its header and brick index
+     *
+     * @param filename The file to open
+     * @throws std::runtime_error If the file cannot be opened or is not a valid bricked volume
+     */
+    explicit BrickedVolume(const std::string& filename);
+
+    /**
+     * @brief Get the dimensions of the stored volume (of the slab, after cropDepth())
+     *
+     * @return std::tuple<int, int, int> Width, height and depth
+     */
+    std::tuple<int, int, int> getDimensions3D() const;
+
+    /**
+     * @brief Keep only the slices firstZ to lastZ (0-based, inclusive) for later reads
+     *
+     * Dimensions, regions, slices and projections are then relative to the slab, as if
+     * the file held just those slices, and only the bricks within it are decoded.
+     *
+     * @param firstZ First slice to keep
+     * @param lastZ Last slice to keep
+     * @throws std::out_of_range If the range is empty or outside the current slices
+     */
+    void cropDepth(int firstZ, int lastZ);
+
+    /**
+     * @brief Get the number of channels of the stored volume
+     */
+    int getChannels() const;
+
+    /**
+     * @brief Get the edge length of a brick in voxels
+     */
+    int getBrickSize() const;
+
+    /**
+     * @brief Get the number of bricks in the file
+     */
+    std::size_t getBrickCount() const;
+
+    /**
+     * @brief Get the total size of the compressed bricks in bytes
+     */
+    std::size_t getCompressedSize() const;
+
+    /**
+     * @brief Decompress the whole volume
+     *
+     * @return std::unique_ptr<Volume> The stored volume
+     */
+    std::unique_ptr<Volume> load() const;
+
+    /**
+     * @brief Decompress a box-shaped region of interest
+     *
+     * Only the bricks overlapping the region are decoded, concurrently on the shared
+     * ThreadPool.
+     *
+     * @param x First X-coordinate of the region
+     * @param y First Y-coordinate of the region
+     * @param z First Z-coordinate of the region
+     * @param regionWidth Width of the region
+     * @param regionHeight Height of the region
+     * @param regionDepth Depth of the region
+     * @return std::unique_ptr<Volume> A volume holding just the region
+     * @throws std::out_of_range If the region is empty or extends outside the volume
+     * @throws std::runtime_error If a brick is corrupt
+     */
+    std::unique_ptr<Volume> loadRegion(int x, int y, int z,
+                                       int regionWidth, int regionHeight, int regionDepth) const;
+
+    /**
+     * @brief Extract a slice, decoding only the bricks the plane passes through
+     *
+     * @param slice The slice to extract
+     * @return Image The same image Slice::extract() gives for the loaded volume
+     * @throws std::out_of_range If the slice position is outside the volume bounds
+     */
+    Image extractSlice(const Slice& slice) const;
+
+    /**
+     * @brief Apply a projection over its slab, one layer of bricks at a time
+     *
+     * Memory use is one layer of bricks plus the projection's accumulator.
+     *
+     * @param projection The projection to apply
+     * @return Image The same image the projection gives for the loaded volume
+     */
+    Image applyProjection(const Projection& projection) const;
+
+private:
+    /// Location and encoding of one brick's data in the file
+    struct BrickEntry {
+        std::uint64_t offset;   ///< Byte offset of the brick data from the start of the file
+        std::uint32_t size;     ///< Bytes of brick data
+        std::uint32_t codec;    ///< How the brick data is encoded
+    };
+
+    std::string filename;
+    std::shared_ptr<MappedFile> file;
+    std::vector<BrickEntry> index;  ///< Bricks in X, then Y, then Z order
+    int width, height, depth, channels;
+    int brickSize;
+    int bricksX, bricksY, bricksZ;
+    int storedDepth;    ///< Depth of the volume in the file (`depth` is the slab after cropDepth())
+    int zOrigin = 0;    ///< Stored slice that cropDepth() made slice 0
+
+    /**
+     * @brief Decode brick (bx, by, bz) into compact [z][y][x][channel] samples
+     */
+    void decodeBrick(int bx, int by, int bz, std::vector<unsigned char>& samples) const;
+};
+
+#endif // BRICKED_VOLUME_H
@@ -47,6 +47,15 @@ protected:
      */
     DataContainer(int width, int height, const std::string& name = "");
 
+    /**
+     * @brief Copy and move for derived classes (the virtual destructor would otherwise
+     *        suppress the implicit moves)
+     */
+    DataContainer(const DataContainer&) = default;
+    DataContainer(DataContainer&&) noexcept = default;
+    DataContainer& operator=(const DataContainer&) = default;
+    DataContainer& operator=(DataContainer&&) noexcept = default;
+
 private:
     /**
      * @brief Validate that a dimension is positive
@@ -0,0 +1,451 @@
+/**
+ * @file FourierTransform.cpp
+ * @brief Implementation of the FourierTransform, RealFourierTransform and FourierConvolution classes
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "FourierTransform.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace {
+    using Complex = std::complex<float>;
+
+    // Plain complex product (std::complex's operator* also handles infinities, which is slow)
+    inline Complex multiply(Complex a, Complex b) {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+
+    // e^(sign * 2 * pi * i * j / n) for j < count, computed in double precision
+    std::vector<Complex> makeTwiddles(int n, int count, double sign) {
+        std::vector<Complex> table(count);
+        for (int j = 0; j < count; ++j) {
+            double angle = sign * 2.0 * std::numbers::pi * j / n;
+            table[j] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        }
+        return table;
+    }
+
+    // Smallest even fast size of at least minimum, for the real transforms along X
+    int nextEvenFastSize(int minimum) {
+        int size = FourierTransform::nextFastSize(std::max(minimum, 2));
+        while (size % 2 != 0) {
+            size = FourierTransform::nextFastSize(size + 1);
+        }
+        return size;
+    }
+
+    void butterfly2(Complex* out, int stride, int m, const Complex* table) {
+        for (int k = 0; k < m; ++k) {
+            Complex t = multiply(out[k + m], table[k * stride]);
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+    }
+
+    void butterfly3(Complex* out, int stride, int m, const Complex* table) {
+        const float rotation = table[stride * m].imag();  // Imaginary part of e^(-+2*pi*i/3)
+        for (int k = 0; k < m; ++k) {
+            Complex s1 = multiply(out[k + m], table[k * stride]);
+            Complex s2 = multiply(out[k + 2 * m], table[2 * k * stride]);
+            Complex s3 = s1 + s2;
+            Complex s0 = (s1 - s2) * rotation;
+            Complex middle = out[k] - s3 * 0.5f;
+            out[k] += s3;
+            out[k + 2 * m] = Complex(middle.real() + s0.imag(), middle.imag() - s0.real());
+            out[k + m] = Complex(middle.real() - s0.imag(), middle.imag() + s0.real());
+        }
+    }
+
+    void butterfly4(Complex* out, int stride, int m, const Complex* table, bool inverse) {
+        for (int k = 0; k < m; ++k) {
+            Complex s0 = multiply(out[k + m], table[k * stride]);
+            Complex s1 = multiply(out[k + 2 * m], table[2 * k * stride]);
+            Complex s2 = multiply(out[k + 3 * m], table[3 * k * stride]);
+            Complex s5 = out[k] - s1;
+            Complex s4 = s0 - s2;
+            out[k] += s1;
+            Complex s3 = s0 + s2;
+            out[k + 2 * m] = out[k] - s3;
+            out[k] += s3;
+            if (inverse) {
+                out[k + m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+                out[k + 3 * m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            } else {
+                out[k + m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+                out[k + 3 * m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+            }
+        }
+    }
+
+    // Any radix p, in O(p^2) per group (used for 5 and larger primes)
+    void butterflyGeneric(Complex* out, int stride, int m, int p, int n, const Complex* table) {
+        static thread_local std::vector<Complex> scratch;
+        scratch.resize(p);
+        for (int u = 0; u < m; ++u) {
+            for (int q = 0, k = u; q < p; ++q, k += m) {
+                scratch[q] = out[k];
+            }
+            for (int q1 = 0, k = u; q1 < p; ++q1, k += m) {
+                int index = 0;
+                Complex sum = scratch[0];
+                for (int q = 1; q < p; ++q) {
+                    index += stride * k;
+                    if (index >= n) {
+                        index -= n;
+                    }
+                    sum += multiply(scratch[q], table[index]);
+                }
+                out[k] = sum;
+            }
+        }
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// COMPLEX TRANSFORM
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+FourierTransform::FourierTransform(int size) : size(size) {
+    if (size < 1) {
+        throw std::invalid_argument("Fourier transform size must be at least 1");
+    }
+    // Radix 4 first, then 2, 3, 5 and larger primes
+    int remaining = size;
+    int radix = 4;
+    while (remaining > 1) {
+        while (remaining % radix != 0) {
+            radix = (radix == 4) ? 2 : (radix == 2) ? 3 : radix + 2;
+            if (radix * radix > remaining) {
+                radix = remaining;
+            }
+        }
+        remaining /= radix;
+        factors.push_back(radix);
+        factors.push_back(remaining);
+    }
+    twiddles = makeTwiddles(size, size, -1.0);
+    inverseTwiddles = makeTwiddles(size, size, 1.0);
+}
+
+int FourierTransform::getSize() const {
+    return size;
+}
+
+// One stage: transform the p interleaved sub-sequences, then combine them
+void FourierTransform::work(std::complex<float>* out, const std::complex<float>* in, int stride, int stage,
+                            const std::complex<float>* table, bool inverse) const {
+    int p = factors[2 * stage];
+    int m = factors[2 * stage + 1];
+    if (m == 1) {
+        for (int j = 0; j < p; ++j) {
+            out[j] = in[j * stride];
+        }
+    } else {
+        for (int j = 0; j < p; ++j) {
+            work(out + j * m, in + j * stride, stride * p, stage + 1, table, inverse);
+        }
+    }
+    switch (p) {
+        case 2: butterfly2(out, stride, m, table); break;
+        case 3: butterfly3(out, stride, m, table); break;
+        case 4: butterfly4(out, stride, m, table, inverse); break;
+        default: butterflyGeneric(out, stride, m, p, size, table); break;
+    }
+}
+
+void FourierTransform::forward(std::complex<float>* data) const {
+    if (size == 1) {
+        return;
+    }
+    static thread_local std::vector<Complex> input;
+    input.assign(data, data + size);
+    work(data, input.data(), 1, 0, twiddles.data(), false);
+}
+
+void FourierTransform::inverse(std::complex<float>* data) const {
+    if (size == 1) {
+        return;
+    }
+    static thread_local std::vector<Complex> input;
+    input.assign(data, data + size);
+    work(data, input.data(), 1, 0, inverseTwiddles.data(), true);
+}
+
+int FourierTransform::nextFastSize(int minimum) {
+    for (int size = std::max(minimum, 1);; ++size) {
+        int rest = size;
+        for (int prime : {2, 3, 5}) {
+            while (rest % prime == 0) {
+                rest /= prime;
+            }
+        }
+        if (rest == 1) {
+            return size;
+        }
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// REAL TRANSFORM
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+RealFourierTransform::RealFourierTransform(int size)
+    : size(size), half(std::max(size / 2, 1)), twiddles(makeTwiddles(size, size / 2 + 1, -1.0)) {
+    if (size < 2 || size % 2 != 0) {
+        throw std::invalid_argument("Real Fourier transform size must be even and at least 2");
+    }
+}
+
+int RealFourierTransform::getSize() const {
+    return size;
+}
+
+// X[k] = E[k] + w^k O[k], with E and O the transforms of the even and odd samples
+void RealFourierTransform::forward(const float* input, std::complex<float>* output) const {
+    const int m = size / 2;
+    static thread_local std::vector<Complex> packed;
+    packed.resize(m);
+    for (int k = 0; k < m; ++k) {
+        packed[k] = Complex(input[2 * k], input[2 * k + 1]);
+    }
+    half.forward(packed.data());
+    for (int k = 0; k <= m; ++k) {
+        Complex z = packed[k % m];
+        Complex mirror = std::conj(packed[(m - k) % m]);
+        Complex even = (z + mirror) * 0.5f;
+        Complex difference = z - mirror;
+        Complex odd(difference.imag() * 0.5f, -difference.real() * 0.5f);  // (z - mirror) / 2i
+        output[k] = even + multiply(twiddles[k], odd);
+    }
+}
+
+void RealFourierTransform::inverse(const std::complex<float>* input, float* output) const {
+    const int m = size / 2;
+    static thread_local std::vector<Complex> packed;
+    packed.resize(m);
+    for (int k = 0; k < m; ++k) {
+        Complex mirror = std::conj(input[m - k]);
+        Complex even = input[k] + mirror;
+        Complex odd = multiply(input[k] - mirror, std::conj(twiddles[k]));
+        packed[k] = Complex(even.real() - odd.imag(), even.imag() + odd.real());  // even + i * odd
+    }
+    half.inverse(packed.data());
+    for (int k = 0; k < m; ++k) {
+        output[2 * k] = packed[k].real();
+        output[2 * k + 1] = packed[k].imag();
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// CONVOLUTION
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+FourierConvolution::FourierConvolution(int outputWidth, int outputHeight, int outputDepth,
+                                       const std::vector<float>& kernel, int kernelWidth,
+                                       int kernelHeight, int kernelDepth)
+    : outputWidth(outputWidth), outputHeight(outputHeight), outputDepth(outputDepth),
+      kernelWidth(kernelWidth), kernelHeight(kernelHeight), kernelDepth(kernelDepth),
+      sizeX(nextEvenFastSize(outputWidth + kernelWidth - 1)),
+      sizeY(FourierTransform::nextFastSize(outputHeight + kernelHeight - 1)),
+      sizeZ(FourierTransform::nextFastSize(outputDepth + kernelDepth - 1)),
+      spectrumWidth(sizeX / 2 + 1), transformX(sizeX), transformY(sizeY), transformZ(sizeZ) {
+    if (std::min({outputWidth, outputHeight, outputDepth, kernelWidth, kernelHeight, kernelDepth}) < 1) {
+        throw std::invalid_argument("Convolution sizes must be at least 1");
+    }
+    if (kernel.size() != static_cast<size_t>(kernelWidth) * kernelHeight * kernelDepth) {
+        throw std::invalid_argument("Kernel needs width * height * depth taps");
+    }
+    // Tap (i, j, k) goes to (-i, -j, -k) modulo the transform sizes; the 1/n of the
+    // inverse transform is folded into the kernel
+    const float scale = 1.0f / (static_cast<float>(sizeX) * sizeY * sizeZ);
+    kernelSpectrum.resize(static_cast<size_t>(sizeZ) * sizeY * spectrumWidth);
+    transformGrid([&](int y, int z, float* row) {
+        int j = (sizeY - y) % sizeY;
+        int k = (sizeZ - z) % sizeZ;
+        if (j < kernelHeight && k < kernelDepth) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                row[(sizeX - i) % sizeX] = kernel[(static_cast<size_t>(k) * kernelHeight + j) * kernelWidth + i] * scale;
+            }
+        }
+    }, sizeY, sizeZ, kernelSpectrum);
+}
+
+FourierConvolution::FourierConvolution(int outputWidth, int outputHeight, int outputDepth,
+                                       const std::vector<float>& kernelX, const std::vector<float>& kernelY,
+                                       const std::vector<float>& kernelZ)
+    : outputWidth(outputWidth), outputHeight(outputHeight), outputDepth(outputDepth),
+      kernelWidth(static_cast<int>(kernelX.size())), kernelHeight(static_cast<int>(kernelY.size())),
+      kernelDepth(static_cast<int>(kernelZ.size())),
+      sizeX(nextEvenFastSize(outputWidth + kernelWidth - 1)),
+      sizeY(FourierTransform::nextFastSize(outputHeight + kernelHeight - 1)),
+      sizeZ(FourierTransform::nextFastSize(outputDepth + kernelDepth - 1)),
+      spectrumWidth(sizeX / 2 + 1), transformX(sizeX), transformY(sizeY), transformZ(sizeZ) {
+    if (std::min({outputWidth, outputHeight, outputDepth, kernelWidth, kernelHeight, kernelDepth}) < 1) {
+        throw std::invalid_argument("Convolution sizes must be at least 1");
+    }
+    const float scale = 1.0f / (static_cast<float>(sizeX) * sizeY * sizeZ);
+    std::vector<float> scaledX(kernelX);
+    for (float& tap : scaledX) {
+        tap *= scale;
+    }
+    spectrumX = transformTaps(scaledX, sizeX);
+    spectrumX.resize(spectrumWidth);
+    spectrumY = transformTaps(kernelY, sizeY);
+    spectrumZ = transformTaps(kernelZ, sizeZ);
+}
+
+int FourierConvolution::getGridWidth() const {
+    return outputWidth + kernelWidth - 1;
+}
+
+int FourierConvolution::getOutputWidth() const {
+    return outputWidth;
+}
+
+// Spectrum of 1D taps placed at negative offsets
+std::vector<std::complex<float>> FourierConvolution::transformTaps(const std::vector<float>& taps, int size) const {
+    std::vector<Complex> spectrum(size);
+    for (size_t i = 0; i < taps.size(); ++i) {
+        spectrum[(size - i % size) % size] += taps[i];
+    }
+    FourierTransform(size).forward(spectrum.data());
+    return spectrum;
+}
+
+// Load every grid row, transform it along X, then along Y and Z
+void FourierConvolution::transformGrid(const RowLoader& load, int gridHeight, int gridDepth,
+                                       std::vector<std::complex<float>>& spectrum) const {
+    ThreadPool::shared().parallelFor(0, sizeY * sizeZ, [&](int rowBegin, int rowEnd) {
+        std::vector<float> row(sizeX);
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            int y = r % sizeY;
+            int z = r / sizeY;
+            Complex* destination = &spectrum[static_cast<size_t>(r) * spectrumWidth];
+            if (y >= gridHeight || z >= gridDepth) {
+                std::fill(destination, destination + spectrumWidth, Complex());
+                continue;
+            }
+            std::fill(row.begin(), row.end(), 0.0f);
+            load(y, z, row.data());
+            transformX.forward(row.data(), destination);
+        }
+    });
+    transformColumns(spectrum, false);
+}
+
+// Transforms along Y and Z, a block of neighbouring columns at a time so every cache line
+// fetched is used
+void FourierConvolution::transformColumns(std::vector<std::complex<float>>& spectrum, bool inverse) const {
+    const int block = 8;
+    const int blocks = (spectrumWidth + block - 1) / block;
+    // lineCount planes of spectrumWidth lines; sample i of a line is step values after sample i - 1
+    auto transformLines = [&](const FourierTransform& transform, int lineCount, std::ptrdiff_t planeStride,
+                              std::ptrdiff_t step) {
+        int length = transform.getSize();
+        if (length == 1) {
+            return;
+        }
+        ThreadPool::shared().parallelFor(0, lineCount * blocks, [&](int begin, int end) {
+            std::vector<Complex> lines(static_cast<size_t>(block) * length);
+            for (int item = begin; item < end; ++item) {
+                int plane = item / blocks;
+                int first = (item % blocks) * block;
+                int count = std::min(block, spectrumWidth - first);
+                Complex* base = &spectrum[plane * planeStride + first];
+                for (int i = 0; i < length; ++i) {
+                    for (int b = 0; b < count; ++b) {
+                        lines[b * length + i] = base[i * step + b];
+                    }
+                }
+                for (int b = 0; b < count; ++b) {
+                    inverse ? transform.inverse(&lines[b * length]) : transform.forward(&lines[b * length]);
+                }
+                for (int i = 0; i < length; ++i) {
+                    for (int b = 0; b < count; ++b) {
+                        base[i * step + b] = lines[b * length + i];
+                    }
+                }
+            }
+        });
+    };
+    const std::ptrdiff_t rowStride = spectrumWidth;
+    const std::ptrdiff_t sliceStride = rowStride * sizeY;
+    transformLines(transformY, sizeZ, sliceStride, rowStride);  // Columns of each slice
+    transformLines(transformZ, sizeY, rowStride, sliceStride);  // Pillars through the slices
+}
+
+void FourierConvolution::correlate(const RowLoader& load, const RowStorer& store) const {
+    std::vector<Complex> spectrum(static_cast<size_t>(sizeZ) * sizeY * spectrumWidth);
+    transformGrid(load, outputHeight + kernelHeight - 1, outputDepth + kernelDepth - 1, spectrum);
+
+    ThreadPool& pool = ThreadPool::shared();
+    pool.parallelFor(0, sizeY * sizeZ, [&](int rowBegin, int rowEnd) {
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            Complex* row = &spectrum[static_cast<size_t>(r) * spectrumWidth];
+            if (kernelSpectrum.empty()) {
+                Complex columnFactor = multiply(spectrumY[r % sizeY], spectrumZ[r / sizeY]);
+                for (int x = 0; x < spectrumWidth; ++x) {
+                    row[x] = multiply(row[x], multiply(spectrumX[x], columnFactor));
+                }
+            } else {
+                const Complex* factors = &kernelSpectrum[static_cast<size_t>(r) * spectrumWidth];
+                for (int x = 0; x < spectrumWidth; ++x) {
+                    row[x] = multiply(row[x], factors[x]);
+                }
+            }
+        }
+    });
+    transformColumns(spectrum, true);
+
+    pool.parallelFor(0, outputHeight * outputDepth, [&](int rowBegin, int rowEnd) {
+        std::vector<float> row(sizeX);
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            int y = r % outputHeight;
+            int z = r / outputHeight;
+            transformX.inverse(&spectrum[(static_cast<size_t>(z) * sizeY + y) * spectrumWidth], row.data());
+            store(y, z, row.data());
+        }
+    });
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// COST MODEL
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+double FourierConvolution::estimateCost(int outputWidth, int outputHeight, int outputDepth,
+                                        int kernelWidth, int kernelHeight, int kernelDepth) {
+    double n = static_cast<double>(nextEvenFastSize(outputWidth + kernelWidth - 1)) *
+               FourierTransform::nextFastSize(outputHeight + kernelHeight - 1) *
+               FourierTransform::nextFastSize(outputDepth + kernelDepth - 1);
+    // Forward and inverse real transforms (about 2.5 n log2 n multiply-adds together) and
+    // the product of the half spectra
+    return COST_FACTOR * (2.5 * n * std::log2(n) + 3.0 * n);
+}
+
+bool FourierConvolution::isCheaper(double tapsPerOutput, int outputWidth, int outputHeight, int outputDepth,
+                                   int kernelWidth, int kernelHeight, int kernelDepth) {
+    double direct = tapsPerOutput * outputWidth * outputHeight * outputDepth;
+    return estimateCost(outputWidth, outputHeight, outputDepth, kernelWidth, kernelHeight, kernelDepth) < direct;
+}
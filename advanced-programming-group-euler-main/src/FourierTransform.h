@@ -0,0 +1,219 @@
+/**
+ * @file FourierTransform.h
+ * @brief Declaration of the FourierTransform, RealFourierTransform and FourierConvolution classes
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef FOURIER_TRANSFORM_H
+#define FOURIER_TRANSFORM_H
+
+#include <complex>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Complex discrete Fourier transform of one fixed size
+ *
+ * Mixed-radix Cooley-Tukey: the size is split into factors of 4, 2, 3 and 5 (other
+ * primes use a generic, quadratic butterfly), and the transform recurses over them with
+ * precomputed twiddle factors, in O(n log n) for sizes from nextFastSize(). Twiddles are
+ * computed in double precision and stored as floats. A transform object is immutable,
+ * so several threads can use it at once.
+ */
+class FourierTransform {
+private:
+    int size;                                        ///< Number of points
+    std::vector<int> factors;                        ///< Pairs (radix, remaining size) of each stage
+    std::vector<std::complex<float>> twiddles;       ///< e^(-2*pi*i*j/size)
+    std::vector<std::complex<float>> inverseTwiddles; ///< e^(+2*pi*i*j/size)
+
+    void work(std::complex<float>* out, const std::complex<float>* in, int stride, int stage,
+              const std::complex<float>* table, bool inverse) const;
+
+public:
+    /**
+     * @brief Prepare transforms of a given size
+     *
+     * @param size Number of points (at least 1)
+     * @throws std::invalid_argument If size is less than 1
+     */
+    explicit FourierTransform(int size);
+
+    int getSize() const;
+
+    /**
+     * @brief In-place forward transform, X[k] = sum of x[j] * e^(-2*pi*i*j*k/size)
+     */
+    void forward(std::complex<float>* data) const;
+
+    /**
+     * @brief In-place inverse transform without the 1/size factor
+     */
+    void inverse(std::complex<float>* data) const;
+
+    /**
+     * @brief Smallest size of at least minimum whose only prime factors are 2, 3 and 5
+     */
+    static int nextFastSize(int minimum);
+};
+
+/**
+ * @brief Fourier transform of real data, through a complex transform of half the size
+ *
+ * The even and odd samples are packed into the real and imaginary parts of size / 2
+ * complex points, transformed, and separated again, so a real transform costs about
+ * half a complex one. Only the size / 2 + 1 non-redundant outputs are kept.
+ */
+class RealFourierTransform {
+private:
+    int size;                                  ///< Number of real points (even)
+    FourierTransform half;                     ///< Complex transform of size / 2 points
+    std::vector<std::complex<float>> twiddles; ///< e^(-2*pi*i*k/size) for k <= size / 2
+
+public:
+    /**
+     * @brief Prepare real transforms of a given size
+     *
+     * @param size Number of real points (even, at least 2)
+     * @throws std::invalid_argument If size is odd or less than 2
+     */
+    explicit RealFourierTransform(int size);
+
+    int getSize() const;
+
+    /**
+     * @brief Forward transform of size real samples into size / 2 + 1 outputs
+     */
+    void forward(const float* input, std::complex<float>* output) const;
+
+    /**
+     * @brief Inverse of forward(), without the 1/size factor (input is left unchanged)
+     */
+    void inverse(const std::complex<float>* input, float* output) const;
+};
+
+/**
+ * @brief Correlation of a 2D or 3D grid of samples with a kernel through Fourier transforms
+ *
+ * The caller supplies a grid already padded for its border rule (clamping, zeros, ...):
+ * for an output of W x H x D samples and a kernel of w x h x d taps, the grid is
+ * (W + w - 1) x (H + h - 1) x (D + d - 1) and output (x, y, z) is the sum of
+ * kernel(i, j, k) * grid(x + i, y + j, z + k), the same correlation the direct filters
+ * compute. The grid is zero-extended to fast transform sizes; since the kernel is placed
+ * at negative offsets, the circular correlation equals the linear one on every output.
+ *
+ * Work is spread over the shared ThreadPool: rows are loaded and transformed in bands,
+ * then columns (and pillars along Z) in blocks. The spectrum takes 8 bytes per padded
+ * sample, plus as much again for a non-separable kernel's spectrum; separable kernels
+ * only store their 1D spectra. Results are in float precision, i.e. relative errors of
+ * around 1e-6 of the largest sum.
+ */
+class FourierConvolution {
+public:
+    /**
+     * @brief Fills one row of the padded grid: row (y, z), getGridWidth() samples
+     */
+    using RowLoader = std::function<void(int y, int z, float* row)>;
+
+    /**
+     * @brief Receives one output row: row (y, z), getOutputWidth() sums
+     */
+    using RowStorer = std::function<void(int y, int z, const float* row)>;
+
+    /**
+     * @brief Prepare correlations with a full kernel
+     *
+     * @param outputWidth Output samples along X
+     * @param outputHeight Output samples along Y
+     * @param outputDepth Output samples along Z (1 for images)
+     * @param kernel Taps, X fastest, then Y, then Z
+     * @param kernelWidth Taps along X
+     * @param kernelHeight Taps along Y
+     * @param kernelDepth Taps along Z (1 for images)
+     * @throws std::invalid_argument If a size is less than 1 or the tap count is wrong
+     */
+    FourierConvolution(int outputWidth, int outputHeight, int outputDepth, const std::vector<float>& kernel,
+                       int kernelWidth, int kernelHeight, int kernelDepth);
+
+    /**
+     * @brief Prepare correlations with a separable kernel, tap (i, j, k) = x[i] * y[j] * z[k]
+     *
+     * @param outputWidth Output samples along X
+     * @param outputHeight Output samples along Y
+     * @param outputDepth Output samples along Z (1 for images)
+     * @param kernelX Taps along X
+     * @param kernelY Taps along Y
+     * @param kernelZ Taps along Z ({1} for images)
+     * @throws std::invalid_argument If a size is less than 1 or a kernel is empty
+     */
+    FourierConvolution(int outputWidth, int outputHeight, int outputDepth, const std::vector<float>& kernelX,
+                       const std::vector<float>& kernelY, const std::vector<float>& kernelZ);
+
+    int getGridWidth() const;
+    int getOutputWidth() const;
+
+    /**
+     * @brief Correlate the grid given row by row with the kernel
+     *
+     * The loader and storer are called from several threads at once, each time for a
+     * different row.
+     *
+     * @param load Fills grid row (y, z) for 0 <= y < grid height, 0 <= z < grid depth
+     * @param store Receives output row (y, z) for 0 <= y < outputHeight, 0 <= z < outputDepth
+     */
+    void correlate(const RowLoader& load, const RowStorer& store) const;
+
+    /**
+     * @brief Estimated cost of one correlation, in the units of one direct multiply-add
+     *
+     * About 2.5 * n * log2(n) operations for each of the forward and inverse real
+     * transforms of the n padded samples, plus the spectrum product, weighted by
+     * COST_FACTOR for the transforms' scattered memory accesses. Compare it with
+     * taps * outputs for direct convolution.
+     *
+     * @param outputWidth Output samples along X
+     * @param outputHeight Output samples along Y
+     * @param outputDepth Output samples along Z
+     * @param kernelWidth Taps along X
+     * @param kernelHeight Taps along Y
+     * @param kernelDepth Taps along Z
+     */
+    static double estimateCost(int outputWidth, int outputHeight, int outputDepth,
+                               int kernelWidth, int kernelHeight, int kernelDepth);
+
+    /**
+     * @brief Whether the transforms are estimated to beat tapsPerOutput multiply-adds per output
+     */
+    static bool isCheaper(double tapsPerOutput, int outputWidth, int outputHeight, int outputDepth,
+                          int kernelWidth, int kernelHeight, int kernelDepth);
+
+    static constexpr double COST_FACTOR = 1.0; ///< Weight of a transform operation against a direct tap (optimised build)
+
+private:
+    int outputWidth, outputHeight, outputDepth; ///< Output samples along X, Y, Z
+    int kernelWidth, kernelHeight, kernelDepth; ///< Taps along X, Y, Z
+    int sizeX, sizeY, sizeZ;                    ///< Transform sizes (sizeX even)
+    int spectrumWidth;                          ///< sizeX / 2 + 1 complex values per spectrum row
+    RealFourierTransform transformX;
+    FourierTransform transformY;
+    FourierTransform transformZ;
+
+    std::vector<std::complex<float>> kernelSpectrum;                 ///< Full kernel spectrum, scaled by 1/n
+    std::vector<std::complex<float>> spectrumX, spectrumY, spectrumZ; ///< 1D spectra of a separable kernel
+
+    void transformGrid(const RowLoader& load, int gridHeight, int gridDepth,
+                       std::vector<std::complex<float>>& spectrum) const;
+    void transformColumns(std::vector<std::complex<float>>& spectrum, bool inverse) const;
+    std::vector<std::complex<float>> transformTaps(const std::vector<float>& taps, int size) const;
+};
+
+#endif // FOURIER_TRANSFORM_H
@@ -21,6 +21,9 @@
 
 #include "Image.h"
 #include "filter2D/SimpleFilters.h"
+#include "ThreadPool.h"
+
+#include <cstring>
 
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
@@ -30,28 +33,63 @@
 
 // Constructor with dimensions
 Image::Image(int width, int height, int channels)
-    : DataContainer(width, height), channels(channels) {
-    // Initialize pixels with black color (from pixel)
-    pixels.resize(height, std::vector<Pixel>(width, Pixel()));
+    : DataContainer(width, height), channels(channels), rowStride(0) {
+    // Initialize samples with black color (from pixel)
+    allocate();
+}
+
+// Constructor copying the pixels of a (possibly strided) view
+Image::Image(ConstImageView view, int channels)
+    : DataContainer(view.getWidth(), view.getHeight()),
+      channels(channels == 0 ? view.getChannels() : channels), rowStride(0) {
+    allocate();
+    if (this->channels > view.getChannels()) {
+        throw std::invalid_argument("View has fewer channels than the image");
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * this->channels;
+    for (int y = 0; y < height; ++y) {
+        unsigned char* dst = getRow(y);
+        if (view.hasContiguousRows() && this->channels == view.getChannels()) {
+            std::memcpy(dst, view.getRow(y), rowBytes);
+        } else {
+            for (int x = 0; x < width; ++x) {
+                std::memcpy(dst + x * this->channels, view.at(x, y), this->channels);
+            }
+        }
+    }
 }
 
 // Constructor from file
 Image::Image(const std::string& filename)
-    : DataContainer(1, 1) {  // Initialize with 0 dimensions, will be updated in loadFromFile
+    : DataContainer(1, 1), channels(1), rowStride(0) {  // Placeholder dimensions, will be updated in loadFromFile
     if (!loadFromFile(filename)) {
         throw std::runtime_error("Failed to load image from file: " + filename);
     }
 }
 
-// Create deep copy
+// Create deep copy (a single buffer copy)
 std::unique_ptr<DataContainer> Image::clone() const {
-    auto copy = std::make_unique<Image>(width, height, channels);
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            copy->setPixel(x, y, getPixel(x, y));
+    return std::make_unique<Image>(*this);
+}
+
+// Allocate the aligned sample buffer for the current dimensions
+void Image::allocate() {
+    if (channels < 1 || channels > 4) {
+        throw std::invalid_argument("Channels must be between 1 and 4");
+    }
+    // Round each row up to the next ROW_ALIGNMENT boundary
+    rowStride = ((width * channels + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT) * ROW_ALIGNMENT;
+    samples.assign(static_cast<size_t>(rowStride) * height, 0);
+
+    // Opaque alpha, as for a default Pixel
+    if (channels == 4) {
+        for (int y = 0; y < height; ++y) {
+            unsigned char* row = getRow(y);
+            for (int x = 0; x < width; ++x) {
+                row[x * 4 + 3] = 255;
+            }
         }
     }
-    return copy;
 }
 
 // *******************************************************************************************
@@ -66,8 +104,8 @@ Pixel Image::getPixel(int x, int y) const {
     if (!isInBounds(x, y)) {
         throw std::out_of_range("Pixel coordinates out of bounds");
     }
-    // Returning y-th row and x-th column pixel because Pixels is a 2D vector stored in row-major order.
-    return pixels[y][x];
+    // Samples are stored row-major, `channels` bytes per pixel
+    return Pixel::fromSamples(getRow(y) + x * channels, channels);
 }
 
 // Set pixel at position
@@ -76,8 +114,8 @@ void Image::setPixel(int x, int y, const Pixel& pixel) {
     if (!isInBounds(x, y)) {
         throw std::out_of_range("Pixel coordinates out of bounds");
     }
-    // Returning y-th row and x-th column pixel because Pixels is a 2D vector stored in row-major order.
-    pixels[y][x] = pixel;
+    // Samples are stored row-major, `channels` bytes per pixel
+    pixel.toSamples(getRow(y) + x * channels, channels);
 }
 
 // Get number of channels
@@ -87,31 +125,64 @@ int Image::getChannels() const {
 
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
-// LOADING & SAVING
+// RAW SAMPLE ACCESS
 // -------------------------------------------------------------------------------------------
 // *******************************************************************************************
 
-// Save to file
-bool Image::saveToFile(const std::string& filename) const {
-    // Use std::vector to avoid manual memory management
-    std::vector<unsigned char> data(width * height * channels);
+// Get row stride in bytes
+int Image::getRowStride() const {
+    return rowStride;
+}
 
-    // Copy pixel data to vector
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            Pixel p = pixels[y][x];
-            int index = (y * width + x) * channels;
-
-            // Copy pixel data to vector
-            data[index] = p.getR();
-            if (channels > 1) data[index + 1] = p.getG();
-            if (channels > 2) data[index + 2] = p.getB();
-            if (channels == 4) data[index + 3] = p.getA(); // Only if RGBA
-        }
+// Raw row pointers
+unsigned char* Image::getRow(int y) {
+    return samples.data() + static_cast<size_t>(y) * rowStride;
+}
+const unsigned char* Image::getRow(int y) const {
+    return samples.data() + static_cast<size_t>(y) * rowStride;
+}
+
+// Row spans (padding excluded)
+std::span<unsigned char> Image::getRowSpan(int y) {
+    return std::span<unsigned char>(getRow(y), static_cast<size_t>(width) * channels);
+}
+std::span<const unsigned char> Image::getRowSpan(int y) const {
+    return std::span<const unsigned char>(getRow(y), static_cast<size_t>(width) * channels);
+}
+
+// Views over the whole image
+ImageView Image::getView() {
+    return ImageView(samples.data(), width, height, channels, rowStride);
+}
+ConstImageView Image::getView() const {
+    return ConstImageView(samples.data(), width, height, channels, rowStride);
+}
+
+// Resize in place; the vector keeps its capacity, so shrinking or regrowing never allocates
+void Image::reshape(int width, int height, int channels) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Dimensions must be positive");
+    }
+    if (channels < 1 || channels > 4) {
+        throw std::invalid_argument("Channels must be between 1 and 4");
     }
+    this->width = width;
+    this->height = height;
+    this->channels = channels;
+    rowStride = ((width * channels + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT) * ROW_ALIGNMENT;
+    samples.resize(static_cast<size_t>(rowStride) * height);
+}
 
-    // Write to file
-    int success = stbi_write_png(filename.c_str(), width, height, channels, data.data(), 0);
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// LOADING & SAVING
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Save to file
+bool Image::saveToFile(const std::string& filename) const {
+    // Samples are already interleaved, so they can be written in place using the row stride
+    int success = stbi_write_png(filename.c_str(), width, height, channels, samples.data(), rowStride);
 
     return success != 0;  // Return true if the write was successful
 }
@@ -132,19 +203,13 @@ bool Image::loadFromFile(const std::string& filename) {
     height = h;
     channels = c;
     
-    // Resize pixels array
-    pixels.resize(height, std::vector<Pixel>(width));
+    // Resize sample buffer
+    allocate();
     
-    // Copy data to pixels
+    // Copy data row by row (stb_image rows are tightly packed)
+    const size_t rowBytes = static_cast<size_t>(width) * channels;
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int index = (y * width + x) * channels;
-            unsigned char r = data[index];
-            unsigned char g = (channels > 1) ? data[index + 1] : r;
-            unsigned char b = (channels > 2) ? data[index + 2] : r;
-            unsigned char a = (channels > 3) ? data[index + 3] : 255;
-            pixels[y][x] = Pixel(r, g, b, a);
-        }
+        std::memcpy(getRow(y), data + y * rowBytes, rowBytes);
     }
     
     // Free stb_image data
@@ -188,11 +253,15 @@ std::unique_ptr<DataContainer> Image::applyFilter(const std::string& filterName,
 Image Image::toGreyscale() const {
     // Create new image with same dimensions, but one channel
     Image greyscale_img(width, height, 1);
-    // Convert each pixel to greyscale
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            greyscale_img.setPixel(x, y, getPixel(x, y).toGreyscale());
+    // Convert each pixel to greyscale, walking the rows directly (bands of rows in parallel)
+    ThreadPool::shared().parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            const unsigned char* src = getRow(y);
+            unsigned char* dst = greyscale_img.getRow(y);
+            for (int x = 0; x < width; ++x) {
+                Pixel::fromSamples(src + x * channels, channels).toGreyscale().toSamples(dst + x, 1);
+            }
         }
-    }
+    });
     return greyscale_img;
 }
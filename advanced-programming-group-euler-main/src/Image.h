@@ -18,9 +18,12 @@
 #define IMAGE_H
 
 #include "DataContainer.h"
+#include "AlignedAllocator.h"
+#include "ImageView.h"
 
 #include <vector>
 #include <string>
+#include <span>
 #include <stdexcept>
 #include <iostream>
 
@@ -29,12 +32,33 @@
  * 
  * The Image class extends the DataContainer class to represent a 2D image with pixel data.
  * It provides methods for loading and saving images, as well as applying image processing filters.
- * The pixel data is stored as a 2D array of Pixel objects.
+ * The pixel data is stored as one contiguous, 64-byte aligned buffer of interleaved 8-bit samples
+ * (`channels` bytes per pixel). Each row starts on a ROW_ALIGNMENT boundary, so rows are
+ * getRowStride() bytes apart and may carry a few bytes of padding at the end.
+ *
+ * getPixel() / setPixel() remain the bounds-checked slow path; filters should use getRow(),
+ * getRowSpan() or getView() to walk the samples directly.
  */
 class Image : public DataContainer {
+public:
+    using SampleBuffer = std::vector<unsigned char, AlignedAllocator<unsigned char>>;
+
+    static constexpr int ROW_ALIGNMENT = 64;  ///< Byte alignment of the start of every row
+
 private:
-    std::vector<std::vector<Pixel>> pixels;  ///< 2D array of pixels
-    int channels;  ///< Number of color channels
+    SampleBuffer samples;  ///< Interleaved samples, row-major, rowStride bytes per row
+    int channels;          ///< Number of color channels (1-4)
+    int rowStride;         ///< Bytes between the start of two consecutive rows
+
+    /**
+     * @brief (Re)allocate the sample buffer for the current width, height & channels
+     *
+     * Colour samples are zeroed and, for RGBA images, alpha is set to 255 so a fresh
+     * image matches a default constructed (black, opaque) Pixel.
+     *
+     * @throws std::invalid_argument If channels is not between 1 and 4
+     */
+    void allocate();
 
 public:
     // *******************************************************************************************
@@ -50,10 +74,23 @@ public:
      * @param height Height of the image
      * @param channels Number of color channels (default 3 for RGB)
      * @throws std::invalid_argument If width or height is not positive (inherits from DataContainer)
+     * @throws std::invalid_argument If channels is not between 1 and 4
      * @see DataContainer::validateDimension()
      */
     Image(int width, int height, int channels = 3);
 
+    /**
+     * @brief Construct a new Image object by copying the pixels of a view
+     *
+     * Works for any view (e.g. a plane of a Volume), including views whose pixels are
+     * not contiguous in memory. Only the first `channels` samples of every pixel are kept.
+     *
+     * @param view The pixels to copy
+     * @param channels Number of color channels of the new image (0 keeps the view's count)
+     * @throws std::invalid_argument If the dimensions or channels are invalid
+     */
+    explicit Image(ConstImageView view, int channels = 0);
+
     /**
      * @brief Construct a new Image object by loading from a file
      * 
@@ -71,6 +108,14 @@ public:
      */
     ~Image() override = default;
 
+    /**
+     * @brief Copy an image (one buffer copy) or move it (no copy, the source is left empty)
+     */
+    Image(const Image&) = default;
+    Image(Image&&) noexcept = default;
+    Image& operator=(const Image&) = default;
+    Image& operator=(Image&&) noexcept = default;
+
     /**
      * @brief Create a deep copy of the image
      * 
@@ -119,6 +164,62 @@ public:
      * @see DataContainer::getChannels
      */
     int getChannels() const override;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // RAW SAMPLE ACCESS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Get the number of bytes between the start of two consecutive rows
+     *
+     * @return int Row stride in bytes (>= width * channels, multiple of ROW_ALIGNMENT)
+     */
+    int getRowStride() const;
+
+    /**
+     * @brief Get a raw pointer to the first sample of a row (no bounds checking)
+     *
+     * @param y Row index
+     * @return unsigned char* Pointer to width * channels interleaved samples
+     */
+    unsigned char* getRow(int y);
+    const unsigned char* getRow(int y) const;
+
+    /**
+     * @brief Get the samples of a row as a span (no bounds checking)
+     *
+     * @param y Row index
+     * @return std::span Span of width * channels samples (row padding excluded)
+     */
+    std::span<unsigned char> getRowSpan(int y);
+    std::span<const unsigned char> getRowSpan(int y) const;
+
+    /**
+     * @brief Get a non-owning view over the whole image
+     *
+     * The view stays valid as long as the image is alive and not reloaded.
+     *
+     * @return ImageView / ConstImageView View over the sample buffer
+     * @see BasicImageView
+     */
+    ImageView getView();
+    ConstImageView getView() const;
+
+    /**
+     * @brief Change the dimensions, keeping the sample buffer if it is large enough
+     *
+     * Used to reuse an image as the output of a filter: no memory is allocated unless the
+     * new size exceeds every size the image has had before. The samples are left
+     * unspecified, so the caller must write every pixel.
+     *
+     * @param width New width
+     * @param height New height
+     * @param channels New number of color channels
+     * @throws std::invalid_argument If a dimension is not positive or channels is not between 1 and 4
+     */
+    void reshape(int width, int height, int channels);
    
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
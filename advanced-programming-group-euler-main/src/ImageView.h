@@ -0,0 +1,185 @@
+/**
+ * @file ImageView.h
+ * @brief Declaration of lightweight, non-owning views over interleaved 8-bit sample buffers
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef IMAGE_VIEW_H
+#define IMAGE_VIEW_H
+
+#include "Pixel.h"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+/**
+ * @brief Non-owning 2D view over interleaved 8-bit samples
+ *
+ * A view is just a base pointer plus strides, so it is cheap to copy and pass by value.
+ * Pixels along a row are `pixelStride` bytes apart and rows are `rowStride` bytes apart,
+ * which lets the same type describe an Image as well as any plane cut out of a Volume.
+ * No bounds checking is done: this is the fast path for filters, the checked slow path
+ * stays Image::getPixel / Image::setPixel.
+ *
+ * @tparam T `unsigned char` for a mutable view, `const unsigned char` for a read-only one
+ */
+template <typename T>
+class BasicImageView {
+    static_assert(std::is_same_v<std::remove_const_t<T>, unsigned char>,
+                  "BasicImageView only supports 8-bit samples");
+
+private:
+    T* data;                    ///< Pointer to the first sample of pixel (0, 0)
+    int width;                  ///< Number of pixels per row
+    int height;                 ///< Number of rows
+    int channels;               ///< Samples stored per pixel (1-4)
+    std::ptrdiff_t pixelStride; ///< Bytes between horizontally adjacent pixels
+    std::ptrdiff_t rowStride;   ///< Bytes between vertically adjacent pixels
+
+public:
+    /**
+     * @brief Construct a view over an existing buffer
+     *
+     * @param data Pointer to the first sample of pixel (0, 0)
+     * @param width Number of pixels per row
+     * @param height Number of rows
+     * @param channels Samples stored per pixel (1-4)
+     * @param rowStride Bytes between the start of consecutive rows
+     * @param pixelStride Bytes between consecutive pixels in a row (0 means `channels`)
+     */
+    BasicImageView(T* data, int width, int height, int channels,
+                   std::ptrdiff_t rowStride, std::ptrdiff_t pixelStride = 0)
+        : data(data), width(width), height(height), channels(channels),
+          pixelStride(pixelStride == 0 ? channels : pixelStride), rowStride(rowStride) {}
+
+    /**
+     * @brief Allow a mutable view to be passed where a read-only view is expected
+     */
+    template <typename U, typename = std::enable_if_t<std::is_const_v<T> && !std::is_const_v<U>>>
+    BasicImageView(const BasicImageView<U>& other)
+        : data(other.getData()), width(other.getWidth()), height(other.getHeight()),
+          channels(other.getChannels()), pixelStride(other.getPixelStride()),
+          rowStride(other.getRowStride()) {}
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // GETTERS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    T* getData() const { return data; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChannels() const { return channels; }
+    std::ptrdiff_t getPixelStride() const { return pixelStride; }
+    std::ptrdiff_t getRowStride() const { return rowStride; }
+
+    /**
+     * @brief Check whether the pixels of a row are packed back to back
+     *
+     * @return true If getRowSpan() may be used
+     */
+    bool hasContiguousRows() const { return pixelStride == channels; }
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // SAMPLE ACCESS (UNCHECKED)
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Raw pointer to the first sample of row y
+     */
+    T* getRow(int y) const { return data + y * rowStride; }
+
+    /**
+     * @brief Raw pointer to the first sample of pixel (x, y)
+     */
+    T* at(int x, int y) const { return data + y * rowStride + x * pixelStride; }
+
+    /**
+     * @brief Span over the samples of row y (width * channels bytes)
+     *
+     * Only meaningful when hasContiguousRows() is true.
+     */
+    std::span<T> getRowSpan(int y) const {
+        return std::span<T>(getRow(y), static_cast<std::size_t>(width) * channels);
+    }
+
+    /**
+     * @brief Decode pixel (x, y) without bounds checking
+     */
+    Pixel getPixel(int x, int y) const { return Pixel::fromSamples(at(x, y), channels); }
+
+    /**
+     * @brief Encode pixel (x, y) without bounds checking (mutable views only)
+     */
+    template <typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+    void setPixel(int x, int y, const Pixel& pixel) const { pixel.toSamples(at(x, y), channels); }
+};
+
+using ImageView = BasicImageView<unsigned char>;            ///< Mutable view
+using ConstImageView = BasicImageView<const unsigned char>; ///< Read-only view
+
+/**
+ * @brief Rows [firstRow, firstRow + view height) of an image that is `imageHeight` rows tall
+ *
+ * Filters that work a strip of rows at a time address rows by their position in the whole
+ * image, so the same code runs on a full image (firstRow 0) and on a strip held in a small
+ * buffer. Border handling still sees the full image height through getHeight().
+ *
+ * @tparam T `unsigned char` for a mutable window, `const unsigned char` for a read-only one
+ */
+template <typename T>
+class BasicRowWindow {
+private:
+    BasicImageView<T> view; ///< Rows held by the window
+    int firstRow;           ///< Image row stored in the view's row 0
+    int imageHeight;        ///< Number of rows of the whole image
+
+public:
+    /**
+     * @brief Construct a window over the rows of a view
+     *
+     * @param view Rows held by the window
+     * @param firstRow Image row stored in the view's row 0
+     * @param imageHeight Number of rows of the whole image (-1 means the view's height)
+     */
+    explicit BasicRowWindow(BasicImageView<T> view, int firstRow = 0, int imageHeight = -1)
+        : view(view), firstRow(firstRow),
+          imageHeight(imageHeight < 0 ? view.getHeight() : imageHeight) {}
+
+    /**
+     * @brief Allow a mutable window to be passed where a read-only window is expected
+     */
+    template <typename U, typename = std::enable_if_t<std::is_const_v<T> && !std::is_const_v<U>>>
+    BasicRowWindow(const BasicRowWindow<U>& other)
+        : view(other.getView()), firstRow(other.getFirstRow()), imageHeight(other.getHeight()) {}
+
+    const BasicImageView<T>& getView() const { return view; }
+    int getWidth() const { return view.getWidth(); }
+    int getHeight() const { return imageHeight; }
+    int getChannels() const { return view.getChannels(); }
+    int getFirstRow() const { return firstRow; }
+    int getEndRow() const { return firstRow + view.getHeight(); }
+
+    /**
+     * @brief Raw pointer to the first sample of image row y (getFirstRow() <= y < getEndRow())
+     */
+    T* getRow(int y) const { return view.getRow(y - firstRow); }
+};
+
+using MutableRowWindow = BasicRowWindow<unsigned char>; ///< Mutable window
+using RowWindow = BasicRowWindow<const unsigned char>;  ///< Read-only window
+
+#endif // IMAGE_VIEW_H
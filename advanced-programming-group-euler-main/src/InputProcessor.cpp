@@ -26,7 +26,8 @@
  
 // Constructor
 InputProcessor::InputProcessor(int argc, char* argv[]) 
-    : first_index(-1), last_index(-1), file_extension("png") {
+    : first_index(-1), last_index(-1), file_extension("png"), verify_checksum(false),
+      cache_bytes(Volume::DEFAULT_SLICE_CACHE_BYTES) {
     parseArguments(argc, argv);
     initialiseFunctionMap();
     initialiseVolumeFunctionMap();
@@ -58,6 +59,7 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
     output_file = argv[argc - 1];
 
     // Parse options, handling volume-specific options like --first, --last, --extension
+    // and the --threads option shared by both modes
     for (int i = 3; i < argc - 1; ++i) {
         std::string option = normaliseOption(argv[i], !is_image);  // Pass mode flag - true for volume, false for image
         
@@ -74,6 +76,27 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
             if (i + 1 < argc - 1) {
                 file_extension = argv[++i];
             }
+        } else if (!is_image && option == "--verify") {
+            // Check a raw volume's samples against its stored checksum when opening it
+            verify_checksum = true;
+        } else if (!is_image && option == "--cache-mb") {
+            // Memory budget for the decoded slices of a lazily opened stack
+            if (i + 1 < argc - 1) {
+                int megabytes = std::stoi(argv[++i]);
+                if (megabytes < 0) {
+                    throw std::invalid_argument("--cache-mb requires a non-negative size");
+                }
+                cache_bytes = static_cast<std::size_t>(megabytes) << 20;
+            }
+        } else if (option == "--threads") {
+            // Size of the shared pool the filters run on (both modes)
+            if (i + 1 < argc - 1) {
+                int threads = std::stoi(argv[++i]);
+                if (threads < 1) {
+                    throw std::invalid_argument("--threads requires a thread count of at least 1");
+                }
+                ThreadPool::setSharedThreadCount(threads);
+            }
         } else {
             // Store regular filter/processing options
             options.push_back(option);
@@ -114,7 +137,8 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
          {"-e", "--edge"}, {"--edgedetect", "--edge"},
          {"-p", "--sharpen"}, {"--sharp", "--sharpen"},
          {"-n", "--saltpepper"}, {"--noise", "--saltpepper"},
-         {"-t", "--threshold"}, {"--thresh", "--threshold"}
+         {"-t", "--threshold"}, {"--thresh", "--threshold"},
+         {"-k", "--kernel"}
      };
  
      // 3D volume-specific aliases
@@ -190,7 +214,7 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
      // -----------------------
      // Blurring Filters
      // -----------------------
-     image_function_map["--blur"] = [](const Image& img, const std::vector<std::string>& args) {
+     image_filter_map["--blur"] = [](const std::vector<std::string>& args) -> std::unique_ptr<Filter> {
          if (args.size() < 2) {
              throw std::invalid_argument("Blur filter requires <type> <size> [<stdev>].");
          }
@@ -199,45 +223,78 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
          float stdev = (args.size() > 2) ? std::stof(args[2]) : 2.0f;
  
          if (type == "Gaussian") {
-            return GaussianBlurFilter(size, stdev).apply(img);
+            return std::make_unique<GaussianBlurFilter>(size, stdev);
          } else if (type == "Box") {
-            return BoxBlurFilter(size).apply(img);
+            return std::make_unique<BoxBlurFilter>(size);
          } else if (type == "Median") {
-            return MedianBlurFilter(size).apply(img);
+            return std::make_unique<MedianBlurFilter>(size);
          } else {
              throw std::invalid_argument("Invalid blur type.");
          }
      };
-     image_function_map["-r"] = image_function_map["--blur"];
+     image_filter_map["-r"] = image_filter_map["--blur"];
  
     // -----------------------
     // Sharpening Filter
     // -----------------------
-     image_function_map["--sharpen"] = [](const Image& img, const std::vector<std::string>&) {
-        return SharpeningFilter().apply(img);
+     image_filter_map["--sharpen"] = [](const std::vector<std::string>&) -> std::unique_ptr<Filter> {
+        return std::make_unique<SharpeningFilter>();
     };
-        image_function_map["-p"] = image_function_map["--sharpen"];
+        image_filter_map["-p"] = image_filter_map["--sharpen"];
 
      // -----------------------
      // Edge Detection
      // -----------------------
-     image_function_map["--edge"] = [](const Image& img, const std::vector<std::string>& args) {
+     image_filter_map["--edge"] = [](const std::vector<std::string>& args) -> std::unique_ptr<Filter> {
          if (args.size() < 1) {
              throw std::invalid_argument("Edge detection requires <type>.");
          }
          std::string type = args[0];
  
          if (type == "Sobel") {
-            return SobelFilter().apply(img);
+            return std::make_unique<SobelFilter>();
          } else if (type == "Prewitt") {
-            return PrewittFilter().apply(img);
+            return std::make_unique<PrewittFilter>();
          } else if (type == "RobertsCross") {
-            return RobertsCrossFilter().apply(img);
+            return std::make_unique<RobertsCrossFilter>();
          } else {
              throw std::invalid_argument("Invalid edge detection type.");
          }
      };
-     image_function_map["-e"] = image_function_map["--edge"];
+     image_filter_map["-e"] = image_filter_map["--edge"];
+
+     // -----------------------
+     // User-Supplied Kernel
+     // -----------------------
+     image_filter_map["--kernel"] = [this](const std::vector<std::string>& args) -> std::unique_ptr<Filter> {
+         if (args.size() < 1) {
+             throw std::invalid_argument("Kernel filter requires <file> [<mode>] [<border>].");
+         }
+         std::string mode = (args.size() > 1) ? toLowercase(args[1]) : "clamp";
+         ConvolutionFilter::OutputMode outputMode;
+         if (mode == "clamp") {
+             outputMode = ConvolutionFilter::OutputMode::CLAMP;
+         } else if (mode == "abs") {
+             outputMode = ConvolutionFilter::OutputMode::ABS_NORMALISE;
+         } else if (mode == "signed") {
+             outputMode = ConvolutionFilter::OutputMode::SIGNED_FLOAT;
+         } else {
+             throw std::invalid_argument("Invalid kernel output mode. Use 'clamp', 'abs' or 'signed'.");
+         }
+         // Separable and low-rank kernels run as 1D passes
+         auto filter = std::make_unique<ConvolutionFilter>("Kernel", ConvolutionKernel::fromFile(args[0]), outputMode);
+         filter->setBorderMode(BorderPolicy::fromName(args.size() > 2 ? toLowercase(args[2]) : "clamp"));
+         filter->separateKernel();
+         return filter;
+     };
+     image_filter_map["-k"] = image_filter_map["--kernel"];
+
+     // Filters created above can also be applied on their own
+     for (const auto& [option, createFilter] : image_filter_map) {
+         image_function_map[option] = [createFilter](const Image& img, const std::vector<std::string>& args) {
+             return createFilter(args)->apply(img);
+         };
+     }
  }
  
  // Initialise the volume function map, linking CLI options to volume processing functions
@@ -268,27 +325,7 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
      // Volume Projections
      // -----------------------
      volume_projection_map["--projection"] = [this](const Volume& vol, const std::vector<std::string>& args) {
-         if (args.empty()) {
-             throw std::invalid_argument("Projection requires <type>.");
-         }
-         
-         std::string type = toLowercase(args[0]);
-         
-         if (type == "mip") {
-             MaxIntensityProj mip;
-             return vol.applyProjection(mip);
-         } else if (type == "minip") {
-             MinIntensityProj minip;
-             return vol.applyProjection(minip);
-         } else if (type == "meanaip") {
-             AvgIntensityProj aip(0, -1, false); // Use mean
-             return vol.applyProjection(aip);
-         } else if (type == "medianaip") {
-             AvgIntensityProj aip(0, -1, true); // Use median
-             return vol.applyProjection(aip);
-         } else {
-             throw std::invalid_argument("Invalid projection type. Use 'MIP', 'MinIP', 'meanAIP', or 'medianAIP'.");
-         }
+         return vol.applyProjection(*createProjection(args));
      };
      volume_projection_map["-p"] = volume_projection_map["--projection"];
  
@@ -296,25 +333,7 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
      // Volume Slices
      // -----------------------
      volume_slice_map["--slice"] = [this](const Volume& vol, const std::vector<std::string>& args) {
-         if (args.size() < 2) {
-             throw std::invalid_argument("Slice requires <plane> <constant>.");
-         }
-         
-         std::string plane = toLowercase(args[0]);
-         int constant = std::stoi(args[1]);
-         
-         Slice slice;
-         if (plane == "xy") {
-             slice = Slice(SlicePlane::XY, constant);
-         } else if (plane == "xz") {
-             slice = Slice(SlicePlane::XZ, constant);
-         } else if (plane == "yz") {
-             slice = Slice(SlicePlane::YZ, constant);
-         } else {
-             throw std::invalid_argument("Invalid slice plane. Use 'XY', 'XZ', or 'YZ'.");
-         }
-         
-         return vol.extractSlice(slice);
+         return vol.extractSlice(createSlice(args));
      };
      volume_slice_map["-s"] = volume_slice_map["--slice"];
  }
@@ -349,7 +368,26 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
   // Process the 2D image with the specified filters (includes error handling)
   bool InputProcessor::processImage() {
       try {
-          Image img(input_file);
+          // Each step writes into the chain's spare buffer, so steps do not copy the image
+          FilterChain chain{Image(input_file)};
+          
+          // Consecutive point operations are collected and applied in one fused pass, and
+          // runs of filters that work on strips of rows are applied tile by tile
+          PointOperationChain pointOperations;
+          FilterPipeline pipeline;
+          auto endPointOperations = [&]() {
+              if (!pointOperations.empty()) {
+                  pipeline.addStage(std::make_unique<PointOperationChain>(std::move(pointOperations)));
+                  pointOperations.clear();
+              }
+          };
+          auto flushPipeline = [&]() {
+              endPointOperations();
+              if (!pipeline.empty()) {
+                  chain.apply(pipeline);
+                  pipeline.clear();
+              }
+          };
   
           for (size_t i = 0; i < options.size(); i++) {
               std::string option = normaliseOption(options[i]);
@@ -358,10 +396,39 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
               while (i + 1 < options.size() && options[i + 1][0] != '-') {
                   params.push_back(options[++i]);  // Collect non-flag parameters
               }
+              
+              try {
+                  if (addPointOperation(pointOperations, option, params)) {
+                      continue;
+                  }
+              } catch (const std::exception& e) {
+                  std::cerr << "Error applying filter '" << option << "': " << e.what() << std::endl;
+                  continue;
+              }
+              endPointOperations();
+  
+              auto createFilter = image_filter_map.find(option);
+              if (createFilter != image_filter_map.end()) {
+                  try {
+                      std::unique_ptr<Filter> filter = createFilter->second(params);
+                      if (filter->getRowHalo() >= 0) {
+                          pipeline.addStage(std::move(filter));
+                      } else {
+                          // Needs the whole image (e.g. the recursive Gaussian): ends the pipeline
+                          flushPipeline();
+                          chain.apply(*filter);
+                      }
+                  } catch (const std::exception& e) {
+                      std::cerr << "Error applying filter '" << option << "': " << e.what() << std::endl;
+                  }
+                  continue;
+              }
+              flushPipeline();
   
               if (image_function_map.find(option) != image_function_map.end()) {
                   try {
-                      img = image_function_map[option](img, params);
+                      auto& function = image_function_map[option];
+                      chain.apply([&](const Image& img) { return function(img, params); });
                   } catch (const std::exception& e) {
                       std::cerr << "Error applying filter '" << option << "': " << e.what() << std::endl;
                   }
@@ -369,8 +436,9 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
                   std::cerr << "Unknown image filter: " << option << std::endl;
               }
           }
+          flushPipeline();
   
-          if (!img.saveToFile(output_file)) {
+          if (!chain.getImage().saveToFile(output_file)) {
               throw std::runtime_error("Failed to save output image: " + output_file);
           }
   
@@ -380,9 +448,42 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
           return false;
       }
   }
+  
+  // Append a greyscale, brightness or threshold option to the fused chain (same defaults
+  // as the image function map); brightness 0 needs the whole image and is not fused
+  bool InputProcessor::addPointOperation(PointOperationChain& chain, const std::string& option,
+                                         const std::vector<std::string>& params) {
+      if (option == "--greyscale") {
+          chain.addGreyscale();
+      } else if (option == "--brightness") {
+          int brightness = (!params.empty()) ? std::stoi(params[0]) : 50;
+          if (brightness == 0) {
+              return false;
+          }
+          chain.addBrightness(brightness);
+      } else if (option == "--threshold") {
+          chain.addThreshold((!params.empty()) ? std::stoi(params[0]) : 128);
+      } else {
+          return false;
+      }
+      return true;
+  }
+  
   // Process the 3D volume with the specified operations (includes error handling)
   bool InputProcessor::processVolume() {
       try {
+          // A projection on its own needs only one running value per pixel, so it is
+          // streamed from the slice files instead of loading the whole volume
+          std::vector<std::string> params;
+          if (isBrickedVolumeInput()) {
+              // Bricked files decode only the bricks a lone slice or projection touches
+              if (isLoneOperation(volume_slice_map, params) || isLoneOperation(volume_projection_map, params)) {
+                  return processBrickedVolume(params);
+              }
+          } else if (!isRawVolumeInput() && isLoneOperation(volume_projection_map, params)) {
+              return processStreamingProjection(params);
+          }
+          
           // Load the volume
           auto vol = loadVolume();
           std::cout << "Volume loaded successfully. Dimensions: " 
@@ -392,6 +493,7 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
           
           // Track whether we need to output a slice or projection
           bool hasSliceOrProjection = false;
+          std::string exportFormat;  // "raw" or "bricked" to save the volume instead of an image
           std::unique_ptr<Image> outputImage = nullptr;
           
           // Process options in the order they were provided
@@ -404,8 +506,9 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
                   params.push_back(options[i++]);
               }
               
-              // Apply volume filters
+              // Apply volume filters; they read every voxel, so a lazy volume is loaded in full first
               if (volume_filter_map.find(option) != volume_filter_map.end()) {
+                  vol->loadAllSlices();
                   std::cout << "Applying filter: " << option;
                   for (const auto& param : params) {
                       std::cout << " " << param;
@@ -441,6 +544,13 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
                   hasSliceOrProjection = true;
                   std::cout << "Slice extracted successfully." << std::endl;
               } 
+              // Save the (filtered) volume itself in the raw or bricked format
+              else if (option == "--export-raw") {
+                  exportFormat = "raw";
+              }
+              else if (option == "--export-bricked") {
+                  exportFormat = "bricked";
+              }
               else if (option == "--help" || option == "-h") {
                   showVolumeHelp();
                   return true;
@@ -450,6 +560,17 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
               }
           }
           
+          if (!exportFormat.empty()) {
+              std::cout << "Exporting " << exportFormat << " volume to " << output_file << "..." << std::endl;
+              vol->loadAllSlices();
+              bool saved = (exportFormat == "raw") ? vol->saveToRaw(output_file) : vol->saveToBricked(output_file);
+              if (!saved) {
+                  throw std::runtime_error("Failed to save " + exportFormat + " volume: " + output_file);
+              }
+              std::cout << "Volume saved successfully." << std::endl;
+              return true;
+          }
+          
           // If no slice or projection was applied, use middle slice as default
           if (!hasSliceOrProjection) {
               std::cout << "No slice or projection specified. Using middle XY slice as default." << std::endl;
@@ -472,6 +593,48 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
       }
   }
   
+  // Check whether the options are exactly one operation from `operations` (and collect its parameters)
+  bool InputProcessor::isLoneOperation(const VolumeImageMap& operations, std::vector<std::string>& params) {
+      if (options.empty()) {
+          return false;
+      }
+      std::string option = normaliseOption(options[0], true);
+      if (operations.find(option) == operations.end()) {
+          return false;
+      }
+      for (size_t i = 1; i < options.size(); ++i) {
+          if (options[i][0] == '-') {
+              return false;
+          }
+      }
+      params.assign(options.begin() + 1, options.end());
+      return true;
+  }
+  
+  // Project the slice files one batch at a time without materialising the volume
+  bool InputProcessor::processStreamingProjection(const std::vector<std::string>& params) {
+      std::vector<std::string> files = findVolumeFiles();
+      
+      std::cout << "Creating projection: " << normaliseOption(options[0], true);
+      for (const auto& param : params) {
+          std::cout << " " << param;
+      }
+      std::cout << " (streaming " << files.size() << " slices)" << std::endl;
+      
+      Image result = createProjection(params)->applyToFiles(files);
+      std::cout << "Projection created successfully. Dimensions: "
+                << result.getWidth() << "x" << result.getHeight() << std::endl;
+      
+      // Save the output image
+      std::cout << "Saving output to " << output_file << "..." << std::endl;
+      if (!result.saveToFile(output_file)) {
+          throw std::runtime_error("Failed to save output image: " + output_file);
+      }
+      std::cout << "Output saved successfully." << std::endl;
+      
+      return true;
+  }
+  
   // *******************************************************************************************
   // -------------------------------------------------------------------------------------------
   // VOLUME LOADING & HELPER METHODS
@@ -562,7 +725,8 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
       return filenames;
   }
   
-  std::unique_ptr<Volume> InputProcessor::loadVolume() {
+  // Resolve the input path and index range to the list of slice files, in Z order
+  std::vector<std::string> InputProcessor::findVolumeFiles() {
       try {
           std::cout << "Loading volume from " << input_file << "..." << std::endl;
           
@@ -578,32 +742,18 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
               std::cout << "Found " << allFiles.size() << " image files in directory." << std::endl;
               
               // If first_index and last_index are specified, select the subset
-              if (first_index >= 0 && last_index >= 0) {
-                  // Convert to zero-based indices for vector access
-                  int zeroBasedFirst = first_index - 1;
-                  int zeroBasedLast = last_index - 1;
-                  
-                  // Validate indices
-                  if (zeroBasedFirst < 0 || zeroBasedLast >= static_cast<int>(allFiles.size()) || zeroBasedFirst > zeroBasedLast) {
-                      std::cerr << "Warning: Specified index range (" << first_index << " to " << last_index 
-                                << ") is out of bounds for found files (1 to " << allFiles.size() << ")." << std::endl;
-                      std::cerr << "Using available range instead." << std::endl;
-                      
-                      // Adjust to available range
-                      zeroBasedFirst = std::max(0, std::min(zeroBasedFirst, static_cast<int>(allFiles.size()) - 1));
-                      zeroBasedLast = std::max(zeroBasedFirst, std::min(zeroBasedLast, static_cast<int>(allFiles.size()) - 1));
-                  }
-                  
+              int zeroBasedFirst, zeroBasedLast;
+              if (getIndexRange(static_cast<int>(allFiles.size()), zeroBasedFirst, zeroBasedLast)) {
                   // Extract the subset of files
                   std::vector<std::string> selectedFiles(allFiles.begin() + zeroBasedFirst, allFiles.begin() + zeroBasedLast + 1);
                   
                   std::cout << "Selected " << selectedFiles.size() << " files from index " 
                             << (zeroBasedFirst + 1) << " to " << (zeroBasedLast + 1) << "." << std::endl;
                   
-                  return std::make_unique<Volume>(selectedFiles);
+                  return selectedFiles;
               } else {
                   // Use all files
-                  return std::make_unique<Volume>(allFiles);
+                  return allFiles;
               }
           } else {
               // Input path is not a directory
@@ -620,32 +770,18 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
               }
               
               // If first_index and last_index are specified, select the subset
-              if (first_index >= 0 && last_index >= 0) {
-                  // Convert to zero-based indices for vector access
-                  int zeroBasedFirst = first_index - 1;
-                  int zeroBasedLast = last_index - 1;
-                  
-                  // Validate indices
-                  if (zeroBasedFirst < 0 || zeroBasedLast >= static_cast<int>(allFiles.size()) || zeroBasedFirst > zeroBasedLast) {
-                      std::cerr << "Warning: Specified index range (" << first_index << " to " << last_index 
-                                << ") is out of bounds for found files (1 to " << allFiles.size() << ")." << std::endl;
-                      std::cerr << "Using available range instead." << std::endl;
-                      
-                      // Adjust to available range
-                      zeroBasedFirst = std::max(0, std::min(zeroBasedFirst, static_cast<int>(allFiles.size()) - 1));
-                      zeroBasedLast = std::max(zeroBasedFirst, std::min(zeroBasedLast, static_cast<int>(allFiles.size()) - 1));
-                  }
-                  
+              int zeroBasedFirst, zeroBasedLast;
+              if (getIndexRange(static_cast<int>(allFiles.size()), zeroBasedFirst, zeroBasedLast)) {
                   // Extract the subset of files
                   std::vector<std::string> selectedFiles(allFiles.begin() + zeroBasedFirst, allFiles.begin() + zeroBasedLast + 1);
                   
                   std::cout << "Selected " << selectedFiles.size() << " files from index " 
                             << (zeroBasedFirst + 1) << " to " << (zeroBasedLast + 1) << "." << std::endl;
                   
-                  return std::make_unique<Volume>(selectedFiles);
+                  return selectedFiles;
               } else {
                   // Use all files
-                  return std::make_unique<Volume>(allFiles);
+                  return allFiles;
               }
           }
       } catch (const std::exception& e) {
@@ -654,6 +790,150 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
       }
   }
   
+  // Clamp -f/-l to `count` slices, as 0-based indices; false if no range was given
+  bool InputProcessor::getIndexRange(int count, int& zeroBasedFirst, int& zeroBasedLast) const {
+      if (first_index < 0 || last_index < 0) {
+          return false;
+      }
+      
+      // Convert to zero-based indices
+      zeroBasedFirst = first_index - 1;
+      zeroBasedLast = last_index - 1;
+      
+      // Validate indices
+      if (zeroBasedFirst < 0 || zeroBasedLast >= count || zeroBasedFirst > zeroBasedLast) {
+          std::cerr << "Warning: Specified index range (" << first_index << " to " << last_index 
+                    << ") is out of bounds for found slices (1 to " << count << ")." << std::endl;
+          std::cerr << "Using available range instead." << std::endl;
+          
+          // Adjust to available range
+          zeroBasedFirst = std::max(0, std::min(zeroBasedFirst, count - 1));
+          zeroBasedLast = std::max(zeroBasedFirst, std::min(zeroBasedLast, count - 1));
+      }
+      return true;
+  }
+  
+  // Project or slice a bricked file, decoding only the bricks involved
+  bool InputProcessor::processBrickedVolume(const std::vector<std::string>& params) {
+      std::string option = normaliseOption(options[0], true);
+      std::cout << "Opening bricked volume " << input_file << "..." << std::endl;
+      BrickedVolume bricks = openBrickedVolume();
+      
+      Image result = (volume_slice_map.find(option) != volume_slice_map.end())
+                   ? bricks.extractSlice(createSlice(params))
+                   : bricks.applyProjection(*createProjection(params));
+      std::cout << "Created " << option << " from the bricked volume." << std::endl;
+      
+      // Save the output image
+      std::cout << "Saving output to " << output_file << "..." << std::endl;
+      if (!result.saveToFile(output_file)) {
+          throw std::runtime_error("Failed to save output image: " + output_file);
+      }
+      std::cout << "Output saved successfully." << std::endl;
+      
+      return true;
+  }
+  
+  // Open the bricked input, restricted to the -f/-l slab so only its bricks are decoded
+  BrickedVolume InputProcessor::openBrickedVolume() {
+      BrickedVolume bricks(input_file);
+      int zeroBasedFirst, zeroBasedLast;
+      if (getIndexRange(std::get<2>(bricks.getDimensions3D()), zeroBasedFirst, zeroBasedLast)) {
+          bricks.cropDepth(zeroBasedFirst, zeroBasedLast);
+          std::cout << "Selected slices " << (zeroBasedFirst + 1) << " to " << (zeroBasedLast + 1) << "." << std::endl;
+      }
+      return bricks;
+  }
+  
+  // Check whether the input is a bricked volume file rather than a slice stack
+  bool InputProcessor::isBrickedVolumeInput() {
+      return fs::is_regular_file(input_file) && toLowercase(fs::path(input_file).extension().string()) == ".apb";
+  }
+  
+  // Check whether the input is a raw volume file rather than a slice stack
+  bool InputProcessor::isRawVolumeInput() {
+      return fs::is_regular_file(input_file) && toLowercase(fs::path(input_file).extension().string()) == ".apv";
+  }
+  
+  std::unique_ptr<Volume> InputProcessor::loadVolume() {
+      if (isBrickedVolumeInput()) {
+          std::cout << "Decompressing bricked volume " << input_file << "..." << std::endl;
+          BrickedVolume bricks = openBrickedVolume();
+          auto vol = bricks.load();
+          vol->setName(fs::path(input_file).stem().string());
+          return vol;
+      }
+      if (isRawVolumeInput()) {
+          // Raw volumes are memory-mapped, so nothing is decoded up front
+          std::cout << "Opening raw volume " << input_file << "..." << std::endl;
+          auto vol = std::make_unique<Volume>(1, 1, 1, 1, fs::path(input_file).stem().string());
+          if (!vol->loadFromRaw(input_file, verify_checksum)) {
+              throw std::runtime_error("Failed to open raw volume: " + input_file);
+          }
+          // -f/-l select a slab as they do for a stack; the mapping just starts later
+          int zeroBasedFirst, zeroBasedLast;
+          if (getIndexRange(vol->getDepth(), zeroBasedFirst, zeroBasedLast)) {
+              vol->cropDepth(zeroBasedFirst, zeroBasedLast);
+              std::cout << "Selected slices " << (zeroBasedFirst + 1) << " to " << (zeroBasedLast + 1) << "." << std::endl;
+          }
+          return vol;
+      }
+      
+      // Slice stacks are opened lazily: only the slices an operation touches are decoded
+      std::vector<std::string> files = findVolumeFiles();
+      try {
+          auto vol = std::make_unique<Volume>(1, 1, 1, 1);
+          if (!vol->loadFromFilesLazy(files, cache_bytes)) {
+              throw std::runtime_error("Failed to load volume from files: " + files[0] + " (and others)");
+          }
+          return vol;
+      } catch (const std::exception& e) {
+          std::cerr << "Error loading volume: " << e.what() << std::endl;
+          throw;
+      }
+  }
+  
+  // Build the slice named by the --slice arguments
+  Slice InputProcessor::createSlice(const std::vector<std::string>& args) {
+      if (args.size() < 2) {
+          throw std::invalid_argument("Slice requires <plane> <constant>.");
+      }
+      
+      std::string plane = toLowercase(args[0]);
+      int constant = std::stoi(args[1]);
+      
+      if (plane == "xy") {
+          return Slice(SlicePlane::XY, constant);
+      } else if (plane == "xz") {
+          return Slice(SlicePlane::XZ, constant);
+      } else if (plane == "yz") {
+          return Slice(SlicePlane::YZ, constant);
+      } else {
+          throw std::invalid_argument("Invalid slice plane. Use 'XY', 'XZ', or 'YZ'.");
+      }
+  }
+  
+  // Build the projection named by the --projection arguments
+  std::unique_ptr<Projection> InputProcessor::createProjection(const std::vector<std::string>& args) {
+      if (args.empty()) {
+          throw std::invalid_argument("Projection requires <type>.");
+      }
+      
+      std::string type = toLowercase(args[0]);
+      
+      if (type == "mip") {
+          return std::make_unique<MaxIntensityProj>();
+      } else if (type == "minip") {
+          return std::make_unique<MinIntensityProj>();
+      } else if (type == "meanaip") {
+          return std::make_unique<AvgIntensityProj>(0, -1, false); // Use mean
+      } else if (type == "medianaip") {
+          return std::make_unique<AvgIntensityProj>(0, -1, true); // Use median
+      } else {
+          throw std::invalid_argument("Invalid projection type. Use 'MIP', 'MinIP', 'meanAIP', or 'medianAIP'.");
+      }
+  }
+  
   void InputProcessor::showVolumeHelp() {
       std::cout << "Volume Processing Tool - Usage:" << std::endl;
       std::cout << "  ./APImageFilters -d <input_path> [options] <output_image>" << std::endl;
@@ -663,6 +943,12 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
       std::cout << "    --first <index>, -f <index>          First slice index to load (optional)" << std::endl;
       std::cout << "    --last <index>, -l <index>           Last slice index to load (optional)" << std::endl;
       std::cout << "    --extension <ext>, -x <ext>          File extension (default: png)" << std::endl;
+      std::cout << "    --threads <n>                        Number of threads to use (default: all cores)" << std::endl;
+      std::cout << "    --verify                             Check a raw (.apv) input against its checksum" << std::endl;
+      std::cout << "    --cache-mb <n>                       Memory for decoded slices of an image stack" << std::endl;
+      std::cout << "                                         (default: 512)" << std::endl;
+      std::cout << "                                         <input_path> may also be a raw (.apv) or bricked (.apb)" << std::endl;
+      std::cout << "                                         volume file" << std::endl;
       std::cout << std::endl;
       std::cout << "  Volume Filters:" << std::endl;
       std::cout << "    --blur <type> <size> [<stdev>], -r <type> <size> [<stdev>]" << std::endl;
@@ -676,9 +962,16 @@ void InputProcessor::parseArguments(int argc, char* argv[]) {
       std::cout << "                                         Planes: XY, XZ, YZ" << std::endl;
       std::cout << "    --projection <type>, -p <type>       Create a projection from the volume" << std::endl;
       std::cout << "                                         Types: MIP, MinIP, meanAIP, medianAIP" << std::endl;
+      std::cout << "    --export-raw                         Save the volume as a raw volume file (.apv)" << std::endl;
+      std::cout << "                                         instead of an image" << std::endl;
+      std::cout << "    --export-bricked                     Save the volume as a compressed, bricked volume" << std::endl;
+      std::cout << "                                         file (.apb) instead of an image" << std::endl;
       std::cout << std::endl;
       std::cout << "Examples:" << std::endl;
       std::cout << "  ./APImageFilters -d ./Scans/TestVolume -f 1 -l 50 --blur Gaussian 3 2.0 -p MIP output.png" << std::endl;
       std::cout << "  ./APImageFilters -d ./Scans/TestVolume -s XZ 16 output.png" << std::endl;
       std::cout << "  ./APImageFilters -d ./Scans/TestVolume -r Median 3 -p MinIP output.png" << std::endl;
+      std::cout << "  ./APImageFilters -d ./Scans/TestVolume --export-raw volume.apv" << std::endl;
+      std::cout << "  ./APImageFilters -d volume.apv -p MIP output.png" << std::endl;
+      std::cout << "  ./APImageFilters -d volume.apb -s YZ 16 output.png" << std::endl;
   }
\ No newline at end of file
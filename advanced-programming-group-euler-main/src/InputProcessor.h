@@ -20,6 +20,7 @@
 #include "filter2D/SimpleFilters.h"
 #include "Volume.h"
 #include "Slice.h"
+#include "ThreadPool.h"
 
 #include "filter2D/BoxBlurFilter.h"
 #include "filter2D/ConvolutionFilter.h"
@@ -30,12 +31,16 @@
 #include "filter2D/SharpeningFilter.h"
 #include "filter2D/SimpleFilters.h"
 #include "filter2D/SobelFilter.h"
+#include "filter2D/PointOperationChain.h"
+#include "filter2D/FilterPipeline.h"
+#include "filter2D/FilterChain.h"
 
  #include "./projectionFunc/MaxIntensityProj.h"
  #include "./projectionFunc/MinIntensityProj.h"
  #include "./projectionFunc/AvgIntensityProj.h"
  #include "./filter3D/Gaussian3DFilter.h"
  #include "./filter3D/Median3DFilter.h"
+ #include "BrickedVolume.h"
  
  #include <iostream>
  #include <stdexcept>
@@ -75,16 +80,21 @@ private:
     int first_index;             ///< First slice index to load (optional)
     int last_index;              ///< Last slice index to load (optional)
     std::string file_extension;  ///< File extension for volume slices (default: png)
+    bool verify_checksum;        ///< Verify a raw volume input against its checksum (--verify)
+    std::size_t cache_bytes;     ///< Slice cache budget of a lazily opened slice stack (--cache-mb)
         
     std::vector<std::string> options;  ///< List of command-line options
     
     // Function maps for 2D image processing
     std::unordered_map<std::string, std::function<Image(const Image&, const std::vector<std::string>&)>> image_function_map;
+    /// Options that create a Filter object (blur, sharpen, edge), so they can become pipeline stages
+    std::unordered_map<std::string, std::function<std::unique_ptr<Filter>(const std::vector<std::string>&)>> image_filter_map;
     
     // Function maps for 3D volume processing
     std::unordered_map<std::string, std::function<std::unique_ptr<Volume>(const Volume&, const std::vector<std::string>&)>> volume_filter_map;
-    std::unordered_map<std::string, std::function<Image(const Volume&, const std::vector<std::string>&)>> volume_projection_map;
-    std::unordered_map<std::string, std::function<Image(const Volume&, const std::vector<std::string>&)>> volume_slice_map;
+    using VolumeImageMap = std::unordered_map<std::string, std::function<Image(const Volume&, const std::vector<std::string>&)>>;
+    VolumeImageMap volume_projection_map;
+    VolumeImageMap volume_slice_map;
 
 public:
     // *******************************************************************************************
@@ -182,6 +192,21 @@ public:
      */
     bool processImage();
 
+    /**
+     * @brief Append an option to a chain of fused point operations if it is one.
+     * 
+     * Greyscale, threshold and non-zero brightness options are point operations; a run of
+     * them is applied to the image in a single pass.
+     * 
+     * @param chain Chain to append to.
+     * @param option Normalised option (e.g. `--brightness`).
+     * @param params Parameters of the option.
+     * @return bool True if the option was appended, false if it is not a point operation.
+     * @throws std::invalid_argument If a parameter is not a number.
+     */
+    bool addPointOperation(PointOperationChain& chain, const std::string& option,
+                           const std::vector<std::string>& params);
+
     /**
      * @brief Process the 3D volume with the specified operations.
      * 
@@ -189,6 +214,46 @@ public:
      */
     bool processVolume();
 
+    /**
+     * @brief Check whether the volume options consist of a single operation and nothing else.
+     * 
+     * @param operations Map the operation must come from (e.g. the projections).
+     * @param params Set to the operation's parameters when the check succeeds.
+     * @return bool True if the only option is one of `operations`.
+     */
+    bool isLoneOperation(const VolumeImageMap& operations, std::vector<std::string>& params);
+
+    /**
+     * @brief Create the projection from the slice files without loading the whole volume.
+     * 
+     * Slices are decoded a batch at a time and folded into the projection, so memory use
+     * depends on the slice size rather than the number of slices.
+     * 
+     * @param params Parameters of the projection option (e.g. "MIP").
+     * @return bool True if processing was successful.
+     * @throws std::exception If the slices cannot be read or the output cannot be saved.
+     */
+    bool processStreamingProjection(const std::vector<std::string>& params);
+
+    /**
+     * @brief Extract a slice or create a projection straight from a bricked volume file.
+     * 
+     * Only the bricks the slice or slab passes through are decompressed.
+     * 
+     * @param params Parameters of the slice or projection option.
+     * @return bool True if processing was successful.
+     * @throws std::exception If the file is invalid or the output cannot be saved.
+     */
+    bool processBrickedVolume(const std::vector<std::string>& params);
+
+    /**
+     * @brief Opens the bricked volume input, cropped to the -f/-l slab if one was given.
+     * 
+     * @return BrickedVolume The opened file; nothing is decompressed yet.
+     * @throws std::runtime_error If the file is not a valid bricked volume.
+     */
+    BrickedVolume openBrickedVolume();
+
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
     // VOLUME LOADING & HELPER METHODS
@@ -202,6 +267,58 @@ public:
      * @throws std::runtime_error If the directory or files cannot be loaded.
      */
     std::unique_ptr<Volume> loadVolume();
+
+    /**
+     * @brief Finds the slice files selected by the input path and index range.
+     * 
+     * @return std::vector<std::string> Slice filenames in natural sort (Z) order.
+     * @throws std::runtime_error If no matching files are found.
+     */
+    std::vector<std::string> findVolumeFiles();
+
+    /**
+     * @brief Clamps the -f/-l index range to the available slices.
+     * 
+     * Prints a warning and uses the nearest valid range if the indices are out of bounds.
+     * 
+     * @param count Number of slices available.
+     * @param zeroBasedFirst Receives the first selected slice (0-based).
+     * @param zeroBasedLast Receives the last selected slice (0-based).
+     * @return bool True if both -f and -l were given, false if the whole volume is used.
+     */
+    bool getIndexRange(int count, int& zeroBasedFirst, int& zeroBasedLast) const;
+
+    /**
+     * @brief Checks whether the volume input is a raw volume file (.apv) rather than a slice stack.
+     * 
+     * @return bool True if the input path is an existing .apv file.
+     */
+    bool isRawVolumeInput();
+
+    /**
+     * @brief Checks whether the volume input is a bricked volume file (.apb).
+     * 
+     * @return bool True if the input path is an existing .apb file.
+     */
+    bool isBrickedVolumeInput();
+
+    /**
+     * @brief Creates the projection named by the projection option's parameters.
+     * 
+     * @param args Projection parameters; the first is the type (MIP, MinIP, meanAIP, medianAIP).
+     * @return std::unique_ptr<Projection> The projection to apply.
+     * @throws std::invalid_argument If the type is missing or unknown.
+     */
+    std::unique_ptr<Projection> createProjection(const std::vector<std::string>& args);
+
+    /**
+     * @brief Creates the slice named by the slice option's parameters.
+     * 
+     * @param args Slice parameters: the plane (XY, XZ, YZ) and the 1-based position.
+     * @return Slice The slice to extract.
+     * @throws std::invalid_argument If the parameters are missing or the plane is unknown.
+     */
+    Slice createSlice(const std::vector<std::string>& args);
     
     /**
      * @brief Compares strings for natural sort order (e.g., "10" comes after "2").
@@ -0,0 +1,65 @@
+/**
+ * @file MappedFile.h
+ * @brief Declaration of the MappedFile class, a private memory mapping of a whole file
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Copy-on-write memory mapping of a whole file
+ *
+ * Opening only maps the file: pages are read from disk the first time they are touched,
+ * so opening a multi-gigabyte file costs the same as opening a small one. The mapping is
+ * private, so writes through data() stay in this process and never reach the file.
+ * On platforms without mmap the file is read into memory instead.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Map the file at `path`
+     *
+     * @param path File to map
+     * @throws std::runtime_error If the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief First byte of the file (nullptr for an empty file)
+     */
+    unsigned char* data() const { return bytes; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    std::size_t size() const { return length; }
+
+private:
+    unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<unsigned char> fallback; ///< File contents where mmap is unavailable
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,106 @@
+/**
+ * @file MedianHistogram.h
+ * @brief Declaration of the MedianHistogram class, the sliding window of the median filters
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef MEDIAN_HISTOGRAM_H
+#define MEDIAN_HISTOGRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+/**
+ * @brief 256-bin histogram of a median filter's window plus an incrementally maintained median
+ *
+ * `median` and `below` (number of samples < median) are kept consistent with the histogram
+ * on every update, so locating the median after the window slides only walks the few bins
+ * it actually moved by. Samples enter and leave one at a time (Huang), or a whole column
+ * histogram at a time (Perreault & Hebert), which also takes the column's coarse bins of
+ * 16 values each to count the samples below the median quickly.
+ *
+ * MedianBlurFilter and Median3DFilter both slide one of these per channel. The methods
+ * are defined here so that the per-sample updates inline into the filters' loops.
+ */
+class MedianHistogram {
+public:
+    static constexpr int BINS = 256;        ///< One bin per 8-bit value
+    static constexpr int COARSE_SHIFT = 4;  ///< Coarse bins group 16 fine bins
+    static constexpr int COARSE_BINS = BINS >> COARSE_SHIFT;
+
+    /**
+     * @brief Empty the window
+     */
+    void clear() {
+        std::fill(std::begin(fine), std::end(fine), 0u);
+        median = 0;
+        below = 0;
+    }
+
+    void addSample(unsigned char v) {
+        fine[v]++;
+        if (v < median) below++;
+    }
+
+    void removeSample(unsigned char v) {
+        fine[v]--;
+        if (v < median) below--;
+    }
+
+    /**
+     * @brief Add a column histogram (BINS fine and COARSE_BINS coarse counts)
+     */
+    void addColumn(const std::uint16_t* colFine, const std::uint16_t* colCoarse) {
+        for (int v = 0; v < BINS; v++) fine[v] += colFine[v];
+        below += countBelow(colFine, colCoarse);
+    }
+
+    /**
+     * @brief Remove a column histogram added before
+     */
+    void removeColumn(const std::uint16_t* colFine, const std::uint16_t* colCoarse) {
+        for (int v = 0; v < BINS; v++) fine[v] -= colFine[v];
+        below -= countBelow(colFine, colCoarse);
+    }
+
+    /**
+     * @brief Value at position `rank` of the sorted window (0-based)
+     */
+    unsigned char select(std::uint32_t rank) {
+        while (below > rank) {
+            median--;
+            below -= fine[median];
+        }
+        while (below + fine[median] <= rank) {
+            below += fine[median];
+            median++;
+        }
+        return static_cast<unsigned char>(median);
+    }
+
+private:
+    std::uint32_t fine[BINS];   ///< Samples of each value in the window
+    int median = 0;             ///< Median found by the last select()
+    std::uint32_t below = 0;    ///< Samples in the window below `median`
+
+    // Number of samples of a column histogram that lie below the current median
+    std::uint32_t countBelow(const std::uint16_t* colFine, const std::uint16_t* colCoarse) const {
+        std::uint32_t count = 0;
+        int bucket = median >> COARSE_SHIFT;
+        for (int b = 0; b < bucket; b++) count += colCoarse[b];
+        for (int v = bucket << COARSE_SHIFT; v < median; v++) count += colFine[v];
+        return count;
+    }
+};
+
+#endif // MEDIAN_HISTOGRAM_H
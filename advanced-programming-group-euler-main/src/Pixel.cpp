@@ -15,6 +15,7 @@
 
 #include "Pixel.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 // *******************************************************************************************
@@ -67,6 +68,54 @@ float Pixel::getLuminance() const {
     return 0.2126f * r + 0.7152f * g + 0.0722f * b;
 }
 
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// SAMPLE BUFFER CONVERSION
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Decode interleaved samples (same channel expansion as stb_image loading)
+Pixel Pixel::fromSamples(const unsigned char* samples, int channels) {
+    unsigned char r = samples[0];
+    unsigned char g = (channels > 1) ? samples[1] : r;
+    unsigned char b = (channels > 2) ? samples[2] : r;
+    unsigned char a = (channels > 3) ? samples[3] : 255;
+    return Pixel(r, g, b, a);
+}
+// Encode into interleaved samples, keeping only the stored channels
+void Pixel::toSamples(unsigned char* samples, int channels) const {
+    samples[0] = r;
+    if (channels > 1) samples[1] = g;
+    if (channels > 2) samples[2] = b;
+    if (channels > 3) samples[3] = a;
+}
+// Luminance of each sample value alone, built on first use
+const Pixel::LuminanceTables& Pixel::getLuminanceTables() {
+    static const LuminanceTables tables = [] {
+        LuminanceTables built;
+        for (int v = 0; v < 256; ++v) {
+            built.r[v] = Pixel(v, 0, 0).getLuminance();
+            built.g[v] = Pixel(0, v, 0).getLuminance();
+            built.b[v] = Pixel(0, 0, v).getLuminance();
+        }
+        return built;
+    }();
+    return tables;
+}
+
+// Greyscale a row; the three table entries are summed in the same order as getLuminance()
+void Pixel::toGreyscaleRow(const unsigned char* samples, int channels, int width, unsigned char* grey) {
+    const LuminanceTables& tables = getLuminanceTables();
+
+    for (int x = 0; x < width; ++x) {
+        const unsigned char* pixel = samples + x * channels;
+        unsigned char r = pixel[0];
+        unsigned char g = (channels > 1) ? pixel[1] : r;
+        unsigned char b = (channels > 2) ? pixel[2] : r;
+        grey[x] = static_cast<unsigned char>(std::round(tables.r[r] + tables.g[g] + tables.b[b]));
+    }
+}
+
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
 // IMAGE MANIPULATION
@@ -16,6 +16,8 @@
 #ifndef PIXEL_H
 #define PIXEL_H
 
+#include <array>
+
 /**
  * @brief Class representing a single pixel in an image
  * 
@@ -31,6 +33,15 @@ private:
     unsigned char a; ///< Alpha channel value (0-255), default 255 (opaque)
 
 public:
+    /**
+     * @brief Luminance contribution of each value of R, G and B
+     *
+     * r[R] + g[G] + b[B], summed in that order, equals getLuminance() of Pixel(R, G, B).
+     */
+    struct LuminanceTables {
+        std::array<float, 256> r, g, b;
+    };
+
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
     // CONSTRUCTORS, DESTRUCTOR & CLONE
@@ -146,6 +157,50 @@ public:
      */
     float getLuminance() const;
 
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // SAMPLE BUFFER CONVERSION
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Build a pixel from interleaved 8-bit samples
+     *
+     * Missing channels are filled the same way images are loaded: G and B repeat R,
+     * and alpha defaults to 255.
+     *
+     * @param samples Pointer to the first sample of the pixel
+     * @param channels Number of samples stored per pixel (1-4)
+     * @return Pixel The decoded pixel
+     */
+    static Pixel fromSamples(const unsigned char* samples, int channels);
+
+    /**
+     * @brief Write the first `channels` components (R, G, B, A) to interleaved samples
+     *
+     * @param samples Pointer to the first sample of the destination pixel
+     * @param channels Number of samples stored per pixel (1-4)
+     */
+    void toSamples(unsigned char* samples, int channels) const;
+
+    /**
+     * @brief Convert a row of interleaved samples to greyscale
+     *
+     * Gives the same values as fromSamples(...).toGreyscale() for every pixel, with the
+     * luminance products looked up in tables instead of building a Pixel per sample.
+     *
+     * @param samples First sample of the row
+     * @param channels Number of samples stored per pixel (1-4)
+     * @param width Number of pixels in the row
+     * @param grey Receives one greyscale value per pixel
+     */
+    static void toGreyscaleRow(const unsigned char* samples, int channels, int width, unsigned char* grey);
+
+    /**
+     * @brief The luminance tables, built once and shared by every caller
+     */
+    static const LuminanceTables& getLuminanceTables();
+
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
     // IMAGE MANIPULATION
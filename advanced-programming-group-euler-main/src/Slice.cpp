@@ -16,10 +16,14 @@
  #include "Slice.h"
  #include "Volume.h"
  #include "Image.h"
+ #include "SliceCache.h"
+ #include "ThreadPool.h"
  #include <stdexcept>
  #include <tuple>
  #include <algorithm>
  #include <iostream>
+ #include <cstring>
+ #include <vector>
  
  // Default constructor
  Slice::Slice() : plane(SlicePlane::XY), position(0) {
@@ -111,38 +115,51 @@
                                     std::to_string(sliceWidth) + "x" + std::to_string(sliceHeight));
      }
      
-     // Create the slice image
-     Image slice(sliceWidth, sliceHeight, channels);
+     // A lazy volume only decodes the slices the plane crosses
+     if (volume.isLazy()) {
+         return extractLazy(volume, sliceWidth, sliceHeight);
+     }
      
-     // Extract the appropriate slice
-     switch (plane) {
-         case SlicePlane::XY:
-             // XY plane (constant Z)
-             for (int y = 0; y < height; ++y) {
-                 for (int x = 0; x < width; ++x) {
-                     slice.setPixel(x, y, volume.getVoxel(x, y, position));
-                 }
-             }
-             break;
-             
-         case SlicePlane::XZ:
-             // XZ plane (constant Y)
-             for (int z = 0; z < depth; ++z) {
-                 for (int x = 0; x < width; ++x) {
-                     slice.setPixel(x, z, volume.getVoxel(x, position, z));
-                 }
-             }
-             break;
-             
-         case SlicePlane::YZ:
-             // YZ plane (constant X)
-             for (int z = 0; z < depth; ++z) {
-                 for (int y = 0; y < height; ++y) {
-                     slice.setPixel(y, z, volume.getVoxel(position, y, z));
+     // Copy the requested plane straight out of the volume's voxel buffer
+     ConstImageView view = (plane == SlicePlane::XY) ? volume.getViewXY(position)
+                         : (plane == SlicePlane::XZ) ? volume.getViewXZ(position)
+                                                     : volume.getViewYZ(position);
+     Image slice(view);
+     
+     return slice;
+ }
+ 
+ // Gather the plane from the slices of a lazily loaded volume
+ Image Slice::extractLazy(const Volume& volume, int sliceWidth, int sliceHeight) const {
+     SliceCache& cache = *volume.getSliceCache();
+     const int channels = volume.getChannels();
+     const std::ptrdiff_t xStride = volume.getXStride();
+     const std::ptrdiff_t yStride = volume.getYStride();
+     
+     // An XY plane is one cached slice
+     if (plane == SlicePlane::XY) {
+         SliceCache::SlicePtr samples = cache.get(position);
+         return Image(ConstImageView(samples->data(), sliceWidth, sliceHeight, channels, yStride, xStride));
+     }
+     
+     // XZ and YZ planes take one row or column from every slice; fetching a batch per
+     // thread lets the missing slices decode concurrently
+     Image slice(sliceWidth, sliceHeight, channels);
+     const int batchSize = ThreadPool::shared().getThreadCount();
+     for (int zBegin = 0; zBegin < sliceHeight; zBegin += batchSize) {
+         int zEnd = std::min(zBegin + batchSize, sliceHeight);
+         std::vector<SliceCache::SlicePtr> batch = cache.get(zBegin, zEnd);
+         for (int z = zBegin; z < zEnd; ++z) {
+             const unsigned char* src = batch[z - zBegin]->data();
+             unsigned char* dst = slice.getRow(z);
+             if (plane == SlicePlane::XZ) {
+                 std::memcpy(dst, src + position * yStride, static_cast<size_t>(sliceWidth) * channels);
+             } else {
+                 for (int y = 0; y < sliceWidth; ++y) {
+                     std::memcpy(dst + y * channels, src + y * yStride + position * xStride, channels);
                  }
              }
-             break;
+         }
      }
-     
      return slice;
- }
\ No newline at end of file
+ }
@@ -40,6 +40,11 @@
      SlicePlane plane;     ///< Which plane to slice along
      int position;         ///< Position along the constant axis (e.g., Z-position for XY plane)
  
+     /**
+      * @brief Extract the plane from a lazily loaded volume, decoding only the slices it crosses
+      */
+     Image extractLazy(const Volume& volume, int sliceWidth, int sliceHeight) const;
+ 
  public:
      /**
       * @brief Default constructor - creates an XY slice at position 0
@@ -0,0 +1,138 @@
+/**
+ * @file SliceCache.cpp
+ * @brief Implementation of the SliceCache class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "SliceCache.h"
+#include "Volume.h"
+#include "ThreadPool.h"
+
+#include <stdexcept>
+#include <utility>
+
+SliceCache::SliceCache(std::vector<std::string> filenames, int width, int height, int channels,
+                       std::size_t budgetBytes)
+    : filenames(std::move(filenames)), width(width), height(height), channels(channels),
+      sliceBytes(static_cast<std::size_t>(width) * height * channels), budget(budgetBytes) {
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// SLICE ACCESS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Single slice: a range of one
+SliceCache::SlicePtr SliceCache::get(int z) {
+    return get(z, z + 1).front();
+}
+
+// Hits are taken under the lock; misses are decoded outside it, in parallel
+std::vector<SliceCache::SlicePtr> SliceCache::get(int zBegin, int zEnd) {
+    if (zBegin < 0 || zEnd > static_cast<int>(filenames.size()) || zBegin >= zEnd) {
+        throw std::out_of_range("Slice range is out of range: " + std::to_string(zBegin) + "-" +
+                                std::to_string(zEnd - 1));
+    }
+
+    std::vector<SlicePtr> slices(zEnd - zBegin);
+    std::vector<int> missing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int z = zBegin; z < zEnd; ++z) {
+            auto found = entries.find(z);
+            if (found == entries.end()) {
+                missing.push_back(z);
+                continue;
+            }
+            recent.splice(recent.begin(), recent, found->second.position);
+            slices[z - zBegin] = found->second.slice;
+        }
+    }
+    if (missing.empty()) {
+        return slices;
+    }
+
+    ThreadPool::shared().parallelFor(0, static_cast<int>(missing.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            slices[missing[i] - zBegin] = decode(missing[i]);
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int z : missing) {
+        insert(z, slices[z - zBegin]);
+    }
+    decodeCount += missing.size();
+    return slices;
+}
+
+// Decode one slice image into a fresh buffer
+SliceCache::SlicePtr SliceCache::decode(int z) const {
+    auto slice = std::make_shared<SliceBuffer>(sliceBytes);
+    if (!Volume::decodeSlice(filenames[z], width, height, channels, slice->data())) {
+        throw std::runtime_error("Failed to load slice: " + filenames[z]);
+    }
+    return slice;
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// LRU BOOKKEEPING
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Add (or refresh) slice z as the most recently used, then trim to the budget
+void SliceCache::insert(int z, SlicePtr slice) {
+    auto found = entries.find(z);
+    if (found != entries.end()) {
+        // Decoded concurrently by another caller; keep the cached copy
+        recent.splice(recent.begin(), recent, found->second.position);
+        return;
+    }
+    recent.push_front(z);
+    entries.emplace(z, Entry{std::move(slice), recent.begin()});
+    evict();
+}
+
+// Drop least recently used slices until the budget is met, keeping at least one
+void SliceCache::evict() {
+    while (entries.size() > 1 && entries.size() * sliceBytes > budget) {
+        entries.erase(recent.back());
+        recent.pop_back();
+    }
+}
+
+void SliceCache::setBudget(std::size_t budgetBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = budgetBytes;
+    evict();
+}
+
+std::size_t SliceCache::getBudget() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budget;
+}
+
+std::size_t SliceCache::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size() * sliceBytes;
+}
+
+std::size_t SliceCache::getDecodeCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return decodeCount;
+}
+
+const std::vector<std::string>& SliceCache::getFilenames() const {
+    return filenames;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file SliceCache.h
+ * @brief Declaration of the SliceCache class, a bounded LRU cache of decoded volume slices
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef SLICE_CACHE_H
+#define SLICE_CACHE_H
+
+#include "AlignedAllocator.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Decodes the XY slices of a lazily loaded Volume on demand and keeps the most
+ *        recently used ones within a memory budget
+ *
+ * Slices are handed out as shared pointers, so a slice stays valid for as long as the
+ * caller holds it even if the cache evicts it in the meantime. The budget bounds what
+ * the cache itself keeps; the most recently used slice is always kept, however small
+ * the budget. All methods may be called from several threads at once.
+ */
+class SliceCache {
+public:
+    using SliceBuffer = std::vector<unsigned char, AlignedAllocator<unsigned char>>;
+    using SlicePtr = std::shared_ptr<const SliceBuffer>; ///< Compact samples of one XY slice
+
+    /**
+     * @brief Create an empty cache over a list of slice images
+     *
+     * @param filenames Slice images in Z order, all of the given size
+     * @param width Width of every slice
+     * @param height Height of every slice
+     * @param channels Samples per pixel to decode to
+     * @param budgetBytes Most bytes of decoded slices to keep
+     */
+    SliceCache(std::vector<std::string> filenames, int width, int height, int channels,
+               std::size_t budgetBytes);
+
+    /**
+     * @brief Get slice z, decoding it if it is not cached
+     *
+     * @throws std::out_of_range If z is not a slice index
+     * @throws std::runtime_error If the slice image cannot be decoded
+     */
+    SlicePtr get(int z);
+
+    /**
+     * @brief Get slices [zBegin, zEnd), decoding the missing ones concurrently on the
+     *        shared ThreadPool
+     *
+     * @throws std::out_of_range If the range is not within the volume
+     * @throws std::runtime_error If a slice image cannot be decoded
+     */
+    std::vector<SlicePtr> get(int zBegin, int zEnd);
+
+    /**
+     * @brief Change the memory budget, evicting slices if it shrinks
+     */
+    void setBudget(std::size_t budgetBytes);
+
+    std::size_t getBudget() const;
+
+    /**
+     * @brief Bytes of decoded slices currently held by the cache
+     */
+    std::size_t getCachedBytes() const;
+
+    /**
+     * @brief Number of slices decoded so far (cache misses)
+     */
+    std::size_t getDecodeCount() const;
+
+    /**
+     * @brief Filenames of the slices, in Z order
+     */
+    const std::vector<std::string>& getFilenames() const;
+
+private:
+    using LruList = std::list<int>;  ///< Slice indices, most recently used first
+
+    struct Entry {
+        SlicePtr slice;
+        LruList::iterator position;
+    };
+
+    SlicePtr decode(int z) const;
+    void insert(int z, SlicePtr slice);   ///< Caller holds `mutex`
+    void evict();                         ///< Caller holds `mutex`
+
+    std::vector<std::string> filenames;
+    int width, height, channels;
+    std::size_t sliceBytes;
+
+    mutable std::mutex mutex;
+    std::size_t budget;
+    LruList recent;
+    std::unordered_map<int, Entry> entries;
+    std::size_t decodeCount = 0;
+};
+
+#endif // SLICE_CACHE_H
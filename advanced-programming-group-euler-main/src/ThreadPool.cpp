@@ -0,0 +1,177 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the ThreadPool class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+    // Set while a thread is executing a band, so nested parallelFor calls run inline
+    thread_local bool insideParallelFor = false;
+
+    std::mutex sharedPoolMutex;
+    std::unique_ptr<ThreadPool> sharedPool;
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// CONSTRUCTORS & DESTRUCTOR
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Start threadCount - 1 workers; the caller of parallelFor is the last thread
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1) {
+        throw std::invalid_argument("Thread count must be at least 1");
+    }
+    workers.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// Wake the workers with the stop flag set and wait for them to exit
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// PARALLEL EXECUTION
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Number of threads working on a parallelFor
+int ThreadPool::getThreadCount() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+// Split [begin, end) into contiguous bands and process them on all threads
+void ThreadPool::parallelFor(int begin, int end, const RangeFunction& body, int minBand) {
+    if (end <= begin) {
+        return;
+    }
+    const int range = end - begin;
+    const int bands = std::min(getThreadCount(), std::max(1, range / std::max(1, minBand)));
+    if (bands == 1 || insideParallelFor) {
+        body(begin, end);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        job = &body;
+        jobBegin = begin;
+        jobEnd = end;
+        bandCount = bands;
+        bandSize = (range + bands - 1) / bands;
+        busyWorkers = static_cast<int>(workers.size());
+        firstError = nullptr;
+        ++generation;
+    }
+    jobReady.notify_all();
+
+    runBands(0);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    jobFinished.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+// Run this thread's bands (every getThreadCount()-th band, starting at its index)
+void ThreadPool::runBands(int threadIndex) {
+    insideParallelFor = true;
+    for (int band = threadIndex; band < bandCount; band += getThreadCount()) {
+        int bandBegin = jobBegin + band * bandSize;
+        int bandEnd = std::min(jobEnd, bandBegin + bandSize);
+        if (bandBegin >= bandEnd) {
+            continue;
+        }
+        try {
+            (*job)(bandBegin, bandEnd);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    }
+    insideParallelFor = false;
+}
+
+// Wait for a new job (or shutdown), help with it, then report back
+void ThreadPool::workerLoop(int threadIndex) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            jobReady.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runBands(threadIndex);
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--busyWorkers == 0) {
+            jobFinished.notify_one();
+        }
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// SHARED POOL
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Process-wide pool, created lazily
+ThreadPool& ThreadPool::shared() {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    if (!sharedPool) {
+        sharedPool = std::make_unique<ThreadPool>(defaultThreadCount());
+    }
+    return *sharedPool;
+}
+
+// Resize the shared pool
+void ThreadPool::setSharedThreadCount(int threadCount) {
+    auto pool = std::make_unique<ThreadPool>(threadCount);
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    sharedPool = std::move(pool);
+}
+
+// Hardware concurrency with a fallback of one thread
+int ThreadPool::defaultThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : static_cast<int>(count);
+}
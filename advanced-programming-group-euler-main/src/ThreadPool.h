@@ -0,0 +1,163 @@
+/**
+ * @file ThreadPool.h
+ * @brief Declaration of the ThreadPool class used to run filters over row bands in parallel
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads with a blocking parallel-for
+ *
+ * parallelFor() splits an index range (typically image rows) into contiguous bands and
+ * runs the body once per band, on the workers and on the calling thread. The split depends
+ * only on the range and the thread count, and every band is handled by exactly one call, so
+ * a body that writes only to its own rows gives the same result as a serial loop.
+ *
+ * Filters share one process-wide pool (shared()); its size is set once at start-up, e.g.
+ * from the `--threads` command-line option. Calls made from inside a running parallelFor
+ * execute serially on the calling thread instead of waiting on the busy pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Non-owning reference to a parallelFor body, called as body(begin, end)
+     *
+     * Unlike std::function it never copies the callable, so passing a lambda to
+     * parallelFor does not allocate. It refers to the caller's callable, which outlives
+     * the blocking parallelFor call.
+     */
+    class RangeFunction {
+    public:
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, RangeFunction>>>
+        RangeFunction(F&& body)
+            : object(const_cast<void*>(static_cast<const void*>(std::addressof(body)))),
+              invoke([](void* callable, int begin, int end) {
+                  (*static_cast<std::add_pointer_t<std::remove_reference_t<F>>>(callable))(begin, end);
+              }) {}
+
+        void operator()(int begin, int end) const { invoke(object, begin, end); }
+
+    private:
+        void* object;                            ///< The referenced callable
+        void (*invoke)(void*, int begin, int end); ///< Calls it with a band
+    };
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // CONSTRUCTORS & DESTRUCTOR
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Construct a pool
+     *
+     * @param threadCount Total number of threads taking part in a parallelFor, including the
+     *                    calling thread (so `threadCount - 1` workers are started)
+     * @throws std::invalid_argument If threadCount is less than 1
+     */
+    explicit ThreadPool(int threadCount);
+
+    /**
+     * @brief Stop and join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // PARALLEL EXECUTION
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Run `body` over [begin, end) split into at most getThreadCount() bands
+     *
+     * Band i always runs on thread i (the caller is thread 0), so repeating a parallelFor
+     * over the same range gives each thread the same band, and any per-thread scratch
+     * space it grew the first time is large enough the next. Blocks until every band is
+     * done. If a band throws, the first exception is rethrown
+     * here once all bands have finished.
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param body Called as body(bandBegin, bandEnd) for each band
+     * @param minBand Smallest band worth handing to another thread
+     */
+    void parallelFor(int begin, int end, const RangeFunction& body, int minBand = 1);
+
+    /**
+     * @brief Number of threads taking part in a parallelFor (workers plus the caller)
+     */
+    int getThreadCount() const;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // SHARED POOL
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Process-wide pool used by the filters
+     *
+     * Created on first use with defaultThreadCount() threads.
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief Replace the shared pool with one of `threadCount` threads
+     *
+     * Must not be called while the shared pool is running a parallelFor.
+     *
+     * @throws std::invalid_argument If threadCount is less than 1
+     */
+    static void setSharedThreadCount(int threadCount);
+
+    /**
+     * @brief Hardware concurrency, or 1 if it cannot be determined
+     */
+    static int defaultThreadCount();
+
+private:
+    void workerLoop(int threadIndex);
+    void runBands(int threadIndex);
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;             ///< Serialises concurrent parallelFor callers
+    std::mutex stateMutex;              ///< Guards the job state below
+    std::condition_variable jobReady;
+    std::condition_variable jobFinished;
+
+    const RangeFunction* job = nullptr; ///< Body of the running parallelFor
+    int jobBegin = 0;
+    int bandSize = 0;
+    int bandCount = 0;
+    int jobEnd = 0;
+    int busyWorkers = 0;
+    std::uint64_t generation = 0;       ///< Incremented for every job so workers wake once
+    bool stopping = false;
+    std::exception_ptr firstError;
+};
+
+#endif // THREAD_POOL_H
@@ -20,6 +20,9 @@
  #include "./filter3D/Median3DFilter.h"
  #include "./projectionFunc/Projection.h"
  #include "Slice.h"
+ #include "ThreadPool.h"
+ #include "BrickedVolume.h"
+ #include "SliceCache.h"
  #include <stdexcept>
  #include <algorithm>
  #include <cmath>
@@ -29,6 +32,10 @@
  #include <filesystem>
  #include <regex>
  #include <iostream>  // Added this include for std::cerr and std::endl
+ #include <cstring>
+ #include <cstdint>
+ #include <bit>
+ #include <fstream>
  
  // Include STB image libraries
  #include "stb_image.h"
@@ -45,14 +52,8 @@
          throw std::invalid_argument("Channels must be between 1 and 4");
      }
      
-     // Initialize 3D voxel array with default (black) pixels
-     voxels.resize(depth);
-     for (int z = 0; z < depth; ++z) {
-         voxels[z].resize(height);
-         for (int y = 0; y < height; ++y) {
-             voxels[z][y].resize(width, Pixel());
-         }
-     }
+     // Initialize voxel buffer with default (black) pixels
+     allocate();
  }
  
  // Constructor from a series of image files
@@ -85,6 +86,24 @@
      }
  }
  
+ // Copy constructor: a mapped volume's samples are copied into an owned buffer
+ Volume::Volume(const Volume& other)
+     : DataContainer(other), voxels(other.voxels), sliceCache(other.sliceCache), depth(other.depth),
+       sliceFilenames(other.sliceFilenames), channels(other.channels) {
+     if (other.mappedFile) {
+         voxels.assign(other.getData(), other.getData() + other.getZStride() * depth);
+     }
+ }
+ 
+ // Copy assignment, with the same rule as the copy constructor
+ Volume& Volume::operator=(const Volume& other) {
+     if (this != &other) {
+         Volume copy(other);
+         *this = std::move(copy);
+     }
+     return *this;
+ }
+ 
  // Destructor
  Volume::~Volume() {
      // No specific cleanup needed as std::vector handles memory automatically
@@ -105,72 +124,273 @@
      return (x >= 0 && x < width && y >= 0 && y < height && z >= 0 && z < depth);
  }
  
- // Load volume data from a series of image files
- bool Volume::loadFromFiles(const std::vector<std::string>& filenames) {
+ // Allocate the contiguous voxel buffer for the current dimensions
+ void Volume::allocate() {
+     mappedFile.reset();
+     sliceCache.reset();
+     voxels.assign(static_cast<size_t>(getZStride()) * depth, 0);
+ 
+     // Opaque alpha, as for a default Pixel
+     if (channels == 4) {
+         for (size_t i = 3; i < voxels.size(); i += 4) {
+             voxels[i] = 255;
+         }
+     }
+ }
+ 
+ // *******************************************************************************************
+ // -------------------------------------------------------------------------------------------
+ // RAW VOXEL ACCESS
+ // -------------------------------------------------------------------------------------------
+ // *******************************************************************************************
+ 
+ // Strides in bytes (X fastest, slices packed back to back)
+ std::ptrdiff_t Volume::getXStride() const {
+     return channels;
+ }
+ std::ptrdiff_t Volume::getYStride() const {
+     return static_cast<std::ptrdiff_t>(width) * channels;
+ }
+ std::ptrdiff_t Volume::getZStride() const {
+     return static_cast<std::ptrdiff_t>(width) * height * channels;
+ }
+ 
+ // A lazy volume has no buffer to point into
+ void Volume::requireLoaded() const {
+     if (sliceCache) {
+         throw std::logic_error("Volume slices are loaded on demand; call loadAllSlices() "
+                                "before accessing the voxel buffer");
+     }
+ }
+ 
+ // Raw buffer access: a mapped volume starts mappedOffset bytes into the raw volume file
+ unsigned char* Volume::getData() {
+     requireLoaded();
+     return mappedFile ? mappedFile->data() + mappedOffset : voxels.data();
+ }
+ const unsigned char* Volume::getData() const {
+     requireLoaded();
+     return mappedFile ? mappedFile->data() + mappedOffset : voxels.data();
+ }
+ 
+ // Raw voxel access (no bounds checking)
+ unsigned char* Volume::getVoxelPtr(int x, int y, int z) {
+     return getData() + x * getXStride() + y * getYStride() + z * getZStride();
+ }
+ const unsigned char* Volume::getVoxelPtr(int x, int y, int z) const {
+     return getData() + x * getXStride() + y * getYStride() + z * getZStride();
+ }
+ 
+ // XY plane: rows of the slice are contiguous
+ ImageView Volume::getViewXY(int z) {
+     if (z < 0 || z >= depth) {
+         throw std::out_of_range("Z-position is out of range: " + std::to_string(z));
+     }
+     return ImageView(getVoxelPtr(0, 0, z), width, height, channels, getYStride(), getXStride());
+ }
+ ConstImageView Volume::getViewXY(int z) const {
+     if (z < 0 || z >= depth) {
+         throw std::out_of_range("Z-position is out of range: " + std::to_string(z));
+     }
+     return ConstImageView(getVoxelPtr(0, 0, z), width, height, channels, getYStride(), getXStride());
+ }
+ 
+ // XZ plane: each row is one row of a different slice
+ ImageView Volume::getViewXZ(int y) {
+     if (y < 0 || y >= height) {
+         throw std::out_of_range("Y-position is out of range: " + std::to_string(y));
+     }
+     return ImageView(getVoxelPtr(0, y, 0), width, depth, channels, getZStride(), getXStride());
+ }
+ ConstImageView Volume::getViewXZ(int y) const {
+     if (y < 0 || y >= height) {
+         throw std::out_of_range("Y-position is out of range: " + std::to_string(y));
+     }
+     return ConstImageView(getVoxelPtr(0, y, 0), width, depth, channels, getZStride(), getXStride());
+ }
+ 
+ // YZ plane: pixels step along Y, rows step along Z
+ ImageView Volume::getViewYZ(int x) {
+     if (x < 0 || x >= width) {
+         throw std::out_of_range("X-position is out of range: " + std::to_string(x));
+     }
+     return ImageView(getVoxelPtr(x, 0, 0), height, depth, channels, getZStride(), getYStride());
+ }
+ ConstImageView Volume::getViewYZ(int x) const {
+     if (x < 0 || x >= width) {
+         throw std::out_of_range("X-position is out of range: " + std::to_string(x));
+     }
+     return ConstImageView(getVoxelPtr(x, 0, 0), height, depth, channels, getZStride(), getYStride());
+ }
+ 
+ // Z-column: a 1 x depth view, one slice per row
+ ConstImageView Volume::getColumnZ(int x, int y) const {
+     if (!isInBounds(x, y)) {
+         throw std::out_of_range("Column coordinates out of bounds: (" + 
+                                std::to_string(x) + "," + std::to_string(y) + ")");
+     }
+     return ConstImageView(getVoxelPtr(x, y, 0), 1, depth, channels, getZStride(), getXStride());
+ }
+ 
+ // Read every slice header (no pixel decoding) and check the slices agree in size
+ bool Volume::readSliceHeaders(const std::vector<std::string>& filenames,
+                               int& width, int& height, int& channels) {
      if (filenames.empty()) {
          return false;
      }
      
-     // Store filenames for reference
-     sliceFilenames = filenames;
+     const int sliceCount = static_cast<int>(filenames.size());
+     std::vector<int> sliceWidths(sliceCount), sliceHeights(sliceCount), sliceChannels(sliceCount);
+     std::vector<char> headerOk(sliceCount);
+     ThreadPool::shared().parallelFor(0, sliceCount, [&](int zBegin, int zEnd) {
+         for (int z = zBegin; z < zEnd; ++z) {
+             headerOk[z] = stbi_info(filenames[z].c_str(), &sliceWidths[z], &sliceHeights[z],
+                                     &sliceChannels[z]) != 0;
+         }
+     });
+     
+     // Report problems in slice order, as a sequential load would
+     for (int z = 0; z < sliceCount; ++z) {
+         if (!headerOk[z]) {
+             return false;
+         }
+         if (sliceWidths[z] != sliceWidths[0] || sliceHeights[z] != sliceHeights[0]) {
+             throw std::runtime_error("All slices must have the same dimensions. " + 
+                                     filenames[z] + " differs from " + filenames[0]);
+         }
+     }
      
-     // Load first image to get dimensions
+     width = sliceWidths[0];
+     height = sliceHeights[0];
+     channels = sliceChannels[0];
+     return true;
+ }
+ 
+ // Decode one slice image into compact samples with the requested channel count
+ bool Volume::decodeSlice(const std::string& filename, int width, int height, int channels,
+                          unsigned char* samples) {
      int w, h, c;
-     unsigned char* data = stbi_load(filenames[0].c_str(), &w, &h, &c, 0);
+     unsigned char* data = stbi_load(filename.c_str(), &w, &h, &c, 0);
      if (!data) {
          return false;
      }
+     if (w != width || h != height) {
+         // The file changed since its header was read
+         stbi_image_free(data);
+         return false;
+     }
+     
+     // A straight copy when the layout matches, otherwise convert each pixel
+     const size_t pixels = static_cast<size_t>(width) * height;
+     if (c == channels) {
+         std::memcpy(samples, data, pixels * channels);
+     } else {
+         for (size_t i = 0; i < pixels; ++i) {
+             Pixel::fromSamples(data + i * c, c).toSamples(samples + i * channels, channels);
+         }
+     }
+     stbi_image_free(data);
+     return true;
+ }
+ 
+ // Load volume data from a series of image files
+ bool Volume::loadFromFiles(const std::vector<std::string>& filenames) {
+     // Learn and validate the dimensions from the image headers alone
+     int w, h, c;
+     if (!readSliceHeaders(filenames, w, h, c)) {
+         return false;
+     }
+     
+     // Store filenames for reference
+     sliceFilenames = filenames;
      
      // Update dimensions
      width = w;
      height = h;
-     depth = filenames.size();
+     depth = static_cast<int>(filenames.size());
      channels = c;
      
-     // Initialize voxels array with the correct dimensions
-     voxels.resize(depth);
-     for (int z = 0; z < depth; ++z) {
-         voxels[z].resize(height);
-         for (int y = 0; y < height; ++y) {
-             voxels[z][y].resize(width);
+     // Initialize voxel buffer with the correct dimensions
+     allocate();
+     
+     // Decode the slices concurrently, each straight into its own Z plane
+     std::vector<char> decoded(depth);
+     ThreadPool::shared().parallelFor(0, depth, [&](int zBegin, int zEnd) {
+         for (int z = zBegin; z < zEnd; ++z) {
+             decoded[z] = decodeSlice(filenames[z], width, height, channels, getVoxelPtr(0, 0, z));
          }
+     });
+     
+     return std::all_of(decoded.begin(), decoded.end(), [](char ok) { return ok != 0; });
+ }
+ 
+ // Read the headers only; slices are decoded through the cache when first needed
+ bool Volume::loadFromFilesLazy(const std::vector<std::string>& filenames, std::size_t cacheBytes) {
+     int w, h, c;
+     if (!readSliceHeaders(filenames, w, h, c)) {
+         return false;
      }
      
-     // Free the first image data as we'll reload it with the other slices
-     stbi_image_free(data);
+     sliceFilenames = filenames;
+     width = w;
+     height = h;
+     depth = static_cast<int>(filenames.size());
+     channels = c;
      
-     // Load all slices sequentially
-     for (int z = 0; z < depth; ++z) {
-         int sliceChannels;
-         data = stbi_load(filenames[z].c_str(), &w, &h, &sliceChannels, 0);
-         if (!data) {
-             return false;
-         }
-         
-         // Check if all slices have the same dimensions
-         if (w != width || h != height) {
-             stbi_image_free(data);
-             throw std::runtime_error("All slices must have the same dimensions. " + 
-                                     filenames[z] + " differs from " + filenames[0]);
-         }
-         
-         // Copy data to voxels
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 int index = (y * width + x) * sliceChannels;
-                 unsigned char r = data[index];
-                 unsigned char g = (sliceChannels > 1) ? data[index + 1] : r;
-                 unsigned char b = (sliceChannels > 2) ? data[index + 2] : r;
-                 unsigned char a = (sliceChannels > 3) ? data[index + 3] : 255;
-                 voxels[z][y][x] = Pixel(r, g, b, a);
-             }
-         }
-         
-         // Free image data after copying
-         stbi_image_free(data);
+     // Drop any previous samples before switching to the cache
+     mappedFile.reset();
+     voxels.clear();
+     voxels.shrink_to_fit();
+     sliceCache = std::make_shared<SliceCache>(filenames, width, height, channels, cacheBytes);
+     return true;
+ }
+ 
+ // Check whether slices are still decoded on demand
+ bool Volume::isLazy() const {
+     return sliceCache != nullptr;
+ }
+ 
+ // Decode the whole stack into the voxel buffer (allocate() drops the cache)
+ void Volume::loadAllSlices() {
+     if (!sliceCache) {
+         return;
+     }
+     std::vector<std::string> filenames = sliceCache->getFilenames();
+     if (!loadFromFiles(filenames)) {
+         throw std::runtime_error("Failed to load volume from files: " + filenames[0] + " (and others)");
+     }
+ }
+ 
+ // Cache of a lazy volume (nullptr otherwise)
+ SliceCache* Volume::getSliceCache() const {
+     return sliceCache.get();
+ }
+ 
+ // Keep slices [firstZ, lastZ]; a mapped volume just starts further into the file
+ void Volume::cropDepth(int firstZ, int lastZ) {
+     if (firstZ < 0 || lastZ >= depth || firstZ > lastZ) {
+         throw std::out_of_range("Slice range out of bounds: " + std::to_string(firstZ) + " to " +
+                                 std::to_string(lastZ) + " (valid range: 0-" + std::to_string(depth - 1) + ")");
+     }
+     if (sliceCache) {
+         const std::vector<std::string>& filenames = sliceCache->getFilenames();
+         std::vector<std::string> kept(filenames.begin() + firstZ, filenames.begin() + lastZ + 1);
+         loadFromFilesLazy(kept, sliceCache->getBudget());
+         return;
      }
      
-     return true;
+     std::size_t sliceBytes = static_cast<std::size_t>(getZStride());
+     if (mappedFile) {
+         mappedOffset += sliceBytes * firstZ;
+     } else {
+         voxels.erase(voxels.begin() + sliceBytes * (lastZ + 1), voxels.end());
+         voxels.erase(voxels.begin(), voxels.begin() + sliceBytes * firstZ);
+     }
+     if (static_cast<int>(sliceFilenames.size()) == depth) {
+         sliceFilenames.erase(sliceFilenames.begin() + lastZ + 1, sliceFilenames.end());
+         sliceFilenames.erase(sliceFilenames.begin(), sliceFilenames.begin() + firstZ);
+     }
+     depth = lastZ - firstZ + 1;
  }
  
  // Load volume data from a base path with range of indices
@@ -255,7 +475,11 @@
          throw std::out_of_range("Voxel coordinates out of bounds: (" + 
                                 std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")");
      }
-     return voxels[z][y][x];
+     if (sliceCache) {
+         SliceCache::SlicePtr slice = sliceCache->get(z);
+         return Pixel::fromSamples(slice->data() + x * getXStride() + y * getYStride(), channels);
+     }
+     return Pixel::fromSamples(getVoxelPtr(x, y, z), channels);
  }
  
  // Set a pixel (voxel) at a specific position
@@ -264,7 +488,8 @@
          throw std::out_of_range("Voxel coordinates out of bounds: (" + 
                                 std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")");
      }
-     voxels[z][y][x] = pixel;
+     loadAllSlices();
+     pixel.toSamples(getVoxelPtr(x, y, z), channels);
  }
  
  // Save all slices of the volume to files
@@ -287,38 +512,161 @@
      return allSucceeded;
  }
  
- // Save a specific slice of the volume to a file
- bool Volume::saveSliceToFile(const std::string& filename, int sliceIndex) const {
-     if (sliceIndex < 0 || sliceIndex >= depth) {
-         throw std::out_of_range("Slice index out of bounds: " + std::to_string(sliceIndex));
+ // Anonymous namespace to keep the raw format details local to this file
+ namespace {
+     // On-disk header of a raw volume file; the samples follow immediately
+     struct RawVolumeHeader {
+         char magic[8];             ///< "APVOLUME"
+         std::uint32_t version;     ///< Format version (1)
+         std::uint32_t headerSize;  ///< Bytes before the samples (64)
+         std::int32_t width;
+         std::int32_t height;
+         std::int32_t depth;
+         std::int32_t channels;
+         std::uint32_t sampleType;  ///< 1 = unsigned 8-bit
+         std::uint32_t reserved;
+         std::uint64_t dataSize;    ///< Bytes of samples (width * height * depth * channels)
+         std::uint64_t checksum;    ///< rawChecksum() of the samples
+         unsigned char padding[8];
+     };
+     static_assert(sizeof(RawVolumeHeader) == 64, "Raw volume header must be 64 bytes");
+     
+     constexpr char RAW_MAGIC[8] = {'A', 'P', 'V', 'O', 'L', 'U', 'M', 'E'};
+     constexpr std::uint32_t RAW_VERSION = 1;
+     constexpr std::uint32_t RAW_SAMPLE_UINT8 = 1;
+     
+     // FNV-1a over little-endian 64-bit words, then over the trailing bytes
+     std::uint64_t rawChecksum(const unsigned char* data, std::size_t size) {
+         const std::uint64_t prime = 0x100000001b3ULL;
+         std::uint64_t hash = 0xcbf29ce484222325ULL;
+         std::size_t i = 0;
+         for (; i + 8 <= size; i += 8) {
+             std::uint64_t word;
+             std::memcpy(&word, data + i, 8);
+             hash = (hash ^ word) * prime;
+         }
+         for (; i < size; ++i) {
+             hash = (hash ^ data[i]) * prime;
+         }
+         return hash;
+     }
+ }
+ 
+ // Write the header and then the samples exactly as stored in memory
+ bool Volume::saveToRaw(const std::string& filename) const {
+     static_assert(std::endian::native == std::endian::little, "Raw volumes are stored little-endian");
+     
+     RawVolumeHeader header = {};
+     std::memcpy(header.magic, RAW_MAGIC, sizeof(RAW_MAGIC));
+     header.version = RAW_VERSION;
+     header.headerSize = RAW_HEADER_SIZE;
+     header.width = width;
+     header.height = height;
+     header.depth = depth;
+     header.channels = channels;
+     header.sampleType = RAW_SAMPLE_UINT8;
+     header.dataSize = static_cast<std::uint64_t>(getZStride()) * depth;
+     header.checksum = rawChecksum(getData(), header.dataSize);
+     
+     std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+     if (!file) {
+         return false;
+     }
+     file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+     file.write(reinterpret_cast<const char*>(getData()), static_cast<std::streamsize>(header.dataSize));
+     return static_cast<bool>(file);
+ }
+ 
+ // Map a raw volume file and use its samples in place
+ bool Volume::loadFromRaw(const std::string& filename, bool verifyChecksum) {
+     if (!std::filesystem::is_regular_file(filename)) {
+         return false;
      }
      
-     // Create data array for stb_image_write
-     unsigned char* data = new unsigned char[width * height * channels];
+     auto mapping = std::make_shared<MappedFile>(filename);
+     RawVolumeHeader header;
+     if (mapping->size() < sizeof(header)) {
+         throw std::runtime_error("Not a raw volume file (too short): " + filename);
+     }
+     std::memcpy(&header, mapping->data(), sizeof(header));
      
-     // Copy slice data to array
-     for (int y = 0; y < height; ++y) {
-         for (int x = 0; x < width; ++x) {
-             Pixel p = voxels[sliceIndex][y][x];
-             int index = (y * width + x) * channels;
-             data[index] = p.getR();
-             if (channels > 1) data[index + 1] = p.getG();
-             if (channels > 2) data[index + 2] = p.getB();
-             if (channels > 3) data[index + 3] = p.getA();
-         }
+     if (std::memcmp(header.magic, RAW_MAGIC, sizeof(RAW_MAGIC)) != 0) {
+         throw std::runtime_error("Not a raw volume file: " + filename);
+     }
+     if (header.version != RAW_VERSION || header.headerSize != RAW_HEADER_SIZE) {
+         throw std::runtime_error("Unsupported raw volume version " + std::to_string(header.version) +
+                                  ": " + filename);
+     }
+     if (header.sampleType != RAW_SAMPLE_UINT8) {
+         throw std::runtime_error("Unsupported raw volume sample type: " + filename);
+     }
+     if (header.width <= 0 || header.height <= 0 || header.depth <= 0 ||
+         header.channels <= 0 || header.channels > 4) {
+         throw std::runtime_error("Invalid raw volume dimensions: " + filename);
+     }
+     std::uint64_t expected = static_cast<std::uint64_t>(header.width) * header.height *
+                              header.depth * header.channels;
+     if (header.dataSize != expected || mapping->size() - RAW_HEADER_SIZE < expected) {
+         throw std::runtime_error("Raw volume file is truncated: " + filename);
+     }
+     if (verifyChecksum && rawChecksum(mapping->data() + RAW_HEADER_SIZE, expected) != header.checksum) {
+         throw std::runtime_error("Raw volume checksum mismatch: " + filename);
      }
      
-     // Write to file
-     int success = stbi_write_png(filename.c_str(), width, height, channels, data, 0);
+     width = header.width;
+     height = header.height;
+     depth = header.depth;
+     channels = header.channels;
+     sliceFilenames.clear();
+     voxels.clear();
+     voxels.shrink_to_fit();
+     sliceCache.reset();
+     mappedFile = std::move(mapping);
+     mappedOffset = RAW_HEADER_SIZE;
+     return true;
+ }
+ 
+ // Write the volume as compressed bricks
+ bool Volume::saveToBricked(const std::string& filename, int brickSize) const {
+     return BrickedVolume::save(*this, filename, brickSize);
+ }
+ 
+ // Decompress every brick of a bricked file into this volume
+ bool Volume::loadFromBricked(const std::string& filename) {
+     if (!std::filesystem::is_regular_file(filename)) {
+         return false;
+     }
+     std::unique_ptr<Volume> loaded = BrickedVolume(filename).load();
+     std::string keepName = name;
+     *this = std::move(*loaded);
+     name = keepName;
+     return true;
+ }
+ 
+ // Save a specific slice of the volume to a file
+ bool Volume::saveSliceToFile(const std::string& filename, int sliceIndex) const {
+     if (sliceIndex < 0 || sliceIndex >= depth) {
+         throw std::out_of_range("Slice index out of bounds: " + std::to_string(sliceIndex));
+     }
      
-     // Clean up
-     delete[] data;
+     // Slices are stored in the same interleaved layout stb_image_write expects
+     SliceCache::SlicePtr cached = sliceCache ? sliceCache->get(sliceIndex) : nullptr;
+     const unsigned char* samples = cached ? cached->data() : getVoxelPtr(0, 0, sliceIndex);
+     int success = stbi_write_png(filename.c_str(), width, height, channels,
+                                  samples, static_cast<int>(getYStride()));
      
      return success != 0;
  }
  
  // Apply a filter to the volume
  std::unique_ptr<Volume> Volume::applyFilter(VolumeFilter& filter) const {
+     // Filters read the whole voxel buffer, so a lazy volume is filtered through a loaded copy
+     if (sliceCache) {
+         Volume loaded(*this);
+         loaded.loadAllSlices();
+         return filter.apply(loaded);
+     }
+     
      // Delegate the filtering operation to the VolumeFilter object
      return filter.apply(*this);
  }
@@ -332,7 +680,7 @@
      
      // Create a Gaussian3DFilter and apply it
      Gaussian3DFilter filter(kernelSize, sigma);
-     return filter.apply(*this);
+     return applyFilter(filter);
  }
  
  // Apply a Median 3D filter to the volume
@@ -344,11 +692,31 @@
      
      // Create a Median3DFilter and apply it
      Median3DFilter filter(kernelSize);
-     return filter.apply(*this);
+     return applyFilter(filter);
  }
  
  // Apply a projection to generate a 2D image
  Image Volume::applyProjection(const Projection& projection) const {
+     // A lazy volume feeds the slab to the projection's accumulator a batch of cached
+     // slices at a time, so only the slab is ever decoded
+     if (sliceCache) {
+         int startZ, endZ;
+         std::tie(startZ, endZ) = projection.getSlabRange(depth);
+         auto accumulator = projection.createAccumulator(width, height, channels, endZ - startZ + 1);
+         const int batchSize = ThreadPool::shared().getThreadCount();
+         std::vector<ConstImageView> planes;
+         for (int zBegin = startZ; zBegin <= endZ; zBegin += batchSize) {
+             int zEnd = std::min(zBegin + batchSize, endZ + 1);
+             std::vector<SliceCache::SlicePtr> slices = sliceCache->get(zBegin, zEnd);
+             planes.clear();
+             for (const SliceCache::SlicePtr& slice : slices) {
+                 planes.emplace_back(slice->data(), width, height, channels, getYStride(), getXStride());
+             }
+             accumulator->addSlices(planes);
+         }
+         return accumulator->result();
+     }
+     
      // Delegate the projection operation to the Projection object
      return projection.apply(*this);
  }
@@ -368,7 +736,7 @@
                                 std::to_string(x) + "," + std::to_string(y) + ")");
      }
      // Return the pixel from the middle slice (depth/2)
-     return voxels[depth / 2][y][x];
+     return getVoxel(x, y, depth / 2);
  }
  
  // Set a pixel in the middle slice
@@ -378,24 +746,13 @@
                                 std::to_string(x) + "," + std::to_string(y) + ")");
      }
      // Set the pixel in the middle slice (depth/2)
-     voxels[depth / 2][y][x] = pixel;
+     setVoxel(x, y, depth / 2, pixel);
  }
  
  // Create a deep copy of the volume
  std::unique_ptr<DataContainer> Volume::clone() const {
-     // Create a new volume with the same dimensions and name
-     auto copy = std::make_unique<Volume>(width, height, depth, channels, name);
-     
-     // Copy all voxels
-     for (int z = 0; z < depth; ++z) {
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 copy->setVoxel(x, y, z, getVoxel(x, y, z));
-             }
-         }
-     }
-     
-     return copy;
+     // Copy the voxel buffer in one go
+     return std::make_unique<Volume>(*this);
  }
  
  // Save the middle slice to a file (to satisfy DataContainer interface)
@@ -17,6 +17,10 @@
  #define VOLUME_H
  
  #include "DataContainer.h"
+ #include "AlignedAllocator.h"
+ #include "ImageView.h"
+ #include "MappedFile.h"
+ #include <cstddef>
  #include <vector>
  #include <string>
  #include <memory>
@@ -30,6 +34,7 @@
  class Projection;
  class Slice;
  class Image;
+ class SliceCache;
  
  /**
   * @brief Class representing a 3D volume of voxels
@@ -37,15 +42,53 @@
   * The Volume class extends DataContainer to handle 3D data, providing storage
   * and access methods for voxels. Operations like projections, slicing, and
   * filtering are delegated to specialized classes.
+  *
+  * Voxels live in a single contiguous, 64-byte aligned buffer of interleaved 8-bit
+  * samples, storing only getChannels() samples per voxel: a greyscale CT stack costs
+  * one byte per voxel, RGB three and RGBA four. getVoxel() expands the stored samples
+  * into a Pixel the same way image loading does (G and B repeat R, alpha defaults to
+  * 255). The samples of voxel (x, y, z) start at
+  * `x * getXStride() + y * getYStride() + z * getZStride()`, with X fastest and
+  * slices packed back to back. getViewXY(), getViewXZ(), getViewYZ() and getColumnZ()
+  * return non-owning views over that buffer, so planes and Z-columns can be read
+  * without copying.
+  * 
+  * A volume opened with loadFromFilesLazy() has no voxel buffer: slices are decoded
+  * the first time getVoxel(), a Slice or a Projection touches them and are kept in a
+  * bounded SliceCache. The raw accessors and views need every voxel in memory, so
+  * they throw std::logic_error until loadAllSlices() has been called.
   */
  class Volume : public DataContainer {
+ public:
+     using SampleBuffer = std::vector<unsigned char, AlignedAllocator<unsigned char>>;
+ 
  private:
-     std::vector<std::vector<std::vector<Pixel>>> voxels; ///< 3D array of voxels [z][y][x]
+     SampleBuffer voxels; ///< Interleaved voxel samples, [z][y][x][channel]
+     std::shared_ptr<MappedFile> mappedFile; ///< Raw volume file the samples live in instead of `voxels`, if any
+     std::size_t mappedOffset = RAW_HEADER_SIZE; ///< Byte offset of voxel (0, 0, 0) in `mappedFile`
+     std::shared_ptr<SliceCache> sliceCache; ///< Decoded slices of a lazily loaded volume, which has no `voxels`
      int depth; ///< Depth (z-dimension) of the volume
      std::vector<std::string> sliceFilenames; ///< Filenames of the slices that make up the volume
      int channels; ///< Number of color channels in the volume
  
+     static constexpr std::size_t RAW_HEADER_SIZE = 64; ///< Bytes before the samples in a raw volume file
+ 
+     /**
+      * @brief (Re)allocate the voxel buffer for the current dimensions
+      *
+      * Colour samples are zeroed and, for RGBA volumes, alpha is set to 255 so every
+      * voxel matches a default constructed (black, opaque) Pixel.
+      */
+     void allocate();
+ 
+     /**
+      * @brief Throw std::logic_error if the voxels are not all in memory
+      */
+     void requireLoaded() const;
+ 
  public:
+     static constexpr std::size_t DEFAULT_SLICE_CACHE_BYTES = std::size_t(512) << 20; ///< Slice cache budget of a lazy volume
+
      /**
       * @brief Constructor with dimensions
       * 
@@ -91,6 +134,16 @@
      Volume(const std::string& directoryPath, const std::string& extension = "png", 
             const std::string& name = "");
  
+     /**
+      * @brief Copy constructor
+      * 
+      * A copy of a memory-mapped volume gets its own buffer, so the two never share samples.
+      */
+     Volume(const Volume& other);
+     Volume& operator=(const Volume& other);
+     Volume(Volume&& other) = default;
+     Volume& operator=(Volume&& other) = default;
+ 
      /**
       * @brief Destructor
       */
@@ -121,15 +174,176 @@
       */
      bool isInBounds3D(int x, int y, int z) const;
  
+     // *******************************************************************************************
+     // -------------------------------------------------------------------------------------------
+     // RAW VOXEL ACCESS
+     // -------------------------------------------------------------------------------------------
+     // *******************************************************************************************
+ 
+     /**
+      * @brief Byte distance between voxels adjacent along X (equals the channel count)
+      */
+     std::ptrdiff_t getXStride() const;
+ 
+     /**
+      * @brief Byte distance between voxels adjacent along Y (one row of a slice)
+      */
+     std::ptrdiff_t getYStride() const;
+ 
+     /**
+      * @brief Byte distance between voxels adjacent along Z (one full slice)
+      */
+     std::ptrdiff_t getZStride() const;
+ 
+     /**
+      * @brief Get a raw pointer to the first sample of the voxel buffer
+      *
+      * This and the other raw accessors and views below need the whole volume in memory.
+      * 
+      * @return unsigned char* Pointer to voxel (0, 0, 0)
+      * @throws std::logic_error If the volume is lazily loaded (see loadAllSlices())
+      */
+     unsigned char* getData();
+     const unsigned char* getData() const;
+ 
+     /**
+      * @brief Get a raw pointer to the samples of voxel (x, y, z) (no bounds checking)
+      */
+     unsigned char* getVoxelPtr(int x, int y, int z);
+     const unsigned char* getVoxelPtr(int x, int y, int z) const;
+ 
+     /**
+      * @brief View of the XY plane at depth z (width x height, contiguous rows)
+      *
+      * @param z Z-index of the plane
+      * @throws std::out_of_range If z is outside the volume
+      */
+     ImageView getViewXY(int z);
+     ConstImageView getViewXY(int z) const;
+ 
+     /**
+      * @brief View of the XZ plane at row y (width x depth, rows one slice apart)
+      *
+      * @param y Y-index of the plane
+      * @throws std::out_of_range If y is outside the volume
+      */
+     ImageView getViewXZ(int y);
+     ConstImageView getViewXZ(int y) const;
+ 
+     /**
+      * @brief View of the YZ plane at column x (height x depth, strided pixels)
+      *
+      * @param x X-index of the plane
+      * @throws std::out_of_range If x is outside the volume
+      */
+     ImageView getViewYZ(int x);
+     ConstImageView getViewYZ(int x) const;
+ 
+     /**
+      * @brief View of the Z-column at (x, y) as a 1 x depth image
+      *
+      * @param x X-coordinate
+      * @param y Y-coordinate
+      * @throws std::out_of_range If (x, y) is outside the volume
+      */
+     ConstImageView getColumnZ(int x, int y) const;
+ 
+     /**
+      * @brief Read the headers of a series of slice images and check they agree in size
+      * 
+      * Only the image headers are read, concurrently on the shared ThreadPool; no pixel
+      * data is decoded. Problems are reported for the first offending slice in order.
+      * 
+      * @param filenames Slice images, in Z order
+      * @param width Set to the slice width
+      * @param height Set to the slice height
+      * @param channels Set to the channel count of the first slice
+      * @return bool False if the list is empty or a header cannot be read
+      * @throws std::runtime_error If slices have inconsistent dimensions
+      */
+     static bool readSliceHeaders(const std::vector<std::string>& filenames,
+                                  int& width, int& height, int& channels);
+     
+     /**
+      * @brief Decode one slice image into compact interleaved samples
+      * 
+      * Pixels are converted to `channels` samples when the file stores a different count.
+      * 
+      * @param filename Slice image to decode
+      * @param width Expected slice width
+      * @param height Expected slice height
+      * @param channels Samples per pixel to write
+      * @param samples Destination of `width * height * channels` bytes
+      * @return bool False if the file cannot be decoded or is not width x height
+      */
+     static bool decodeSlice(const std::string& filename, int width, int height, int channels,
+                             unsigned char* samples);
+     
      /**
       * @brief Load volume data from a series of image files
       * 
+      * Dimensions are taken from the image headers alone and checked for every slice
+      * before the volume is allocated; the slices are then decoded concurrently on the
+      * shared ThreadPool, each directly into its own Z plane. Slices whose channel count
+      * differs from the first one are converted to it.
+      * 
       * @param filenames Vector of filenames to load slices from
       * @return bool True if loading was successful, false otherwise
       * @throws std::runtime_error If slices have inconsistent dimensions
       */
      bool loadFromFiles(const std::vector<std::string>& filenames);
      
+     /**
+      * @brief Open a series of image files without decoding them
+      * 
+      * Only the image headers are read. Each slice is decoded the first time it is
+      * needed and kept in a least-recently-used cache of at most `cacheBytes` bytes, so
+      * extracting one slice from a large stack decodes only the slices it crosses.
+      * 
+      * @param filenames Vector of filenames to load slices from, in Z order
+      * @param cacheBytes Most bytes of decoded slices to keep at once (at least one
+      *                   slice is always kept)
+      * @return bool True if the headers were read, false otherwise
+      * @throws std::runtime_error If slices have inconsistent dimensions
+      */
+     bool loadFromFilesLazy(const std::vector<std::string>& filenames,
+                            std::size_t cacheBytes = DEFAULT_SLICE_CACHE_BYTES);
+     
+     /**
+      * @brief Check whether the volume was opened with loadFromFilesLazy() and its
+      *        slices have not been loaded since
+      */
+     bool isLazy() const;
+     
+     /**
+      * @brief Decode every slice of a lazy volume into an ordinary voxel buffer
+      * 
+      * Does nothing if the volume is not lazy.
+      * 
+      * @throws std::runtime_error If a slice cannot be decoded
+      */
+     void loadAllSlices();
+     
+     /**
+      * @brief Slice cache of a lazy volume, e.g. to change its budget
+      * 
+      * @return SliceCache* The cache, or nullptr if the volume is not lazy
+      */
+     SliceCache* getSliceCache() const;
+     
+     /**
+      * @brief Keep only the slices firstZ to lastZ (0-based, inclusive)
+      * 
+      * A memory-mapped volume goes on using the file from slice firstZ and a lazy volume
+      * keeps its cache budget, so neither decodes or copies anything; a volume in memory
+      * drops the other slices.
+      * 
+      * @param firstZ First slice to keep
+      * @param lastZ Last slice to keep
+      * @throws std::out_of_range If the range is empty or outside the volume
+      */
+     void cropDepth(int firstZ, int lastZ);
+     
      /**
       * @brief Load volume data from a base path with range of indices
       * 
@@ -172,6 +386,7 @@
       * @param z Z-coordinate
       * @param pixel The pixel to set
       * @throws std::out_of_range If coordinates are out of bounds
+      * @note Loads every slice of a lazy volume first
       */
      void setVoxel(int x, int y, int z, const Pixel& pixel);
  
@@ -184,6 +399,56 @@
       */
      bool saveToFiles(const std::string& baseFilename, const std::string& extension = ".png") const;
  
+     /**
+      * @brief Save the volume in the raw volume format (.apv)
+      * 
+      * The file is a 64-byte header (magic "APVOLUME", format version, width, height,
+      * depth, channels, sample type, data size and a checksum of the samples, all
+      * little-endian) followed by the voxel samples exactly as they are laid out in
+      * memory. Reopening it with loadFromRaw() needs no decoding.
+      * 
+      * @param filename The name of the file to write
+      * @return bool True if the file was written successfully, false otherwise
+      */
+     bool saveToRaw(const std::string& filename) const;
+ 
+     /**
+      * @brief Open a volume saved by saveToRaw()
+      * 
+      * The file is memory-mapped and the samples are used in place, so opening costs the
+      * same whatever the volume size; slices are read from disk the first time they are
+      * accessed. Writes to the volume never reach the file.
+      * 
+      * @param filename The raw volume file
+      * @param verifyChecksum Also check the samples against the stored checksum, which
+      *                       reads the whole file
+      * @return bool True if the volume was opened, false if the file does not exist
+      * @throws std::runtime_error If the file is not a valid raw volume or the checksum
+      *                            does not match
+      */
+     bool loadFromRaw(const std::string& filename, bool verifyChecksum = false);
+ 
+     /**
+      * @brief Save the volume as a bricked, compressed file (.apb)
+      * 
+      * See BrickedVolume for the layout; use BrickedVolume directly to read regions,
+      * slices or slabs without decompressing the whole file.
+      * 
+      * @param filename The name of the file to write
+      * @param brickSize Edge length of a brick in voxels
+      * @return bool True if the file was written successfully, false otherwise
+      */
+     bool saveToBricked(const std::string& filename, int brickSize = 32) const;
+ 
+     /**
+      * @brief Load a whole volume from a bricked file written by saveToBricked()
+      * 
+      * @param filename The bricked volume file
+      * @return bool True if the volume was loaded, false if the file does not exist
+      * @throws std::runtime_error If the file is not a valid bricked volume or is corrupt
+      */
+     bool loadFromBricked(const std::string& filename);
+ 
      /**
       * @brief Save a specific slice of the volume to a file
       * 
@@ -197,7 +462,8 @@
      /**
       * @brief Apply a filter to the volume
       * 
-      * Delegates filtering operation to the VolumeFilter object.
+      * Delegates filtering operation to the VolumeFilter object. A lazy volume is
+      * filtered through a fully loaded copy.
       * 
       * @param filter The volume filter to apply
       * @return std::unique_ptr<Volume> A new volume with the filter applied
@@ -229,6 +495,8 @@
       * - MinIntensityProj for minimum intensity projection
       * - AvgIntensityProj for average intensity projection (with mean or median)
       * 
+      * On a lazy volume only the projection's slab is decoded, a batch of slices at a time.
+      * 
       * @param projection The projection to apply
       * @return Image The resulting 2D projection
       */
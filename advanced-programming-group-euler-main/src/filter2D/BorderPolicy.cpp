@@ -0,0 +1,96 @@
+/**
+ * @file BorderPolicy.cpp
+ * @brief Implementation of the BorderPolicy class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "BorderPolicy.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+BorderPolicy::BorderPolicy(Mode mode) : mode(mode) {}
+
+BorderPolicy::Mode BorderPolicy::getMode() const {
+    return mode;
+}
+
+bool BorderPolicy::padsWithZeros() const {
+    return mode == Mode::ZERO || mode == Mode::RENORMALISE;
+}
+
+// Reflection repeats with a period of 2 * (length - 1), so taps far outside short lines still land inside
+int BorderPolicy::sourceIndex(int i, int length) const {
+    if (i >= 0 && i < length) {
+        return i;
+    }
+    switch (mode) {
+        case Mode::CLAMP:
+            return std::clamp(i, 0, length - 1);
+        case Mode::REFLECT: {
+            if (length == 1) {
+                return 0;
+            }
+            int period = 2 * (length - 1);
+            int folded = std::abs(i) % period;
+            return folded < length ? folded : period - folded;
+        }
+        default:
+            return -1;
+    }
+}
+
+// The row itself is one copy; only the border pixels go through sourceIndex()
+void BorderPolicy::padRow(const unsigned char* src, int width, int channels, int left, int right,
+                          unsigned char* dst) const {
+    auto borderPixel = [&](int p, unsigned char* out) {
+        int index = sourceIndex(p, width);
+        if (index < 0) {
+            std::memset(out, 0, channels);
+        } else {
+            std::memcpy(out, src + index * channels, channels);
+        }
+    };
+    for (int p = -left; p < 0; ++p) {
+        borderPixel(p, dst + (p + left) * channels);
+    }
+    std::memcpy(dst + left * channels, src, static_cast<size_t>(width) * channels);
+    for (int p = width; p < width + right; ++p) {
+        borderPixel(p, dst + (p + left) * channels);
+    }
+}
+
+BorderPolicy::Span BorderPolicy::interior(int length, int before, int after) {
+    int begin = std::min(before, length);
+    return {begin, std::max(length - after, begin)};
+}
+
+std::string BorderPolicy::getName(Mode mode) {
+    switch (mode) {
+        case Mode::CLAMP: return "clamp";
+        case Mode::REFLECT: return "reflect";
+        case Mode::ZERO: return "zero";
+        case Mode::RENORMALISE: return "renormalise";
+    }
+    return "";
+}
+
+BorderPolicy::Mode BorderPolicy::fromName(const std::string& name) {
+    for (Mode mode : {Mode::CLAMP, Mode::REFLECT, Mode::ZERO, Mode::RENORMALISE}) {
+        if (name == getName(mode)) {
+            return mode;
+        }
+    }
+    throw std::invalid_argument("Invalid border mode '" + name + "'. Use 'clamp', 'reflect', 'zero' or 'renormalise'.");
+}
@@ -0,0 +1,112 @@
+/**
+ * @file BorderPolicy.h
+ * @brief Declaration of the BorderPolicy class, how neighbourhood filters read past the image edges
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef BORDER_POLICY_H
+#define BORDER_POLICY_H
+
+#include <string>
+
+/**
+ * @brief Samples a filter reads for taps outside the image, and what it does with them
+ *
+ * Neighbourhood filters resolve the border once instead of on every tap: either they copy
+ * each row into a buffer padded by padRow() (and pick padded rows with sourceIndex()), or
+ * they split every line with interior() into the outputs whose taps all lie inside, which
+ * run a loop without any bounds tests, and the thin border strips on either side, which
+ * handle the missing taps.
+ */
+class BorderPolicy {
+public:
+    /**
+     * @brief Border rules, shown for a row abcd extended by three samples on each side
+     */
+    enum class Mode {
+        CLAMP,       ///< Nearest edge sample: aaa|abcd|ddd
+        REFLECT,     ///< Mirrored about the edge sample, which is not repeated: dcb|abcd|cba
+        ZERO,        ///< Zeros: 000|abcd|000
+        RENORMALISE  ///< Outside taps are dropped and the rest rescaled to the full kernel's weight
+    };
+
+    /**
+     * @brief Outputs [begin, end) of a line whose taps all lie inside it
+     */
+    struct Span {
+        int begin; ///< First interior output
+        int end;   ///< One past the last interior output (end >= begin)
+    };
+
+private:
+    Mode mode; ///< The border rule
+
+public:
+    /**
+     * @brief Policy for one border rule
+     *
+     * @param mode The border rule (clamping by default)
+     */
+    explicit BorderPolicy(Mode mode = Mode::CLAMP);
+
+    Mode getMode() const;
+
+    /**
+     * @brief Whether samples outside the image count as zeros (ZERO and RENORMALISE)
+     */
+    bool padsWithZeros() const;
+
+    /**
+     * @brief Sample read for position i of a line of length samples
+     *
+     * @param i Position, possibly outside [0, length)
+     * @param length Samples in the line (at least 1)
+     * @return int The position read, or -1 for a zero sample
+     */
+    int sourceIndex(int i, int length) const;
+
+    /**
+     * @brief Copy a row with left and right border pixels, so that no tap needs a bounds test
+     *
+     * @param src Input row of width pixels
+     * @param width Pixels in the row
+     * @param channels Samples per pixel
+     * @param left Border pixels before the row
+     * @param right Border pixels after the row
+     * @param dst Receives (left + width + right) * channels samples
+     */
+    void padRow(const unsigned char* src, int width, int channels, int left, int right, unsigned char* dst) const;
+
+    /**
+     * @brief Outputs of a line of length samples whose taps from -before to +after stay inside it
+     *
+     * @param length Samples in the line
+     * @param before Taps before the output sample
+     * @param after Taps after the output sample
+     * @return Span [before, length - after), empty if the line is too short
+     */
+    static Span interior(int length, int before, int after);
+
+    /**
+     * @brief Lowercase name of a border rule, as used on the command line
+     */
+    static std::string getName(Mode mode);
+
+    /**
+     * @brief Border rule from its name ("clamp", "reflect", "zero" or "renormalise")
+     *
+     * @throws std::invalid_argument If the name is not a border rule
+     */
+    static Mode fromName(const std::string& name);
+};
+
+#endif // BORDER_POLICY_H
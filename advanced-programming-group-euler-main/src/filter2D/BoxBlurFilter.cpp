@@ -14,6 +14,12 @@
  */
 
 #include "BoxBlurFilter.h"
+#include "BorderPolicy.h"
+#include "../ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
@@ -50,45 +56,115 @@ BoxBlurFilter::BoxBlurFilter(int kernelSize)
  * value in the output image. The algorithm ensures that edge pixels are handled by considering 
  * only those neighbors that fall within the image bounds.
  * 
+ * The box is separable, so the neighbourhood sum is built from running sums: each row is
+ * summed horizontally by adding the sample entering the window and removing the one leaving
+ * it, and the vertical sum is kept per column by adding the row entering the window and
+ * subtracting the row leaving it. The cost per pixel is therefore independent of kernelSize.
+ * Sums are exact integers and the in-bounds neighbour count is the product of the horizontal
+ * and vertical in-bounds extents, so the truncated average matches the direct computation.
+ * 
  * @param input The input image to be processed.
  * @return Image The blurred output image.
  */
 Image BoxBlurFilter::apply(const Image& input) {
+    Image output(input.getWidth(), input.getHeight(), input.getChannels());
+    RowWindow in(input.getView());
+    MutableRowWindow out(output.getView());
+
+    // Each band of output rows builds its own running sums from the rows above it,
+    // so bands are independent and the result does not depend on the split
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        applyRows(in, out, bandBegin, bandEnd);
+    });
+    return output;
+}
+
+// Output rows depend on the rows within half a kernel of them
+int BoxBlurFilter::getRowHalo() const {
+    return kernelSize / 2;
+}
+
+/**
+ * @brief Blurs rows [rowBegin, rowEnd) with the running sums described in apply().
+ * 
+ * @param input Input rows [rowBegin - kernelSize / 2, rowEnd + kernelSize / 2), clipped to the image.
+ * @param output Output window holding rows [rowBegin, rowEnd).
+ * @param rowBegin First row to blur.
+ * @param rowEnd One past the last row to blur.
+ */
+void BoxBlurFilter::applyRows(const RowWindow& input, const MutableRowWindow& output,
+                              int rowBegin, int rowEnd, double) const {
     int width = input.getWidth();
     int height = input.getHeight();
     int channels = input.getChannels();
-    Image output(width, height, channels);
 
-    int half = kernelSize / 2;
-    // Loop over every pixel in the image
-    for (int y = 0; y < height; y++) {
+    const int half = kernelSize / 2;
+    const int rowSamples = width * channels;
+
+    // Per-thread scratch, grown once and reused by every call
+    static thread_local std::vector<int> columnCount;
+    static thread_local std::vector<std::uint32_t> ring;
+    static thread_local std::vector<std::uint64_t> columnSum;
+
+    // In-bounds horizontal extent of the window centred on each column
+    columnCount.resize(width);
+    for (int x = 0; x < width; x++) {
+        columnCount[x] = std::min(x + half, width - 1) - std::max(x - half, 0) + 1;
+    }
+
+    // Horizontal window sums, row r kept in slot r % kernelSize until it leaves the window.
+    // Interior columns add the entering sample and remove the leaving one; the border
+    // strips are the only columns where one of them falls outside the row.
+    ring.resize(static_cast<size_t>(kernelSize) * rowSamples);
+    const BorderPolicy::Span interior = BorderPolicy::interior(width, half, half);
+    auto sumRow = [&](int r, std::uint32_t* dst) {
+        const unsigned char* src = input.getRow(r);
+        for (int c = 0; c < channels; c++) {
+            std::uint32_t sum = 0;
+            for (int x = 0; x < std::min(half, width); x++) {
+                sum += src[x * channels + c];
+            }
+            for (int x = 0; x < interior.begin; x++) {
+                if (x + half < width) sum += src[(x + half) * channels + c];
+                dst[x * channels + c] = sum;
+            }
+            for (int x = interior.begin; x < interior.end; x++) {
+                sum += src[(x + half) * channels + c];
+                dst[x * channels + c] = sum;
+                sum -= src[(x - half) * channels + c];
+            }
+            for (int x = interior.end; x < width; x++) {
+                dst[x * channels + c] = sum;
+                sum -= src[(x - half) * channels + c];
+            }
+        }
+    };
+
+    // Vertical sums of the horizontal sums over the rows currently in the window
+    columnSum.assign(rowSamples, 0);
+    int topRow = std::max(rowBegin - half, 0);  // First row included in columnSum
+    int nextRow = topRow;                       // Next input row to enter the window
+    for (int y = rowBegin; y < rowEnd; y++) {
+        int first = std::max(y - half, 0);
+        int last = std::min(y + half, height - 1);
+        // Remove leaving rows before adding entering ones: they share ring slots
+        for (; topRow < first; topRow++) {
+            const std::uint32_t* slot = &ring[static_cast<size_t>(topRow % kernelSize) * rowSamples];
+            for (int i = 0; i < rowSamples; i++) columnSum[i] -= slot[i];
+        }
+        for (; nextRow <= last; nextRow++) {
+            std::uint32_t* slot = &ring[static_cast<size_t>(nextRow % kernelSize) * rowSamples];
+            sumRow(nextRow, slot);
+            for (int i = 0; i < rowSamples; i++) columnSum[i] += slot[i];
+        }
+
+        int rowCount = last - first + 1;
+        unsigned char* dst = output.getRow(y);
         for (int x = 0; x < width; x++) {
-            double sumR = 0, sumG = 0, sumB = 0, sumA = 0;
-            int count = 0;
-            // Iterate over the kernel neighborhood
-            for (int j = -half; j <= half; j++) {
-                for (int i = -half; i <= half; i++) {
-                    int nx = x + i;
-                    int ny = y + j;
-                    // Check if within image bounds
-                    if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                        Pixel p = input.getPixel(nx, ny);
-                        sumR += p.getR();
-                        sumG += p.getG();
-                        sumB += p.getB();
-                        sumA += p.getA();
-                        count++;
-                    }
-                }
+            std::uint64_t count = static_cast<std::uint64_t>(columnCount[x]) * rowCount;
+            for (int c = 0; c < channels; c++) {
+                dst[x * channels + c] = static_cast<unsigned char>(columnSum[x * channels + c] / count);
             }
-            // Compute average values and set the pixel in the output image
-            unsigned char r = static_cast<unsigned char>(sumR / count);
-            unsigned char g = static_cast<unsigned char>(sumG / count);
-            unsigned char b = static_cast<unsigned char>(sumB / count);
-            unsigned char a = static_cast<unsigned char>(sumA / count);
-            output.setPixel(x, y, Pixel(r, g, b, a));
         }
     }
-    return output;
 }
-
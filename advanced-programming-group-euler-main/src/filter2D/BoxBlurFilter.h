@@ -54,6 +54,17 @@ public:
      */
     Image apply(const Image& input) override;
 
+    /**
+     * @brief Rows above and below an output row inside the window (kernelSize / 2)
+     */
+    int getRowHalo() const override;
+
+    /**
+     * @brief Blur rows [rowBegin, rowEnd) on the calling thread (see Filter::applyRows)
+     */
+    void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                   int rowBegin, int rowEnd, double globalMaximum = 0) const override;
+
 private:
     int kernelSize;
 };
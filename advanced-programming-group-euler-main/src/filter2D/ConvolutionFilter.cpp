@@ -14,6 +14,16 @@
  */
 
 #include "ConvolutionFilter.h"
+#include "GradientKernels.h"
+#include "../FourierTransform.h"
+#include "../ThreadPool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
 /**
  * @brief Constructor for the ConvolutionFilter class
@@ -23,6 +33,17 @@
 ConvolutionFilter::ConvolutionFilter(const std::string& filterName, int kSize)
     : Filter(filterName), kernelSize(kSize) {}
 
+/**
+ * @brief Construct a filter that convolves images with a kernel
+ * @param filterName A string representing the name of the filter
+ * @param kernel The kernel, floating or fixed point
+ * @param mode How sums become output samples
+ */
+ConvolutionFilter::ConvolutionFilter(const std::string& filterName, const ConvolutionKernel& kernel,
+                                     OutputMode mode)
+    : Filter(filterName), kernelSize(std::max(kernel.getWidth(), kernel.getHeight())),
+      convolutionKernel(kernel), outputMode(mode) {}
+
 /**
  * @brief Virtual destructor for the ConvolutionFilter class
  */
@@ -39,54 +60,1025 @@ ConvolutionFilter::~ConvolutionFilter() = default;
  * @return Image A new Image object containing the convolution results (greyscale)
  */
 Image ConvolutionFilter::applyConvolution(const Image& input, const std::vector<std::vector<int>>& kernel) {
+    // The first channel on its own (a strided view over the samples)
+    Image firstChannel(ConstImageView(input.getRow(0), input.getWidth(), input.getHeight(), 1,
+                                      input.getRowStride(), input.getChannels()));
+    return ConvolutionFilter(name, ConvolutionKernel::fromRows(kernel), OutputMode::ABS_NORMALISE)
+        .apply(firstChannel);
+}
+
+/**
+ * @brief Apply the filter's kernel (or gradient kernels) to an image
+ * @param input Input image
+ * @return Image The convolved image
+ */
+Image ConvolutionFilter::apply(const Image& input) {
+    if (!gradientX.empty()) {
+        return applyGradient(input);
+    }
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    Image output(input.getWidth(), input.getHeight(), input.getChannels());
+    applyInto(input, output);
+    return output;
+}
+
+const std::optional<ConvolutionKernel>& ConvolutionFilter::getKernel() const {
+    return convolutionKernel;
+}
+
+ConvolutionFilter::OutputMode ConvolutionFilter::getOutputMode() const {
+    return outputMode;
+}
+
+/**
+ * @brief Run the kernel as a sum of separable 1D passes when that needs fewer taps
+ * @param tolerance Singular values at or below tolerance * the largest are dropped
+ * @return bool True if the separable terms are used
+ */
+bool ConvolutionFilter::separateKernel(double tolerance) {
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    std::vector<ConvolutionKernel::SeparableTerm> terms = kernel.separate(tolerance);
+    int separableTaps = static_cast<int>(terms.size()) * (kernel.getWidth() + kernel.getHeight());
+    if (terms.empty() || separableTaps >= kernel.getWidth() * kernel.getHeight()) {
+        separableTerms.clear();
+        separationError = 0.0;
+        return false;
+    }
+    separationError = kernel.getSeparationError(terms);
+    separableTerms = std::move(terms);
+    return true;
+}
+
+int ConvolutionFilter::getTapsPerPixel() const {
+    if (!convolutionKernel) {
+        return kernelSize * kernelSize;
+    }
+    int width = convolutionKernel->getWidth();
+    int height = convolutionKernel->getHeight();
+    return separableTerms.empty() ? width * height : static_cast<int>(separableTerms.size()) * (width + height);
+}
+
+double ConvolutionFilter::getSeparationError() const {
+    return separationError;
+}
+
+void ConvolutionFilter::setMethod(Method method) {
+    this->method = method;
+}
+
+ConvolutionFilter::Method ConvolutionFilter::getMethod() const {
+    return method;
+}
+
+/**
+ * @brief Choose the samples the kernel reads outside the image
+ * 
+ * RENORMALISE needs the weight of any rectangle of taps, which a summed-area table of
+ * the weights gives in four lookups.
+ * 
+ * @param mode The border rule
+ */
+void ConvolutionFilter::setBorderMode(BorderPolicy::Mode mode) {
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    border = BorderPolicy(mode);
+    weightTable.clear();
+    if (mode == BorderPolicy::Mode::RENORMALISE) {
+        int width = convolutionKernel->getWidth();
+        int height = convolutionKernel->getHeight();
+        const std::vector<float>& weights = convolutionKernel->getWeights();
+        weightTable.assign(static_cast<size_t>(width + 1) * (height + 1), 0.0);
+        for (int ky = 0; ky < height; ++ky) {
+            for (int kx = 0; kx < width; ++kx) {
+                weightTable[(ky + 1) * (width + 1) + kx + 1] = weights[ky * width + kx]
+                    + weightTable[ky * (width + 1) + kx + 1] + weightTable[(ky + 1) * (width + 1) + kx]
+                    - weightTable[ky * (width + 1) + kx];
+            }
+        }
+    }
+}
+
+BorderPolicy::Mode ConvolutionFilter::getBorderMode() const {
+    return border.getMode();
+}
+
+/**
+ * @brief Whether an image of the given size is filtered through Fourier transforms
+ * @param width Width of the image
+ * @param height Height of the image
+ * @return bool True for FOURIER, or AUTO when the transforms are estimated cheaper
+ */
+bool ConvolutionFilter::usesFourierTransform(int width, int height) const {
+    if (!convolutionKernel || !gradientX.empty() || method == Method::DIRECT) {
+        return false;
+    }
+    if (method == Method::FOURIER) {
+        return true;
+    }
+    return getTapsPerPixel() >= FOURIER_MIN_TAPS &&
+           FourierConvolution::isCheaper(getTapsPerPixel(), width, height, 1,
+                                         convolutionKernel->getWidth(), convolutionKernel->getHeight(), 1);
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// GRADIENT OPERATORS (EDGE DETECTION)
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+/**
+ * @brief Set the kernels of a gradient operator
+ * @param kernelX Horizontal kernel, kernelSize x kernelSize values, row-major
+ * @param kernelY Vertical kernel, kernelSize x kernelSize values, row-major
+ * @param origin Kernel tap (origin, origin) lies on the output pixel
+ */
+void ConvolutionFilter::setGradientKernels(const int* kernelX, const int* kernelY, int origin) {
+    if (kernelSize > MAX_GRADIENT_SIZE) {
+        throw std::invalid_argument(name + " gradient kernels must be at most " +
+                                    std::to_string(MAX_GRADIENT_SIZE) + "x" + std::to_string(MAX_GRADIENT_SIZE));
+    }
+    gradientX.assign(kernelX, kernelX + kernelSize * kernelSize);
+    gradientY.assign(kernelY, kernelY + kernelSize * kernelSize);
+    gradientOrigin = origin;
+}
+
+/**
+ * @brief Rows above and below an output row the kernel reaches
+ * @return The halo, or -1 if the filter has no kernel
+ */
+int ConvolutionFilter::getRowHalo() const {
+    if (!gradientX.empty()) {
+        return std::max(gradientOrigin, kernelSize - 1 - gradientOrigin);
+    }
+    if (convolutionKernel) {
+        // Transforms need the whole image, so kernels that may use them cannot run in strips
+        bool mayUseFourier = method == Method::FOURIER ||
+                             (method == Method::AUTO && getTapsPerPixel() >= FOURIER_MIN_TAPS);
+        return mayUseFourier ? -1 : convolutionKernel->getRowHalo();
+    }
+    return -1;
+}
+
+/**
+ * @brief Edge images are greyscale; other kernels keep the input's channels
+ * @return 1 for gradient kernels, inputChannels otherwise
+ */
+int ConvolutionFilter::getOutputChannels(int inputChannels) const {
+    return gradientX.empty() ? inputChannels : 1;
+}
+
+/**
+ * @brief Gradient magnitudes and ABS_NORMALISE sums are scaled by their maximum over the image
+ * @return True if gradient kernels are set or the output mode is ABS_NORMALISE
+ */
+bool ConvolutionFilter::needsGlobalMaximum() const {
+    return !gradientX.empty() || (convolutionKernel && outputMode == OutputMode::ABS_NORMALISE);
+}
+
+/**
+ * @brief Largest |Gx| + |Gy| the gradient kernels can produce from 8-bit input
+ * @return The bound, (sum of |taps| of both kernels) * 255
+ */
+int ConvolutionFilter::getMagnitudeBound() const {
+    int taps = 0;
+    for (size_t i = 0; i < gradientX.size(); ++i) {
+        taps += std::abs(gradientX[i]) + std::abs(gradientY[i]);
+    }
+    return taps * 255;
+}
+
+/**
+ * @brief Size the ring for a sweep over rows of a given width
+ * @param rowCount Rows the ring holds (the kernel size)
+ * @param width Width of the rows
+ */
+void ConvolutionFilter::GreyscaleRing::reset(int rowCount, int width) {
+    rows.resize(static_cast<size_t>(rowCount) * width);
+    nextRow = 0;
+}
+
+/**
+ * @brief Greyscale rows under each kernel row for output row y, clamped to the image
+ * 
+ * A greyscale input is read in place. Otherwise each input row is converted once, when
+ * the sweep first reaches it, into the slot (row % kernelSize) of the ring, which always
+ * holds the kernelSize most recent rows.
+ * 
+ * @param input Input rows around y, any number of channels
+ * @param y Output row; rows must be visited in increasing order after ring.reset()
+ * @param ring Converted rows of the current sweep
+ * @param rows Receives kernelSize row pointers
+ */
+void ConvolutionFilter::kernelRows(const RowWindow& input, int y, GreyscaleRing& ring,
+                                   const unsigned char** rows) const {
     int width = input.getWidth();
     int height = input.getHeight();
-    Image output(width, height, 1);  // Output as a greyscale image
+    int channels = input.getChannels();
+    int first = std::max(0, y - gradientOrigin);
+    int last = std::min(height - 1, y + kernelSize - 1 - gradientOrigin);
+    if (channels > 1) {
+        // Rows before `first` are no longer needed and are not converted
+        for (int row = std::max(ring.nextRow, first); row <= last; ++row) {
+            Pixel::toGreyscaleRow(input.getRow(row), channels, width,
+                                  &ring.rows[static_cast<size_t>(row % kernelSize) * width]);
+        }
+        ring.nextRow = std::max(ring.nextRow, last + 1);
+    }
+    for (int ky = 0; ky < kernelSize; ++ky) {
+        int row = std::max(first, std::min(last, y + ky - gradientOrigin));
+        rows[ky] = (channels > 1) ? &ring.rows[static_cast<size_t>(row % kernelSize) * width]
+                                  : input.getRow(row);
+    }
+}
+
+/**
+ * @brief Gradient magnitudes |Gx| + |Gy| of one row of a greyscale image
+ * 
+ * Neighbours outside the image are clamped to the nearest edge pixel. The columns in
+ * the interior, whose taps all lie inside the row, go straight through GradientKernels,
+ * which uses SIMD instructions where the CPU has them; the few columns at either edge
+ * are handled by gradientBorder().
+ * 
+ * @param rows Greyscale row under each kernel row (see kernelRows())
+ * @param width Width of the rows
+ * @param magnitudes Receives one magnitude per pixel of the row
+ */
+void ConvolutionFilter::gradientRow(const unsigned char* const* rows, int width, int* magnitudes) const {
+    BorderPolicy::Span interior = BorderPolicy::interior(width, gradientOrigin, kernelSize - 1 - gradientOrigin);
+    GradientKernels::gradientSpan(rows, kernelSize, gradientOrigin, gradientX.data(),
+                                  gradientY.data(), interior.begin, interior.end, magnitudes);
+    gradientBorder(rows, width, 0, interior.begin, magnitudes);
+    gradientBorder(rows, width, interior.end, width, magnitudes);
+}
 
-    // Calculate kernel offset (assumes square kernel)
-    int kOffset = kernel.size() / 2;
-    int maxVal = 0;
+/**
+ * @brief Gradient magnitudes of the columns [xBegin, xEnd) whose taps reach past an edge
+ * @param rows Greyscale row under each kernel row
+ * @param width Width of the rows
+ * @param xBegin First column
+ * @param xEnd One past the last column
+ * @param magnitudes Receives the magnitude of column x at magnitudes[x]
+ */
+void ConvolutionFilter::gradientBorder(const unsigned char* const* rows, int width, int xBegin, int xEnd,
+                                       int* magnitudes) const {
+    if (xBegin >= xEnd) {
+        return;
+    }
+    const BorderPolicy clamp(BorderPolicy::Mode::CLAMP);
+    // Strip column p holds image column xBegin - origin + p, for every column the taps reach
+    const int stripWidth = xEnd - xBegin + kernelSize - 1;
+    static thread_local std::vector<unsigned char> strip;
+    static thread_local std::vector<int> stripMagnitudes;
+    strip.resize(static_cast<size_t>(kernelSize) * stripWidth);
+    stripMagnitudes.resize(stripWidth);
+    const unsigned char* stripRows[MAX_GRADIENT_SIZE];
+    for (int ky = 0; ky < kernelSize; ++ky) {
+        unsigned char* dst = &strip[static_cast<size_t>(ky) * stripWidth];
+        for (int p = 0; p < stripWidth; ++p) {
+            dst[p] = rows[ky][clamp.sourceIndex(xBegin - gradientOrigin + p, width)];
+        }
+        stripRows[ky] = dst;
+    }
+    GradientKernels::gradientSpan(stripRows, kernelSize, gradientOrigin, gradientX.data(), gradientY.data(),
+                                  gradientOrigin, gradientOrigin + xEnd - xBegin, stripMagnitudes.data());
+    std::copy_n(&stripMagnitudes[gradientOrigin], xEnd - xBegin, magnitudes + xBegin);
+}
 
-    // Temporary storage for convolution results
-    std::vector<std::vector<int>> convResult(height, std::vector<int>(width, 0));
+/**
+ * @brief Largest gradient magnitude (or |sum| of the kernel) over rows [rowBegin, rowEnd)
+ * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+ * @param rowBegin First row to evaluate
+ * @param rowEnd One past the last row to evaluate
+ * @return The largest magnitude
+ */
+double ConvolutionFilter::computeRowsMaximum(const RowWindow& input, int rowBegin, int rowEnd) const {
+    if (gradientX.empty()) {
+        return computeKernelRowsMaximum(input, rowBegin, rowEnd);
+    }
+    // Per-thread scratch, grown once and reused by every strip
+    static thread_local GreyscaleRing ring;
+    static thread_local std::vector<int> magnitudes;
+    const unsigned char* rows[MAX_GRADIENT_SIZE];
+    ring.reset(kernelSize, input.getWidth());
+    magnitudes.resize(input.getWidth());
+    int maximum = 0;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        kernelRows(input, y, ring, rows);
+        gradientRow(rows, input.getWidth(), magnitudes.data());
+        for (int magnitude : magnitudes) {
+            maximum = std::max(maximum, magnitude);
+        }
+    }
+    return maximum;
+}
 
-    // Perform convolution
-    for (int y = 0; y < height; ++y) {
+/**
+ * @brief Filtered rows [rowBegin, rowEnd); edge images are normalised by a precomputed maximum
+ * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+ * @param output Greyscale output window holding rows [rowBegin, rowEnd)
+ * @param rowBegin First row to filter
+ * @param rowEnd One past the last row to filter
+ * @param globalMaximum Largest computeRowsMaximum() over the whole image
+ */
+void ConvolutionFilter::applyRows(const RowWindow& input, const MutableRowWindow& output,
+                                  int rowBegin, int rowEnd, double globalMaximum) const {
+    if (gradientX.empty()) {
+        applyKernelRows(input, output, rowBegin, rowEnd, globalMaximum);
+        return;
+    }
+    // Per-thread scratch, grown once and reused by every strip
+    static thread_local GreyscaleRing ring;
+    static thread_local std::vector<int> magnitudes;
+    const unsigned char* rows[MAX_GRADIENT_SIZE];
+    const int maximum = static_cast<int>(globalMaximum); // Magnitudes are integers
+    int width = input.getWidth();
+    ring.reset(kernelSize, width);
+    magnitudes.resize(width);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        kernelRows(input, y, ring, rows);
+        gradientRow(rows, width, magnitudes.data());
+        unsigned char* dst = output.getRow(y);
         for (int x = 0; x < width; ++x) {
-            int sum = 0;
-            for (int ky = 0; ky < static_cast<int>(kernel.size()); ++ky) {
-                for (int kx = 0; kx < static_cast<int>(kernel[ky].size()); ++kx) {
-                    // Compute neighbor coordinates
-                    int ix = x + kx - kOffset;
-                    int iy = y + ky - kOffset;
+            dst[x] = maximum > 0
+                ? static_cast<unsigned char>((magnitudes[x] * 255) / maximum) : 0;
+        }
+    }
+}
+
+/**
+ * @brief Edge detection with the gradient kernels
+ * @param input Input image
+ * @return Image Greyscale edge image
+ */
+Image ConvolutionFilter::applyGradient(const Image& input) {
+    Image output(input.getWidth(), input.getHeight(), 1);  // Output is a greyscale edge image
+    applyInto(input, output);
+    return output;
+}
+
+/**
+ * @brief Edge detection with the gradient kernels into an existing image
+ * 
+ * A single sweep converts each input row to greyscale as the kernels reach it, computes
+ * the magnitudes and keeps them for the normalisation, in 16 bits when the kernels'
+ * magnitudes fit (every built-in operator) or 32 bits otherwise. Bands of rows are swept
+ * in parallel, each tracking its own maximum; a second pass then maps every magnitude to
+ * its output value, through a table when the magnitudes are 16-bit.
+ * 
+ * @param input Input image
+ * @param output Receives the greyscale edge image
+ */
+void ConvolutionFilter::applyInto(const Image& input, Image& output) {
+    if (gradientX.empty()) {
+        if (usesFourierTransform(input.getWidth(), input.getHeight())) {
+            applyFourier(input, output);
+        } else if (convolutionKernel) {
+            applyStrips(input, output);
+        } else {
+            Filter::applyInto(input, output);
+        }
+        return;
+    }
+    int width = input.getWidth();
+    int height = input.getHeight();
+    ThreadPool& pool = ThreadPool::shared();
+    const RowWindow source(input.getView());
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    const bool compact = getMagnitudeBound() <= std::numeric_limits<std::uint16_t>::max();
+    if (compact) {
+        compactMagnitudes.resize(pixelCount);
+    } else {
+        magnitudeBuffer.resize(pixelCount);
+    }
 
-                    // Boundary handling: clamp to valid range
-                    ix = std::max(0, std::min(width - 1, ix));
-                    iy = std::max(0, std::min(height - 1, iy));
+    int maxGradient = 0;
+    std::mutex maxMutex; // Guards maxGradient while the bands merge their maxima
 
-                    // Get the pixel intensity (assuming greyscale)
-                    unsigned char pixel = input.getPixel(ix, iy).getR();
-                    sum += pixel * kernel[ky][kx];
+    pool.parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        // Per-thread scratch, grown once and reused by every band
+        static thread_local GreyscaleRing ring;
+        static thread_local std::vector<int> magnitudes;
+        const unsigned char* rows[MAX_GRADIENT_SIZE];
+        ring.reset(kernelSize, width);
+        magnitudes.resize(width);
+        int bandMax = 0;
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            kernelRows(source, y, ring, rows);
+            gradientRow(rows, width, magnitudes.data());
+            const size_t rowStart = static_cast<size_t>(y) * width;
+            if (compact) {
+                std::uint16_t* dst = &compactMagnitudes[rowStart];
+                for (int x = 0; x < width; ++x) {
+                    bandMax = std::max(bandMax, magnitudes[x]);
+                    dst[x] = static_cast<std::uint16_t>(magnitudes[x]);
+                }
+            } else {
+                int* dst = &magnitudeBuffer[rowStart];
+                for (int x = 0; x < width; ++x) {
+                    bandMax = std::max(bandMax, magnitudes[x]);
+                    dst[x] = magnitudes[x];
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(maxMutex);
+        maxGradient = std::max(maxGradient, bandMax);
+    });
+
+    // Normalize gradient values to [0, 255]
+    if (compact) {
+        normaliseTable.resize(static_cast<size_t>(maxGradient) + 1);
+        for (int magnitude = 0; magnitude <= maxGradient; ++magnitude) {
+            normaliseTable[magnitude] = maxGradient > 0
+                ? static_cast<unsigned char>((magnitude * 255) / maxGradient) : 0;
+        }
+    }
+    output.reshape(width, height, 1);
+    pool.parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            const size_t rowStart = static_cast<size_t>(y) * width;
+            unsigned char* dst = output.getRow(y);
+            if (compact) {
+                const std::uint16_t* magnitudes = &compactMagnitudes[rowStart];
+                for (int x = 0; x < width; ++x) {
+                    dst[x] = normaliseTable[magnitudes[x]];
+                }
+            } else {
+                const int* magnitudes = &magnitudeBuffer[rowStart];
+                for (int x = 0; x < width; ++x) {
+                    dst[x] = maxGradient > 0
+                        ? static_cast<unsigned char>((magnitudes[x] * 255) / maxGradient) : 0;
                 }
             }
-            convResult[y][x] = sum;
-            if (std::abs(sum) > maxVal) {
-                maxVal = std::abs(sum);
+        }
+    });
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// GENERAL CONVOLUTION
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+namespace {
+    // Sum of a KxK kernel's taps, expanded at compile time in row-major order
+    template <int K, typename Weight, int... Taps>
+    Weight sumTaps(const unsigned char* const* rows, int offset, int step, const Weight* weights,
+                   std::integer_sequence<int, Taps...>) {
+        return (Weight(0) + ... + static_cast<Weight>(rows[Taps / K][offset + (Taps % K) * step] * weights[Taps]));
+    }
+
+    template <int K, typename Weight>
+    void sumRowUnrolled(const unsigned char* const* rows, int width, int channels, int convolved,
+                        const Weight* weights, Weight* sums) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < convolved; ++c) {
+                int offset = x * channels + c;
+                sums[offset] = sumTaps<K>(rows, offset, channels, weights, std::make_integer_sequence<int, K * K>{});
             }
         }
     }
 
-    // Normalize results to [0, 255]
-    for (int y = 0; y < height; ++y) {
+    // Any kernel size, summed in the same order as the unrolled version
+    template <typename Weight>
+    void sumRowGeneric(const unsigned char* const* rows, int kernelWidth, int kernelHeight, int width,
+                       int channels, int convolved, const Weight* weights, Weight* sums) {
         for (int x = 0; x < width; ++x) {
-            unsigned char normVal = 0;
-            if (maxVal > 0) {
-                normVal = static_cast<unsigned char>((std::abs(convResult[y][x]) * 255) / maxVal);
+            for (int c = 0; c < convolved; ++c) {
+                int offset = x * channels + c;
+                Weight sum = 0;
+                for (int ky = 0; ky < kernelHeight; ++ky) {
+                    const unsigned char* row = rows[ky] + offset;
+                    for (int kx = 0; kx < kernelWidth; ++kx) {
+                        sum += static_cast<Weight>(row[kx * channels] * weights[ky * kernelWidth + kx]);
+                    }
+                }
+                sums[offset] = sum;
             }
-            Pixel p(normVal, normVal, normVal);
-            output.setPixel(x, y, p);
         }
     }
 
-    return output;
+    // Channels that are convolved: all but the alpha of a 4-channel image
+    int getConvolvedChannels(int channels) {
+        return channels == 4 ? 3 : channels;
+    }
+}
+
+/**
+ * @brief Size the ring for a sweep
+ * @param rowCount Rows the ring holds (the kernel height)
+ * @param paddedBytes Bytes per padded row
+ */
+void ConvolutionFilter::PaddedRing::reset(int rowCount, int paddedBytes) {
+    rowBytes = paddedBytes;
+    rows.resize(static_cast<size_t>(rowCount) * paddedBytes);
+    nextRow = std::numeric_limits<int>::min();
+}
+
+/**
+ * @brief Padded rows under each kernel row for output row y, following the border policy
+ * 
+ * The kernel rows of output row y lie over rows y - originY to y - originY + height - 1,
+ * which may reach past the top or bottom of the image. Each of these rows is built once,
+ * when the sweep first reaches it: the input row the policy picks (or zeros), with
+ * originX border pixels before it and (width - 1 - originX) after it, so output pixel x
+ * reads padded pixels x to x + width - 1 without any bounds test.
+ * 
+ * @param input Input rows around y
+ * @param y Output row; rows must be visited in increasing order after ring.reset()
+ * @param ring Padded rows of the current sweep
+ * @param rows Receives one row pointer per kernel row
+ */
+void ConvolutionFilter::paddedRows(const RowWindow& input, int y, PaddedRing& ring,
+                                   const unsigned char** rows) const {
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    int width = input.getWidth();
+    int channels = input.getChannels();
+    int kernelHeight = kernel.getHeight();
+    int left = kernel.getOriginX();
+    int right = kernel.getWidth() - 1 - left;
+    int top = y - kernel.getOriginY();  // Row under the first kernel row
+    auto slot = [&](int row) {
+        return &ring.rows[static_cast<size_t>(((row % kernelHeight) + kernelHeight) % kernelHeight) * ring.rowBytes];
+    };
+
+    for (int row = std::max(ring.nextRow, top); row < top + kernelHeight; ++row) {
+        int source = border.sourceIndex(row, input.getHeight());
+        if (source < 0) {
+            std::memset(slot(row), 0, ring.rowBytes);
+        } else {
+            border.padRow(input.getRow(source), width, channels, left, right, slot(row));
+        }
+    }
+    ring.nextRow = std::max(ring.nextRow, top + kernelHeight);
+
+    for (int ky = 0; ky < kernelHeight; ++ky) {
+        rows[ky] = slot(top + ky);
+    }
+}
+
+/**
+ * @brief Kernel sums of one output row; 3x3, 5x5 and 7x7 kernels use the unrolled loops
+ * @param rows Padded row under each kernel row
+ * @param width Width of the image
+ * @param channels Channels of the image
+ * @param weights Kernel weights (fixed point or float)
+ * @param sums Receives width * channels sums (alpha samples are left unset)
+ */
+template <typename Weight>
+void ConvolutionFilter::kernelRowSums(const unsigned char* const* rows, int width, int channels,
+                                     const Weight* weights, Weight* sums) const {
+    int kernelWidth = convolutionKernel->getWidth();
+    int kernelHeight = convolutionKernel->getHeight();
+    int convolved = getConvolvedChannels(channels);
+    if (kernelWidth == kernelHeight) {
+        switch (kernelWidth) {
+            case 3: sumRowUnrolled<3>(rows, width, channels, convolved, weights, sums); return;
+            case 5: sumRowUnrolled<5>(rows, width, channels, convolved, weights, sums); return;
+            case 7: sumRowUnrolled<7>(rows, width, channels, convolved, weights, sums); return;
+            default: break;
+        }
+    }
+    sumRowGeneric(rows, kernelWidth, kernelHeight, width, channels, convolved, weights, sums);
+}
+
+/**
+ * @brief Sums of one output row as a sum of separable terms (see separateKernel())
+ * 
+ * Each term is a vertical pass over the padded rows followed by a horizontal pass over
+ * the result, so a term costs kernel width + height taps per sample.
+ * 
+ * @param rows Padded row under each kernel row
+ * @param width Width of the image
+ * @param channels Channels of the image
+ * @param sums Receives width * channels sums (alpha samples are left unset)
+ */
+void ConvolutionFilter::separableRowSums(const unsigned char* const* rows, int width, int channels,
+                                         float* sums) const {
+    int kernelWidth = convolutionKernel->getWidth();
+    int kernelHeight = convolutionKernel->getHeight();
+    int convolved = getConvolvedChannels(channels);
+    int paddedWidth = width + kernelWidth - 1;
+
+    static thread_local std::vector<float> columnSums;
+    columnSums.resize(static_cast<size_t>(paddedWidth) * channels);
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < convolved; ++c) {
+            sums[x * channels + c] = 0.0f;
+        }
+    }
+
+    for (const ConvolutionKernel::SeparableTerm& term : separableTerms) {
+        for (int px = 0; px < paddedWidth; ++px) {
+            for (int c = 0; c < convolved; ++c) {
+                int offset = px * channels + c;
+                float sum = 0.0f;
+                for (int ky = 0; ky < kernelHeight; ++ky) {
+                    sum += rows[ky][offset] * term.column[ky];
+                }
+                columnSums[offset] = sum;
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < convolved; ++c) {
+                const float* column = &columnSums[x * channels + c];
+                float sum = 0.0f;
+                for (int kx = 0; kx < kernelWidth; ++kx) {
+                    sum += column[kx * channels] * term.row[kx];
+                }
+                sums[x * channels + c] += sum;
+            }
+        }
+    }
+}
+
+// Fixed point kernels give integer sums, unless they run as separable terms or are rescaled
+bool ConvolutionFilter::sumsInIntegers() const {
+    return convolutionKernel->isFixedPoint() && separableTerms.empty() &&
+           border.getMode() != BorderPolicy::Mode::RENORMALISE;
+}
+
+/**
+ * @brief Sums of output row y, into fixedSums if sumsInIntegers(), else into floatSums
+ * @param rows Padded row under each kernel row
+ * @param y Output row
+ * @param width Width of the image
+ * @param height Height of the image
+ * @param channels Channels of the image
+ * @param fixedSums Receives the integer sums
+ * @param floatSums Receives the float sums
+ */
+void ConvolutionFilter::rowSums(const unsigned char* const* rows, int y, int width, int height, int channels,
+                                int* fixedSums, float* floatSums) const {
+    if (!separableTerms.empty()) {
+        separableRowSums(rows, width, channels, floatSums);
+    } else if (sumsInIntegers()) {
+        kernelRowSums(rows, width, channels, convolutionKernel->getFixedWeights().data(), fixedSums);
+    } else {
+        kernelRowSums(rows, width, channels, convolutionKernel->getWeights().data(), floatSums);
+    }
+    if (border.getMode() == BorderPolicy::Mode::RENORMALISE) {
+        renormaliseRow(y, width, height, channels, floatSums);
+    }
+}
+
+/**
+ * @brief RENORMALISE: rescale the sums of row y's pixels whose taps reach past an edge
+ * 
+ * Zero padding left the sum of the in-bounds taps; it is multiplied by the kernel's
+ * total weight over the weight of those taps. Only rows near the top and bottom and the
+ * columns near the left and right edges are visited; the interior is left as it is.
+ * 
+ * @param y Output row
+ * @param width Width of the image
+ * @param height Height of the image
+ * @param channels Channels of the image
+ * @param sums width * channels float sums of row y
+ */
+void ConvolutionFilter::renormaliseRow(int y, int width, int height, int channels, float* sums) const {
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    const int kernelWidth = kernel.getWidth();
+    const int kernelHeight = kernel.getHeight();
+    const int originX = kernel.getOriginX();
+    const int originY = kernel.getOriginY();
+    const int convolved = getConvolvedChannels(channels);
+    const int tableWidth = kernelWidth + 1;
+    const double total = weightTable.back();
+    if (total == 0.0) {
+        return;
+    }
+
+    // Kernel rows [rowBegin, rowEnd) fall inside the image
+    const int rowBegin = std::max(0, originY - y);
+    const int rowEnd = std::min(kernelHeight, height + originY - y);
+    const bool borderRow = rowBegin > 0 || rowEnd < kernelHeight;
+    BorderPolicy::Span interior = borderRow ? BorderPolicy::Span{width, width}
+                                            : BorderPolicy::interior(width, originX, kernelWidth - 1 - originX);
+    auto rescale = [&](int x) {
+        int columnBegin = std::max(0, originX - x);
+        int columnEnd = std::min(kernelWidth, width + originX - x);
+        double inBounds = weightTable[rowEnd * tableWidth + columnEnd] - weightTable[rowBegin * tableWidth + columnEnd]
+                        - weightTable[rowEnd * tableWidth + columnBegin] + weightTable[rowBegin * tableWidth + columnBegin];
+        if (inBounds == 0.0) {
+            return;
+        }
+        float factor = static_cast<float>(total / inBounds);
+        for (int c = 0; c < convolved; ++c) {
+            sums[x * channels + c] *= factor;
+        }
+    };
+    for (int x = 0; x < interior.begin; ++x) {
+        rescale(x);
+    }
+    for (int x = interior.end; x < width; ++x) {
+        rescale(x);
+    }
+}
+
+/**
+ * @brief Convolve rows [rowBegin, rowEnd) with the kernel and write them in the output mode
+ * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+ * @param output Output window holding rows [rowBegin, rowEnd)
+ * @param rowBegin First row to filter
+ * @param rowEnd One past the last row to filter
+ * @param globalMaximum Largest computeRowsMaximum() over the image (ABS_NORMALISE only)
+ */
+void ConvolutionFilter::applyKernelRows(const RowWindow& input, const MutableRowWindow& output,
+                                        int rowBegin, int rowEnd, double globalMaximum) const {
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    int width = input.getWidth();
+    int channels = input.getChannels();
+    int convolved = getConvolvedChannels(channels);
+    const bool fixedPoint = sumsInIntegers();
+    const int fractionBits = kernel.getFractionBits();
+    const int half = fractionBits > 0 ? 1 << (fractionBits - 1) : 0;  // Rounds fixed point sums
+    const long long fixedMaximum = static_cast<long long>(globalMaximum); // Largest |sum| of integer sums
+    const float floatMaximum = static_cast<float>(globalMaximum);          // Largest |sum| of float sums
+
+    // Per-thread scratch, grown once and reused by every strip
+    static thread_local PaddedRing ring;
+    static thread_local std::vector<const unsigned char*> rows;
+    static thread_local std::vector<int> fixedSums;
+    static thread_local std::vector<float> floatSums;
+    ring.reset(kernel.getHeight(), (width + kernel.getWidth() - 1) * channels);
+    rows.resize(kernel.getHeight());
+    (fixedPoint ? fixedSums.resize(static_cast<size_t>(width) * channels)
+                : floatSums.resize(static_cast<size_t>(width) * channels));
+
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        paddedRows(input, y, ring, rows.data());
+        const unsigned char* src = input.getRow(y);
+        unsigned char* dst = output.getRow(y);
+        rowSums(rows.data(), y, width, input.getHeight(), channels, fixedSums.data(), floatSums.data());
+        if (!fixedPoint) {
+            storeFloatRow(floatSums.data(), src, dst, width, channels, floatMaximum);
+            continue;
+        }
+
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < convolved; ++c) {
+                int i = x * channels + c;
+                switch (outputMode) {
+                    case OutputMode::CLAMP:
+                        dst[i] = static_cast<unsigned char>(std::clamp((fixedSums[i] + half) >> fractionBits, 0, 255));
+                        break;
+                    case OutputMode::ABS_NORMALISE:
+                        dst[i] = fixedMaximum > 0
+                            ? static_cast<unsigned char>((std::abs(fixedSums[i]) * 255LL) / fixedMaximum) : 0;
+                        break;
+                    case OutputMode::SIGNED_FLOAT: {
+                        float value = std::ldexp(static_cast<float>(fixedSums[i]), -fractionBits);
+                        dst[i] = static_cast<unsigned char>(std::clamp(128.0f + value, 0.0f, 255.0f) + 0.5f);
+                        break;
+                    }
+                }
+            }
+            if (channels == 4) {
+                dst[x * 4 + 3] = src[x * 4 + 3];  // Preserve alpha
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write one row of float sums in the output mode, copying alpha
+ * @param sums width * channels sums
+ * @param src Input row
+ * @param dst Output row
+ * @param width Width of the image
+ * @param channels Channels of the image
+ * @param maximum Largest |sum| over the image (ABS_NORMALISE only)
+ */
+void ConvolutionFilter::storeFloatRow(const float* sums, const unsigned char* src, unsigned char* dst,
+                                      int width, int channels, float maximum) const {
+    int convolved = getConvolvedChannels(channels);
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < convolved; ++c) {
+            int i = x * channels + c;
+            switch (outputMode) {
+                case OutputMode::CLAMP:
+                    dst[i] = static_cast<unsigned char>(std::clamp(sums[i], 0.0f, 255.0f) + 0.5f);
+                    break;
+                case OutputMode::ABS_NORMALISE:
+                    dst[i] = maximum > 0.0f ? static_cast<unsigned char>(std::abs(sums[i]) * 255.0f / maximum) : 0;
+                    break;
+                case OutputMode::SIGNED_FLOAT:
+                    dst[i] = static_cast<unsigned char>(std::clamp(128.0f + sums[i], 0.0f, 255.0f) + 0.5f);
+                    break;
+            }
+        }
+        if (channels == 4) {
+            dst[x * 4 + 3] = src[x * 4 + 3];  // Preserve alpha
+        }
+    }
+}
+
+/**
+ * @brief Largest |sum| over rows [rowBegin, rowEnd)
+ * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+ * @param rowBegin First row to evaluate
+ * @param rowEnd One past the last row to evaluate
+ * @return The largest |sum|
+ */
+double ConvolutionFilter::computeKernelRowsMaximum(const RowWindow& input, int rowBegin, int rowEnd) const {
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    int width = input.getWidth();
+    int channels = input.getChannels();
+    int convolved = getConvolvedChannels(channels);
+
+    // Per-thread scratch, grown once and reused by every strip
+    static thread_local PaddedRing ring;
+    static thread_local std::vector<const unsigned char*> rows;
+    static thread_local std::vector<int> fixedSums;
+    static thread_local std::vector<float> floatSums;
+    ring.reset(kernel.getHeight(), (width + kernel.getWidth() - 1) * channels);
+    rows.resize(kernel.getHeight());
+
+    const bool integerSums = sumsInIntegers();
+    (integerSums ? fixedSums.resize(static_cast<size_t>(width) * channels)
+                 : floatSums.resize(static_cast<size_t>(width) * channels));
+
+    int fixedMaximum = 0;
+    float floatMaximum = 0.0f;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        paddedRows(input, y, ring, rows.data());
+        rowSums(rows.data(), y, width, input.getHeight(), channels, fixedSums.data(), floatSums.data());
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < convolved; ++c) {
+                if (integerSums) {
+                    fixedMaximum = std::max(fixedMaximum, std::abs(fixedSums[x * channels + c]));
+                } else {
+                    floatMaximum = std::max(floatMaximum, std::abs(floatSums[x * channels + c]));
+                }
+            }
+        }
+    }
+    return integerSums ? fixedMaximum : floatMaximum;
+}
+
+/**
+ * @brief Signed kernel sums of every sample, whatever the output mode
+ * @param input Input image
+ * @return std::vector<float> One value per sample; the alpha of a 4-channel image is copied
+ */
+std::vector<float> ConvolutionFilter::applySigned(const Image& input) const {
+    if (!convolutionKernel) {
+        throw std::logic_error(name + " filter has no kernel");
+    }
+    if (usesFourierTransform(input.getWidth(), input.getHeight())) {
+        return fourierSums(input);
+    }
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    int width = input.getWidth();
+    int channels = input.getChannels();
+    int convolved = getConvolvedChannels(channels);
+    const size_t rowSamples = static_cast<size_t>(width) * channels;
+    std::vector<float> result(rowSamples * input.getHeight());
+    const RowWindow source(input.getView());
+
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        PaddedRing ring;
+        std::vector<const unsigned char*> rows(kernel.getHeight());
+        std::vector<int> fixedSums(rowSamples);
+        ring.reset(kernel.getHeight(), (width + kernel.getWidth() - 1) * channels);
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            paddedRows(source, y, ring, rows.data());
+            float* dst = &result[rowSamples * y];
+            rowSums(rows.data(), y, width, input.getHeight(), channels, fixedSums.data(), dst);
+            if (sumsInIntegers()) {
+                for (size_t i = 0; i < rowSamples; ++i) {
+                    dst[i] = std::ldexp(static_cast<float>(fixedSums[i]), -kernel.getFractionBits());
+                }
+            }
+            if (channels != convolved) {
+                const unsigned char* src = input.getRow(y);
+                for (int x = 0; x < width; ++x) {
+                    dst[x * channels + 3] = src[x * channels + 3];
+                }
+            }
+        }
+    });
+    return result;
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// FOURIER TRANSFORMS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+/**
+ * @brief Kernel sums of every sample through Fourier transforms
+ * 
+ * Each convolved channel is correlated on its own. The grid rows are filled from the
+ * image like the padded rows of the direct path, following the border policy, and
+ * RENORMALISE rescales the border sums afterwards; a kernel with a single separable
+ * term only keeps its 1D spectra.
+ * 
+ * @param input Input image
+ * @return std::vector<float> One value per sample; the alpha of a 4-channel image is copied
+ */
+std::vector<float> ConvolutionFilter::fourierSums(const Image& input) const {
+    const ConvolutionKernel& kernel = *convolutionKernel;
+    int width = input.getWidth();
+    int height = input.getHeight();
+    int channels = input.getChannels();
+    int convolved = getConvolvedChannels(channels);
+    int originX = kernel.getOriginX();
+    int originY = kernel.getOriginY();
+    std::vector<float> result(static_cast<size_t>(width) * height * channels);
+
+    std::optional<FourierConvolution> convolution;
+    if (separableTerms.size() == 1) {
+        convolution.emplace(width, height, 1, separableTerms.front().row, separableTerms.front().column,
+                            std::vector<float>{1.0f});
+    } else {
+        convolution.emplace(width, height, 1, kernel.getWeights(), kernel.getWidth(), kernel.getHeight(), 1);
+    }
+    int gridWidth = convolution->getGridWidth();
+
+    for (int c = 0; c < convolved; ++c) {
+        convolution->correlate(
+            [&](int y, int, float* row) {
+                int source = border.sourceIndex(y - originY, height);
+                if (source < 0) {
+                    std::fill(row, row + gridWidth, 0.0f);
+                    return;
+                }
+                const unsigned char* src = input.getRow(source);
+                auto borderSample = [&](int x) {
+                    int index = border.sourceIndex(x, width);
+                    return index < 0 ? 0.0f : static_cast<float>(src[index * channels + c]);
+                };
+                for (int px = 0; px < originX; ++px) {
+                    row[px] = borderSample(px - originX);
+                }
+                for (int x = 0; x < width; ++x) {
+                    row[x + originX] = src[x * channels + c];
+                }
+                for (int px = width + originX; px < gridWidth; ++px) {
+                    row[px] = borderSample(px - originX);
+                }
+            },
+            [&](int y, int, const float* row) {
+                float* dst = &result[static_cast<size_t>(y) * width * channels];
+                for (int x = 0; x < width; ++x) {
+                    dst[x * channels + c] = row[x];
+                }
+            });
+    }
+    if (border.getMode() == BorderPolicy::Mode::RENORMALISE) {
+        for (int y = 0; y < height; ++y) {
+            renormaliseRow(y, width, height, channels, &result[static_cast<size_t>(y) * width * channels]);
+        }
+    }
+    if (channels != convolved) {
+        for (int y = 0; y < height; ++y) {
+            const unsigned char* src = input.getRow(y);
+            float* dst = &result[static_cast<size_t>(y) * width * channels];
+            for (int x = 0; x < width; ++x) {
+                dst[x * channels + 3] = src[x * channels + 3];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Convolve the whole image through Fourier transforms and write it in the output mode
+ * @param input Input image
+ * @param output Receives the result; must not be `input`
+ */
+void ConvolutionFilter::applyFourier(const Image& input, Image& output) const {
+    int width = input.getWidth();
+    int channels = input.getChannels();
+    int convolved = getConvolvedChannels(channels);
+    const size_t rowSamples = static_cast<size_t>(width) * channels;
+    std::vector<float> sums = fourierSums(input);
+
+    float maximum = 0.0f;
+    if (outputMode == OutputMode::ABS_NORMALISE) {
+        for (size_t i = 0; i < sums.size(); ++i) {
+            if (static_cast<int>(i % channels) < convolved) {
+                maximum = std::max(maximum, std::abs(sums[i]));
+            }
+        }
+    }
+    output.reshape(width, input.getHeight(), channels);
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            storeFloatRow(&sums[rowSamples * y], input.getRow(y), output.getRow(y), width, channels, maximum);
+        }
+    });
 }
@@ -17,24 +17,99 @@
 #define CONVOLUTION_FILTER_H
 
 #include "Filter.h"
+#include "BorderPolicy.h"
+#include "ConvolutionKernel.h"
 #include "../Image.h"
 
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <optional>
 
 /**
  * @class ConvolutionFilter
- * @brief An abstract base class for convolution-based filters
+ * @brief A base class for convolution-based filters, and a general convolution engine
  * 
  * The ConvolutionFilter class extends the Filter class, providing a common interface 
- * for applying 2D convolution kernels to greyscale images. Derived classes can utilize 
- * applyConvolution() to perform kernel-based transformations such as edge detection 
- * or smoothing.
+ * for applying 2D convolution kernels to images. Derived classes can utilize 
+ * setGradientKernels() for edge detection, or be built from a ConvolutionKernel.
+ * 
+ * With a ConvolutionKernel the filter convolves every colour channel (the alpha of a
+ * 4-channel image is copied), with neighbours outside the image given by a BorderPolicy
+ * (clamped to the edge by default). Each input row is copied once into a row padded by
+ * the kernel's reach on both sides, so the taps never need bounds tests; 3x3, 5x5 and
+ * 7x7 kernels use loops unrolled at compile time, other sizes a runtime loop. Fixed
+ * point kernels are summed in integers, float kernels in floats. The OutputMode selects
+ * how sums become output samples. separateKernel() runs separable and low-rank kernels
+ * as sums of 1D passes instead. Large kernels can be applied through Fourier transforms
+ * (see Method), on a grid padded according to the selected BorderPolicy.
  */
 class ConvolutionFilter : public Filter {
+public:
+    /**
+     * @brief How kernel sums are turned into output samples
+     */
+    enum class OutputMode {
+        CLAMP,          ///< Round and clamp to 0-255 (smoothing, sharpening)
+        ABS_NORMALISE,  ///< |sum| scaled so the largest over the image becomes 255
+        SIGNED_FLOAT    ///< Signed sums: applySigned() returns them, apply() shows 128 + sum
+    };
+
+    /**
+     * @brief How the kernel is applied
+     */
+    enum class Method {
+        AUTO,    ///< Fourier transforms when FourierConvolution estimates them cheaper, else DIRECT
+        DIRECT,  ///< Kernel taps (or separable terms) summed for every sample
+        FOURIER  ///< Fourier transforms of the whole image (see FourierConvolution)
+    };
+
+    static constexpr double DEFAULT_SEPARATION_TOLERANCE = 1e-6; ///< Relative singular value treated as zero
+    static constexpr int FOURIER_MIN_TAPS = 64; ///< AUTO never uses transforms below this many taps per sample
+
 protected:
     int kernelSize; ///< The size of the convolution kernel (assumed to be square)
+    std::vector<int> gradientX; ///< Horizontal kernel of a gradient operator (row-major), empty if none
+    std::vector<int> gradientY; ///< Vertical kernel of a gradient operator (row-major), empty if none
+    int gradientOrigin = 0;     ///< Kernel tap (origin, origin) lies on the output pixel
+
+    static constexpr int MAX_GRADIENT_SIZE = 5; ///< Largest gradient kernel size
+
+    std::optional<ConvolutionKernel> convolutionKernel; ///< Kernel of the general engine, if any
+    OutputMode outputMode = OutputMode::CLAMP;          ///< How the engine writes its sums
+    std::vector<ConvolutionKernel::SeparableTerm> separableTerms; ///< Rank-1 terms run instead of the kernel, if any
+    double separationError = 0.0;                       ///< Bound on the change of a sum from using the terms
+    Method method = Method::AUTO;                       ///< Direct sums or Fourier transforms
+    BorderPolicy border;                                ///< Samples read outside the image
+    std::vector<double> weightTable;                    ///< Summed-area table of the weights (RENORMALISE only)
+
+private:
+    /**
+     * @brief Greyscale rows converted during a sweep down the image, row r in slot r % kernelSize
+     */
+    struct GreyscaleRing {
+        std::vector<unsigned char> rows; ///< kernelSize rows of converted samples
+        int nextRow = 0;                 ///< First input row not converted yet
+
+        void reset(int rowCount, int width);
+    };
+
+    /**
+     * @brief Rows padded on both sides by border pixels, row r (which may lie outside the
+     *        image) in slot r mod rowCount
+     */
+    struct PaddedRing {
+        std::vector<unsigned char> rows; ///< rowCount padded rows
+        int rowBytes = 0;                ///< Bytes per padded row
+        int nextRow = 0;                 ///< First row not copied yet
+
+        void reset(int rowCount, int paddedBytes);
+    };
+
+    std::vector<std::uint16_t> compactMagnitudes; ///< Gradient magnitudes that fit 16 bits, reused by applyInto()
+    std::vector<int> magnitudeBuffer;             ///< Gradient magnitudes that do not, reused by applyInto()
+    std::vector<unsigned char> normaliseTable;    ///< Output value of each 16-bit magnitude
 
 public:
     // *******************************************************************************************
@@ -51,6 +126,16 @@ public:
      */
     ConvolutionFilter(const std::string& filterName, int kSize);
 
+    /**
+     * @brief Construct a filter that convolves images with a kernel
+     * 
+     * @param filterName A string representing the name of the filter
+     * @param kernel The kernel, floating or fixed point
+     * @param mode How sums become output samples
+     */
+    ConvolutionFilter(const std::string& filterName, const ConvolutionKernel& kernel,
+                      OutputMode mode = OutputMode::CLAMP);
+
     /**
      * @brief Virtual destructor for the ConvolutionFilter class
      */
@@ -65,14 +150,313 @@ public:
     /**
      * @brief Utility function to apply a 2D convolution kernel to a greyscale image
      * 
-     * This method performs convolution on a greyscale image using the specified kernel 
-     * and normalizes the resulting values to the range [0, 255].
+     * This method performs convolution on the first channel of an image using the specified
+     * kernel and normalizes the absolute results to the range [0, 255].
      * 
-     * @param input The input greyscale Image on which convolution will be performed
+     * @param input The input Image; only its first (red or grey) channel is used
      * @param kernel A 2D convolution kernel represented by a std::vector<std::vector<int>>
      * @return Image A new Image object containing the convolution results (greyscale)
      */
     Image applyConvolution(const Image& input, const std::vector<std::vector<int>>& kernel);
+
+    /**
+     * @brief Apply the filter's kernel (or gradient kernels) to an image
+     * 
+     * @param input Input image
+     * @return Image The convolved image (greyscale for gradient kernels)
+     * @throws std::logic_error If the filter has no kernel
+     */
+    Image apply(const Image& input) override;
+
+    /**
+     * @brief Signed kernel sums of every sample, whatever the output mode
+     * 
+     * @param input Input image
+     * @return std::vector<float> width * height * channels values, interleaved like the
+     *         image's samples; the alpha of a 4-channel image is copied unchanged
+     * @throws std::logic_error If the filter has no ConvolutionKernel
+     */
+    std::vector<float> applySigned(const Image& input) const;
+
+    /**
+     * @brief The kernel of the convolution engine, if the filter has one
+     */
+    const std::optional<ConvolutionKernel>& getKernel() const;
+
+    /**
+     * @brief How the convolution engine writes its sums
+     */
+    OutputMode getOutputMode() const;
+
+    /**
+     * @brief Run the kernel as a sum of separable 1D passes when that needs fewer taps
+     * 
+     * The kernel's rank-1 terms (see ConvolutionKernel::separate()) replace it if
+     * rank * (width + height) < width * height, e.g. a 15x15 Gaussian needs 30 taps per
+     * sample instead of 225. The terms are summed in floats, so every sum differs from
+     * direct convolution by at most getSeparationError() plus float rounding; with the
+     * default tolerance a separable kernel's output is within one grey level of it.
+     * 
+     * @param tolerance Singular values at or below tolerance * the largest are dropped
+     * @return bool True if the separable terms are used
+     * @throws std::logic_error If the filter has no ConvolutionKernel
+     */
+    bool separateKernel(double tolerance = DEFAULT_SEPARATION_TOLERANCE);
+
+    /**
+     * @brief Kernel taps evaluated per output sample (fewer once separateKernel() succeeds)
+     */
+    int getTapsPerPixel() const;
+
+    /**
+     * @brief Largest change of a sum caused by the separable terms (0 if they are not used)
+     */
+    double getSeparationError() const;
+
+    /**
+     * @brief Choose between direct sums and Fourier transforms
+     * 
+     * Through transforms each sum is computed in floats from the whole image, so outputs
+     * are within one grey level of DIRECT. With AUTO, kernels of FOURIER_MIN_TAPS or
+     * more taps per sample make the filter work on whole images (getRowHalo() is -1),
+     * and each image is then filtered whichever way FourierConvolution::isCheaper() picks.
+     * 
+     * @param method How the kernel is applied
+     */
+    void setMethod(Method method);
+
+    Method getMethod() const;
+
+    /**
+     * @brief Whether an image of the given size is filtered through Fourier transforms
+     * 
+     * @param width Width of the image
+     * @param height Height of the image
+     * @return bool True for FOURIER, or AUTO when the transforms are estimated cheaper
+     */
+    bool usesFourierTransform(int width, int height) const;
+
+    /**
+     * @brief Choose the samples the kernel reads outside the image
+     * 
+     * CLAMP (the default), REFLECT and ZERO pad the rows; RENORMALISE pads with zeros and
+     * rescales the sums of the border pixels by the full kernel's weight over the weight
+     * of their in-bounds taps, which keeps smoothing kernels from darkening the edges
+     * (kernels whose weights sum to zero are left unscaled). Interior pixels are the same
+     * in every mode. Gradient operators always clamp.
+     * 
+     * @param mode The border rule
+     * @throws std::logic_error If the filter has no ConvolutionKernel
+     */
+    void setBorderMode(BorderPolicy::Mode mode);
+
+    BorderPolicy::Mode getBorderMode() const;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // GRADIENT OPERATORS (EDGE DETECTION)
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Edge detection with the gradient kernels into an existing image
+     * 
+     * Same result as applyGradient(); the 16-bit or 32-bit magnitudes and the normalisation
+     * table are kept in buffers owned by the filter, so applying it again to an image of the
+     * same size allocates nothing.
+     * Filters with a ConvolutionKernel are applied in strips of rows, or through Fourier
+     * transforms (see setMethod()).
+     * 
+     * @param input Input image
+     * @param output Receives the greyscale edge image; must not be `input`
+     */
+    void applyInto(const Image& input, Image& output) override;
+
+    /**
+     * @brief Rows above and below an output row the kernel reaches
+     * 
+     * @return int The halo, or -1 if the filter has no kernel
+     */
+    int getRowHalo() const override;
+
+    /**
+     * @brief Edge images are greyscale; other kernels keep the input's channels
+     * 
+     * @return int 1 for gradient kernels, inputChannels otherwise
+     */
+    int getOutputChannels(int inputChannels) const override;
+
+    /**
+     * @brief Gradient magnitudes and ABS_NORMALISE sums are scaled by their maximum over the
+     *        whole image
+     * 
+     * @return bool True if gradient kernels are set or the output mode is ABS_NORMALISE
+     */
+    bool needsGlobalMaximum() const override;
+
+    /**
+     * @brief Largest gradient magnitude |Gx| + |Gy|, or largest |sum|, over rows [rowBegin, rowEnd)
+     * 
+     * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+     * @param rowBegin First row to evaluate
+     * @param rowEnd One past the last row to evaluate
+     * @return double The largest magnitude or |sum|
+     * @throws std::logic_error If the filter has no kernel
+     */
+    double computeRowsMaximum(const RowWindow& input, int rowBegin, int rowEnd) const override;
+
+    /**
+     * @brief Filter rows [rowBegin, rowEnd); edge images are magnitude * 255 / globalMaximum
+     * 
+     * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+     * @param output Output window holding rows [rowBegin, rowEnd)
+     * @param rowBegin First row to filter
+     * @param rowEnd One past the last row to filter
+     * @param globalMaximum Largest computeRowsMaximum() over the whole image
+     * @throws std::logic_error If the filter has no kernel
+     */
+    void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                   int rowBegin, int rowEnd, double globalMaximum = 0) const override;
+
+protected:
+    /**
+     * @brief Set the kernels of a gradient operator (called by the edge detection filters)
+     * 
+     * @param kernelX Horizontal kernel, kernelSize x kernelSize values, row-major
+     * @param kernelY Vertical kernel, kernelSize x kernelSize values, row-major
+     * @param origin Kernel tap (origin, origin) lies on the output pixel
+     * @throws std::invalid_argument If kernelSize is larger than MAX_GRADIENT_SIZE
+     */
+    void setGradientKernels(const int* kernelX, const int* kernelY, int origin);
+
+    /**
+     * @brief Edge detection with the gradient kernels
+     * 
+     * The image is converted to greyscale (if it has more than one channel), the magnitude
+     * |Gx| + |Gy| is computed with clamped borders, and the result is normalised to [0, 255]
+     * by the largest magnitude in the image.
+     * 
+     * @param input Input image
+     * @return Image Greyscale edge image
+     */
+    Image applyGradient(const Image& input);
+
+private:
+    /**
+     * @brief Largest |Gx| + |Gy| the gradient kernels can produce from 8-bit input
+     */
+    int getMagnitudeBound() const;
+
+    /**
+     * @brief Greyscale rows under each kernel row for output row y, clamped to the image
+     * 
+     * @param input Input rows around y, any number of channels (converted on the fly)
+     * @param y Output row; rows must be visited in increasing order after ring.reset()
+     * @param ring Converted rows of the current sweep
+     * @param rows Receives kernelSize row pointers
+     */
+    void kernelRows(const RowWindow& input, int y, GreyscaleRing& ring, const unsigned char** rows) const;
+
+    /**
+     * @brief Gradient magnitudes |Gx| + |Gy| of one row of a greyscale image
+     * 
+     * @param rows Greyscale row under each kernel row (see kernelRows())
+     * @param width Width of the rows
+     * @param magnitudes Receives one magnitude per pixel of the row
+     */
+    void gradientRow(const unsigned char* const* rows, int width, int* magnitudes) const;
+
+    /**
+     * @brief Gradient magnitudes of the columns [xBegin, xEnd) whose taps reach past an edge
+     * 
+     * The columns under the kernel are copied into short clamped rows first, so the same
+     * GradientKernels span as the interior evaluates them.
+     */
+    void gradientBorder(const unsigned char* const* rows, int width, int xBegin, int xEnd, int* magnitudes) const;
+
+    /**
+     * @brief Padded rows under each kernel row for output row y, following the border policy
+     * 
+     * @param input Input rows around y
+     * @param y Output row; rows must be visited in increasing order after ring.reset()
+     * @param ring Padded rows of the current sweep
+     * @param rows Receives one row pointer per kernel row
+     */
+    void paddedRows(const RowWindow& input, int y, PaddedRing& ring, const unsigned char** rows) const;
+
+    /**
+     * @brief Kernel sums of one output row, one per sample (alpha samples are left unset)
+     * 
+     * @param rows Padded row under each kernel row (see paddedRows())
+     * @param width Width of the image
+     * @param channels Channels of the image
+     * @param weights Kernel weights (fixed point or float)
+     * @param sums Receives width * channels sums
+     */
+    template <typename Weight>
+    void kernelRowSums(const unsigned char* const* rows, int width, int channels,
+                       const Weight* weights, Weight* sums) const;
+
+    /**
+     * @brief Sums of one output row from the separable terms, in floats
+     */
+    void separableRowSums(const unsigned char* const* rows, int width, int channels, float* sums) const;
+
+    /**
+     * @brief Whether rowSums() writes integer sums (fixed point kernel, not separated or renormalised)
+     */
+    bool sumsInIntegers() const;
+
+    /**
+     * @brief Sums of output row y, into fixedSums if sumsInIntegers(), else into floatSums
+     */
+    void rowSums(const unsigned char* const* rows, int y, int width, int height, int channels,
+                 int* fixedSums, float* floatSums) const;
+
+    /**
+     * @brief RENORMALISE: rescale the sums of row y's pixels whose taps reach past an edge
+     * 
+     * @param y Output row
+     * @param width Width of the image
+     * @param height Height of the image
+     * @param channels Channels of the image
+     * @param sums width * channels float sums of row y
+     */
+    void renormaliseRow(int y, int width, int height, int channels, float* sums) const;
+
+    /**
+     * @brief Convolve rows [rowBegin, rowEnd) with the kernel and write them in the output mode
+     */
+    void applyKernelRows(const RowWindow& input, const MutableRowWindow& output,
+                         int rowBegin, int rowEnd, double globalMaximum) const;
+
+    /**
+     * @brief Largest |sum| over rows [rowBegin, rowEnd) (see computeRowsMaximum())
+     */
+    double computeKernelRowsMaximum(const RowWindow& input, int rowBegin, int rowEnd) const;
+
+    /**
+     * @brief Write one row of float sums in the output mode, copying alpha
+     * 
+     * @param sums width * channels sums
+     * @param src Input row (for the alpha of a 4-channel image)
+     * @param dst Output row
+     * @param width Width of the image
+     * @param channels Channels of the image
+     * @param maximum Largest |sum| over the image (ABS_NORMALISE only)
+     */
+    void storeFloatRow(const float* sums, const unsigned char* src, unsigned char* dst,
+                       int width, int channels, float maximum) const;
+
+    /**
+     * @brief Kernel sums of every sample through Fourier transforms, laid out like applySigned()
+     */
+    std::vector<float> fourierSums(const Image& input) const;
+
+    /**
+     * @brief Convolve the whole image through Fourier transforms and write it in the output mode
+     */
+    void applyFourier(const Image& input, Image& output) const;
 };
 
 #endif // CONVOLUTION_FILTER_H
@@ -0,0 +1,290 @@
+/**
+ * @file ConvolutionKernel.cpp
+ * @brief Implementation of the ConvolutionKernel class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "ConvolutionKernel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// CONSTRUCTORS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Checks the sizes and resolves a centred origin
+ConvolutionKernel::ConvolutionKernel(int width, int height, int originX, int originY)
+    : width(width), height(height), originX(originX < 0 ? width / 2 : originX),
+      originY(originY < 0 ? height / 2 : originY), fractionBits(0), fixedPoint(false) {
+    if (width < 1 || height < 1) {
+        throw std::invalid_argument("Kernel must be at least 1x1");
+    }
+    if (this->originX >= width || this->originY >= height) {
+        throw std::invalid_argument("Kernel origin must lie inside the kernel");
+    }
+}
+
+ConvolutionKernel ConvolutionKernel::floating(int width, int height, const std::vector<float>& weights,
+                                              int originX, int originY) {
+    ConvolutionKernel kernel(width, height, originX, originY);
+    if (weights.size() != static_cast<size_t>(width) * height) {
+        throw std::invalid_argument("Kernel needs width * height weights");
+    }
+    for (float weight : weights) {
+        if (!std::isfinite(weight)) {
+            throw std::invalid_argument("Kernel weights must be finite");
+        }
+    }
+    kernel.weights = weights;
+    return kernel;
+}
+
+ConvolutionKernel ConvolutionKernel::fixed(int width, int height, const std::vector<int>& weights,
+                                           int fractionBits, int originX, int originY) {
+    ConvolutionKernel kernel(width, height, originX, originY);
+    if (weights.size() != static_cast<size_t>(width) * height) {
+        throw std::invalid_argument("Kernel needs width * height weights");
+    }
+    if (fractionBits < 0 || fractionBits > MAX_FRACTION_BITS) {
+        throw std::invalid_argument("Fixed point kernels need 0 to " +
+                                    std::to_string(MAX_FRACTION_BITS) + " fraction bits");
+    }
+    // Sums of 8-bit samples are computed in int, plus the rounding term
+    long long bound = 0;
+    for (int weight : weights) {
+        bound += std::llabs(weight) * 255LL;
+    }
+    if (bound + (1LL << fractionBits) > INT_MAX) {
+        throw std::invalid_argument("Fixed point kernel weights are too large");
+    }
+    kernel.fixedPoint = true;
+    kernel.fractionBits = fractionBits;
+    kernel.fixedWeights = weights;
+    kernel.weights.resize(weights.size());
+    for (size_t i = 0; i < weights.size(); ++i) {
+        kernel.weights[i] = std::ldexp(static_cast<float>(weights[i]), -fractionBits);
+    }
+    return kernel;
+}
+
+ConvolutionKernel ConvolutionKernel::fromRows(const std::vector<std::vector<int>>& rows) {
+    if (rows.empty() || rows.front().empty()) {
+        throw std::invalid_argument("Kernel must be at least 1x1");
+    }
+    std::vector<int> weights;
+    for (const auto& row : rows) {
+        if (row.size() != rows.front().size()) {
+            throw std::invalid_argument("Kernel rows must all have the same length");
+        }
+        weights.insert(weights.end(), row.begin(), row.end());
+    }
+    return fixed(static_cast<int>(rows.front().size()), static_cast<int>(rows.size()), weights);
+}
+
+ConvolutionKernel ConvolutionKernel::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot read kernel file: " + path);
+    }
+    std::vector<std::vector<double>> rows;
+    bool integers = true;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream tokens(line.substr(0, line.find('#')));
+        std::vector<double> row;
+        std::string token;
+        while (tokens >> token) {
+            size_t used = 0;
+            double weight = 0.0;
+            try {
+                weight = std::stod(token, &used);
+            } catch (const std::exception&) {
+                used = 0;
+            }
+            if (used != token.size()) {
+                throw std::invalid_argument("Kernel weight is not a number: " + token);
+            }
+            integers = integers && weight == std::trunc(weight) && std::abs(weight) <= INT_MAX;
+            row.push_back(weight);
+        }
+        if (!row.empty()) {
+            rows.push_back(row);
+        }
+    }
+    if (rows.empty()) {
+        throw std::invalid_argument("Kernel file has no weights: " + path);
+    }
+
+    int width = static_cast<int>(rows.front().size());
+    int height = static_cast<int>(rows.size());
+    std::vector<double> weights;
+    for (const auto& row : rows) {
+        if (row.size() != rows.front().size()) {
+            throw std::invalid_argument("Kernel rows must all have the same length");
+        }
+        weights.insert(weights.end(), row.begin(), row.end());
+    }
+    if (integers) {
+        return fixed(width, height, std::vector<int>(weights.begin(), weights.end()));
+    }
+    return floating(width, height, std::vector<float>(weights.begin(), weights.end()));
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// GETTERS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+int ConvolutionKernel::getWidth() const {
+    return width;
+}
+
+int ConvolutionKernel::getHeight() const {
+    return height;
+}
+
+int ConvolutionKernel::getOriginX() const {
+    return originX;
+}
+
+int ConvolutionKernel::getOriginY() const {
+    return originY;
+}
+
+bool ConvolutionKernel::isFixedPoint() const {
+    return fixedPoint;
+}
+
+int ConvolutionKernel::getFractionBits() const {
+    return fractionBits;
+}
+
+const std::vector<float>& ConvolutionKernel::getWeights() const {
+    return weights;
+}
+
+const std::vector<int>& ConvolutionKernel::getFixedWeights() const {
+    return fixedWeights;
+}
+
+int ConvolutionKernel::getRowHalo() const {
+    return std::max(originY, height - 1 - originY);
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// SEPARABILITY
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+std::vector<ConvolutionKernel::SeparableTerm> ConvolutionKernel::separate(double tolerance) const {
+    const int maxSweeps = 60;
+
+    // One-sided Jacobi: rotate pairs of kernel columns until they are orthogonal, keeping
+    // the rotations in v, so that K = a * v^T with orthogonal columns a_j = s_j * u_j
+    std::vector<double> a(weights.begin(), weights.end());
+    std::vector<double> v(static_cast<size_t>(width) * width, 0.0);
+    for (int x = 0; x < width; ++x) {
+        v[x * width + x] = 1.0;
+    }
+    for (int sweep = 0; sweep < maxSweeps; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p < width; ++p) {
+            for (int q = p + 1; q < width; ++q) {
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (int y = 0; y < height; ++y) {
+                    double ap = a[y * width + p];
+                    double aq = a[y * width + q];
+                    alpha += ap * ap;
+                    beta += aq * aq;
+                    gamma += ap * aq;
+                }
+                if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta)) {
+                    continue;
+                }
+                rotated = true;
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = (zeta >= 0.0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                double c = 1.0 / std::sqrt(1.0 + t * t);
+                double s = c * t;
+                for (int y = 0; y < height; ++y) {
+                    double ap = a[y * width + p];
+                    double aq = a[y * width + q];
+                    a[y * width + p] = c * ap - s * aq;
+                    a[y * width + q] = s * ap + c * aq;
+                }
+                for (int x = 0; x < width; ++x) {
+                    double vp = v[x * width + p];
+                    double vq = v[x * width + q];
+                    v[x * width + p] = c * vp - s * vq;
+                    v[x * width + q] = s * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+
+    // Singular values are the column norms; keep the significant terms, largest first
+    std::vector<double> singular(width, 0.0);
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            singular[x] += a[y * width + x] * a[y * width + x];
+        }
+        singular[x] = std::sqrt(singular[x]);
+    }
+    std::vector<int> order(width);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int i, int j) { return singular[i] > singular[j]; });
+
+    std::vector<SeparableTerm> terms;
+    for (int j : order) {
+        if (singular[j] == 0.0 || singular[j] <= tolerance * singular[order.front()]) {
+            break;
+        }
+        SeparableTerm term;
+        for (int y = 0; y < height; ++y) {
+            term.column.push_back(static_cast<float>(a[y * width + j]));
+        }
+        for (int x = 0; x < width; ++x) {
+            term.row.push_back(static_cast<float>(v[x * width + j]));
+        }
+        terms.push_back(std::move(term));
+    }
+    return terms;
+}
+
+double ConvolutionKernel::getSeparationError(const std::vector<SeparableTerm>& terms) const {
+    double error = 0.0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double approximation = 0.0;
+            for (const SeparableTerm& term : terms) {
+                approximation += static_cast<double>(term.column[y]) * term.row[x];
+            }
+            error += std::abs(weights[y * width + x] - approximation);
+        }
+    }
+    return 255.0 * error;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file ConvolutionKernel.h
+ * @brief Declaration of the ConvolutionKernel class, a 2D kernel in floating or fixed point
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef CONVOLUTION_KERNEL_H
+#define CONVOLUTION_KERNEL_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Weights of a 2D convolution kernel and the tap that lies on the output pixel
+ *
+ * A kernel is either floating point, or fixed point: integer weights that stand for
+ * weight / 2^fractionBits, so sums are exact integers and a kernel such as a Laplacian
+ * (fractionBits = 0) gives the same results as integer arithmetic. Weights are stored
+ * row-major; the tap (originX, originY) is multiplied with the output pixel itself.
+ */
+class ConvolutionKernel {
+private:
+    int width;                      ///< Number of columns
+    int height;                     ///< Number of rows
+    int originX;                    ///< Column of the tap on the output pixel
+    int originY;                    ///< Row of the tap on the output pixel
+    int fractionBits;               ///< Fixed point: weights are scaled by 2^fractionBits
+    bool fixedPoint;                ///< True if fixedWeights holds the kernel
+    std::vector<float> weights;     ///< Weights as floats (fixed point ones are converted)
+    std::vector<int> fixedWeights;  ///< Scaled integer weights, empty for float kernels
+
+    ConvolutionKernel(int width, int height, int originX, int originY);
+
+public:
+    static constexpr int MAX_FRACTION_BITS = 16; ///< Largest fixed point scale
+
+    /**
+     * @brief One rank-1 part of a kernel: weight (x, y) is column[y] * row[x]
+     */
+    struct SeparableTerm {
+        std::vector<float> column; ///< Vertical 1D kernel, one weight per kernel row
+        std::vector<float> row;    ///< Horizontal 1D kernel, one weight per kernel column
+    };
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // CONSTRUCTORS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Floating point kernel
+     *
+     * @param width Number of columns
+     * @param height Number of rows
+     * @param weights width * height weights, row-major
+     * @param originX Column of the tap on the output pixel (-1 for the centre, width / 2)
+     * @param originY Row of the tap on the output pixel (-1 for the centre, height / 2)
+     * @return ConvolutionKernel The kernel
+     * @throws std::invalid_argument If the sizes, weight count or origin are invalid
+     */
+    static ConvolutionKernel floating(int width, int height, const std::vector<float>& weights,
+                                      int originX = -1, int originY = -1);
+
+    /**
+     * @brief Fixed point kernel: each weight stands for weight / 2^fractionBits
+     *
+     * @param width Number of columns
+     * @param height Number of rows
+     * @param weights width * height scaled weights, row-major
+     * @param fractionBits Binary digits after the point (0 for integer kernels)
+     * @param originX Column of the tap on the output pixel (-1 for the centre, width / 2)
+     * @param originY Row of the tap on the output pixel (-1 for the centre, height / 2)
+     * @return ConvolutionKernel The kernel
+     * @throws std::invalid_argument If the sizes, weight count, origin or fractionBits are
+     *         invalid, or if a sum over 8-bit samples could overflow an int
+     */
+    static ConvolutionKernel fixed(int width, int height, const std::vector<int>& weights,
+                                   int fractionBits = 0, int originX = -1, int originY = -1);
+
+    /**
+     * @brief Integer kernel from nested rows, with the origin at the centre
+     *
+     * @param rows Kernel rows, all of the same length
+     * @return ConvolutionKernel The kernel
+     * @throws std::invalid_argument If the rows are empty or ragged
+     */
+    static ConvolutionKernel fromRows(const std::vector<std::vector<int>>& rows);
+
+    /**
+     * @brief Kernel read from a text file, with the origin at the centre
+     *
+     * Each non-empty line is one kernel row of whitespace-separated weights; text after a
+     * '#' is a comment. If every weight is an integer the kernel is fixed point (exact
+     * integer sums), otherwise it is floating point.
+     *
+     * @param path Path of the kernel file
+     * @return ConvolutionKernel The kernel
+     * @throws std::runtime_error If the file cannot be read
+     * @throws std::invalid_argument If a weight is not a number, or the rows are empty or ragged
+     */
+    static ConvolutionKernel fromFile(const std::string& path);
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // GETTERS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    int getWidth() const;
+    int getHeight() const;
+    int getOriginX() const;
+    int getOriginY() const;
+
+    /**
+     * @brief Whether the kernel is fixed point (see getFixedWeights())
+     */
+    bool isFixedPoint() const;
+
+    /**
+     * @brief Binary digits after the point of the fixed point weights (0 for float kernels)
+     */
+    int getFractionBits() const;
+
+    /**
+     * @brief Weights as floats, row-major
+     */
+    const std::vector<float>& getWeights() const;
+
+    /**
+     * @brief Scaled integer weights, row-major (empty for float kernels)
+     */
+    const std::vector<int>& getFixedWeights() const;
+
+    /**
+     * @brief Rows above and below an output row the kernel reaches
+     */
+    int getRowHalo() const;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // SEPARABILITY
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Write the kernel as a sum of rank-1 (separable) terms
+     *
+     * The singular value decomposition K = sum of s_i * u_i * v_i^T is computed with
+     * one-sided Jacobi rotations (in double precision; kernels are small), and the terms
+     * whose singular value is above tolerance * the largest one are kept, largest first.
+     * A separable kernel gives one term, so convolving with it costs width + height taps
+     * per pixel instead of width * height.
+     *
+     * @param tolerance Terms with s_i <= tolerance * s_0 are dropped (0 keeps every non-zero term)
+     * @return std::vector<SeparableTerm> Terms whose sum approximates the kernel (empty for a zero kernel)
+     */
+    std::vector<SeparableTerm> separate(double tolerance) const;
+
+    /**
+     * @brief Largest change of a sum over 8-bit samples when terms replace the kernel
+     *
+     * @param terms Terms from separate()
+     * @return double 255 * the sum of |weight - summed terms| over the taps
+     */
+    double getSeparationError(const std::vector<SeparableTerm>& terms) const;
+};
+
+#endif // CONVOLUTION_KERNEL_H
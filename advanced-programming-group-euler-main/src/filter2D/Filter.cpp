@@ -14,6 +14,11 @@
  */
 
  #include "Filter.h"
+ #include "../ThreadPool.h"
+
+ #include <algorithm>
+ #include <mutex>
+ #include <stdexcept>
 
  // *******************************************************************************************
  // -------------------------------------------------------------------------------------------
@@ -51,3 +56,70 @@ void Filter::setParameter(const std::string& key, const std::any& value) {
         throw std::invalid_argument("Unsupported parameter type.");
     }
 }
+
+ // *******************************************************************************************
+ // -------------------------------------------------------------------------------------------
+ // IMAGE MANIPULATION
+ // -------------------------------------------------------------------------------------------
+ // *******************************************************************************************
+
+// Filter bands of rows straight into the reused output; a global maximum takes a first pass
+void Filter::applyInto(const Image& input, Image& output) {
+    if (getRowHalo() < 0) {
+        output = apply(input);
+        return;
+    }
+    applyStrips(input, output);
+}
+
+// Filter bands of rows in parallel, after a pass for the global maximum if needed
+void Filter::applyStrips(const Image& input, Image& output) {
+    output.reshape(input.getWidth(), input.getHeight(), getOutputChannels(input.getChannels()));
+    RowWindow in(input.getView());
+    MutableRowWindow out(output.getView());
+    ThreadPool& pool = ThreadPool::shared();
+
+    double maximum = 0;
+    if (needsGlobalMaximum()) {
+        std::mutex maxMutex; // Guards maximum while the bands merge their maxima
+        pool.parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+            double bandMax = computeRowsMaximum(in, bandBegin, bandEnd);
+            std::lock_guard<std::mutex> lock(maxMutex);
+            maximum = std::max(maximum, bandMax);
+        });
+    }
+    pool.parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        applyRows(in, out, bandBegin, bandEnd, maximum);
+    });
+}
+
+ // *******************************************************************************************
+ // -------------------------------------------------------------------------------------------
+ // STRIP PROCESSING
+ // -------------------------------------------------------------------------------------------
+ // *******************************************************************************************
+
+// Filters need the whole image unless they say otherwise
+int Filter::getRowHalo() const {
+    return -1;
+}
+
+// Keep the input's channels by default
+int Filter::getOutputChannels(int inputChannels) const {
+    return inputChannels;
+}
+
+// No global maximum by default
+bool Filter::needsGlobalMaximum() const {
+    return false;
+}
+
+// No global maximum by default
+double Filter::computeRowsMaximum(const RowWindow&, int, int) const {
+    return 0;
+}
+
+// Filters that need the whole image cannot filter a strip of rows
+void Filter::applyRows(const RowWindow&, const MutableRowWindow&, int, int, double) const {
+    throw std::logic_error(name + " filter cannot be applied to a strip of rows");
+}
@@ -110,6 +110,89 @@ public:
      * @see Image
      */
     virtual Image apply(const Image& input) = 0;
+
+    /**
+     * @brief Apply the filter, writing the result into an existing image
+     * 
+     * `output` is reshaped to the result's size and its buffer reused, so a filter that
+     * works on strips of rows allocates nothing once its scratch buffers have grown to
+     * the image size. Other filters fall back to `output = apply(input)`.
+     * 
+     * @param input Input image to apply the filter to
+     * @param output Receives the result; must not be `input`
+     */
+    virtual void applyInto(const Image& input, Image& output);
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // STRIP PROCESSING
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Number of rows above and below an output row that its value depends on
+     * 
+     * Filters that can work on a strip of rows (see applyRows()) override this; the
+     * FilterPipeline uses it to decide how many extra rows each strip needs.
+     * 
+     * @return int The halo in rows, or -1 if the filter needs the whole image at once
+     */
+    virtual int getRowHalo() const;
+
+    /**
+     * @brief Number of channels of the output for an input with `inputChannels` channels
+     * 
+     * @param inputChannels Channels of the input image
+     * @return int Channels of the output image (the default keeps the input's)
+     */
+    virtual int getOutputChannels(int inputChannels) const;
+
+    /**
+     * @brief Whether the output is scaled by a maximum taken over the whole image
+     * 
+     * If so, strips are filtered in two phases: computeRowsMaximum() on every strip first,
+     * then applyRows() with the largest of the results.
+     * 
+     * @return bool True if applyRows() needs a global maximum (false by default)
+     */
+    virtual bool needsGlobalMaximum() const;
+
+    /**
+     * @brief Maximum of the unscaled output over rows [rowBegin, rowEnd)
+     * 
+     * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+     * @param rowBegin First row to evaluate
+     * @param rowEnd One past the last row to evaluate
+     * @return double The maximum (0 for filters that do not need one)
+     */
+    virtual double computeRowsMaximum(const RowWindow& input, int rowBegin, int rowEnd) const;
+
+    /**
+     * @brief Filter rows [rowBegin, rowEnd) of an image on the calling thread
+     * 
+     * The result equals rows [rowBegin, rowEnd) of apply() on the whole image.
+     * 
+     * @param input Input rows [rowBegin - halo, rowEnd + halo), clipped to the image
+     * @param output Output window holding at least rows [rowBegin, rowEnd)
+     * @param rowBegin First row to filter
+     * @param rowEnd One past the last row to filter
+     * @param globalMaximum Largest computeRowsMaximum() over the image, if needsGlobalMaximum()
+     * @throws std::logic_error If the filter needs the whole image (getRowHalo() is -1)
+     */
+    virtual void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                           int rowBegin, int rowEnd, double globalMaximum = 0) const;
+
+protected:
+    /**
+     * @brief The strip path of applyInto(): bands of rows filtered in parallel into output
+     * 
+     * For filters that choose between strips and a whole-image method at run time; it
+     * relies on applyRows() even if getRowHalo() is -1.
+     * 
+     * @param input Input image to apply the filter to
+     * @param output Receives the result; must not be `input`
+     */
+    void applyStrips(const Image& input, Image& output);
 };
 
 #endif
\ No newline at end of file
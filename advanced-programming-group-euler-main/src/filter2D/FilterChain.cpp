@@ -0,0 +1,63 @@
+/**
+ * @file FilterChain.cpp
+ * @brief Implementation of the FilterChain class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "FilterChain.h"
+
+#include <cstring>
+#include <utility>
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// CONSTRUCTORS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// The spare buffer starts tiny and grows on the first step
+FilterChain::FilterChain(Image image)
+    : current(std::move(image)), spare(1, 1, 1) {}
+
+// Copy row by row into the current buffer (reshape keeps its allocation)
+void FilterChain::assign(const Image& image) {
+    current.reshape(image.getWidth(), image.getHeight(), image.getChannels());
+    const size_t rowBytes = static_cast<size_t>(image.getWidth()) * image.getChannels();
+    for (int y = 0; y < image.getHeight(); ++y) {
+        std::memcpy(current.getRow(y), image.getRow(y), rowBytes);
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// APPLYING STEPS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Write into the spare buffer, then swap (moves only swap the buffers' pointers)
+void FilterChain::apply(Filter& filter) {
+    filter.applyInto(current, spare);
+    std::swap(current, spare);
+}
+
+void FilterChain::apply(const std::function<Image(const Image&)>& step) {
+    spare = step(current);
+    std::swap(current, spare);
+}
+
+const Image& FilterChain::getImage() const {
+    return current;
+}
+
+Image FilterChain::release() {
+    return std::move(current);
+}
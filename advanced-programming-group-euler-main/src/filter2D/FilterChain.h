@@ -0,0 +1,97 @@
+/**
+ * @file FilterChain.h
+ * @brief Declaration of the FilterChain class, which applies filters in turn between two buffers
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include "Filter.h"
+#include "../Image.h"
+
+#include <functional>
+
+/**
+ * @brief Applies a sequence of filters to an image using a pair of ping-pong buffers
+ *
+ * The chain owns the current image and a spare one. Each step writes its result into the
+ * spare buffer with Filter::applyInto() and the two buffers are swapped, so no image is
+ * copied and, once both buffers have reached the largest image size in the chain, no
+ * image memory is allocated. Filters that work on strips of rows also keep their scratch
+ * space between calls, which makes a whole step allocation-free after warm-up.
+ */
+class FilterChain {
+private:
+    Image current; ///< Result of the steps applied so far
+    Image spare;   ///< Buffer the next step writes into
+
+public:
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // CONSTRUCTORS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Start a chain from an image
+     *
+     * @param image First image of the chain (moved in, not copied)
+     */
+    explicit FilterChain(Image image);
+
+    /**
+     * @brief Restart the chain from a copy of another image, reusing the current buffer
+     *
+     * @param image Image to copy
+     */
+    void assign(const Image& image);
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // APPLYING STEPS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Apply a filter to the current image
+     *
+     * @param filter Filter to apply; writes into the spare buffer, which then becomes current
+     */
+    void apply(Filter& filter);
+
+    /**
+     * @brief Apply a function returning a new image to the current image
+     *
+     * For operations that are not Filter objects; the returned image is moved in, so the
+     * step allocates whatever the function allocates.
+     *
+     * @param step Function computing the next image from the current one
+     */
+    void apply(const std::function<Image(const Image&)>& step);
+
+    /**
+     * @brief The result of the steps applied so far
+     */
+    const Image& getImage() const;
+
+    /**
+     * @brief Move the result out of the chain
+     *
+     * The chain must be restarted with assign() before it is used again.
+     *
+     * @return Image The result of the steps applied so far
+     */
+    Image release();
+};
+
+#endif // FILTER_CHAIN_H
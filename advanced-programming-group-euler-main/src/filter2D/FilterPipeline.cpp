@@ -0,0 +1,225 @@
+/**
+ * @file FilterPipeline.cpp
+ * @brief Implementation of the FilterPipeline class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "FilterPipeline.h"
+#include "../ThreadPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// CONSTRUCTORS & BUILDING THE CHAIN
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+FilterPipeline::FilterPipeline() : Filter("Pipeline") {
+}
+
+void FilterPipeline::addStage(std::unique_ptr<Filter> stage) {
+    if (!stage) {
+        throw std::invalid_argument("Pipeline stage must not be null");
+    }
+    if (stage->getRowHalo() < 0) {
+        throw std::invalid_argument(stage->getName() + " filter needs the whole image and cannot be a pipeline stage");
+    }
+    stages.push_back(std::move(stage));
+}
+
+void FilterPipeline::clear() {
+    stages.clear();
+}
+
+bool FilterPipeline::empty() const {
+    return stages.empty();
+}
+
+std::size_t FilterPipeline::size() const {
+    return stages.size();
+}
+
+void FilterPipeline::setTileRows(int rows) {
+    if (rows < 0) {
+        throw std::invalid_argument("Tile rows must not be negative");
+    }
+    tileRows = rows;
+}
+
+/**
+ * @brief Rows per tile for an input image
+ *
+ * Automatic tiles are sized so the widest strip a stage writes is about DEFAULT_TILE_BYTES,
+ * but at least twice the total halo (so recomputed halo rows stay a small fraction of the
+ * work) and at most an equal share of the image per thread (so every thread gets a tile).
+ *
+ * @param width Width of the input
+ * @param height Height of the input
+ * @param channels Channels of the input
+ * @return Rows per tile (between 1 and height)
+ */
+int FilterPipeline::getTileRows(int width, int height, int channels) const {
+    if (tileRows > 0) {
+        return std::min(tileRows, std::max(height, 1));
+    }
+    std::size_t rowBytes = static_cast<std::size_t>(width) * channels;
+    int totalHalo = 0;
+    for (const auto& stage : stages) {
+        channels = stage->getOutputChannels(channels);
+        rowBytes = std::max(rowBytes, static_cast<std::size_t>(width) * channels);
+        totalHalo += stage->getRowHalo();
+    }
+    int rows = static_cast<int>(std::min<std::size_t>(DEFAULT_TILE_BYTES / std::max<std::size_t>(rowBytes, 1),
+                                                      static_cast<std::size_t>(height)));
+    rows = std::max(rows, 2 * totalHalo);
+    int threads = ThreadPool::shared().getThreadCount();
+    rows = std::min(rows, (height + threads - 1) / threads);
+    return std::clamp(rows, 1, std::max(height, 1));
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// APPLY FUNCTIONS
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+Image FilterPipeline::apply(const Image& input) {
+    if (stages.size() == 1) {
+        return stages.front()->apply(input);
+    }
+    return applyTiled(input);
+}
+
+void FilterPipeline::applyInto(const Image& input, Image& output) {
+    if (stages.size() == 1) {
+        stages.front()->applyInto(input, output);
+    } else {
+        applyTiledInto(input, output);
+    }
+}
+
+Image FilterPipeline::applyTiled(const Image& input) {
+    if (stages.empty()) {
+        return input;
+    }
+    Image output(input.getWidth(), input.getHeight(), getStageChannels(input.getChannels(), static_cast<int>(size())));
+    applyTiledInto(input, output);
+    return output;
+}
+
+// Channels after the first stageCount stages
+int FilterPipeline::getStageChannels(int inputChannels, int stageCount) const {
+    for (int s = 0; s < stageCount; s++) {
+        inputChannels = stages[s]->getOutputChannels(inputChannels);
+    }
+    return inputChannels;
+}
+
+/**
+ * @brief Apply every stage to the image tile by tile
+ *
+ * Each stage that needs a global maximum gets a phase of its own, run in chain order so
+ * the stages before it already have theirs; the last phase writes the output.
+ *
+ * @param input Input image
+ * @param output Receives the result of the last stage
+ */
+void FilterPipeline::applyTiledInto(const Image& input, Image& output) {
+    if (stages.empty()) {
+        output = input;
+        return;
+    }
+    const int stageCount = static_cast<int>(stages.size());
+    maxima.assign(stageCount, 0);
+    for (int s = 0; s < stageCount; s++) {
+        if (stages[s]->needsGlobalMaximum()) {
+            maxima[s] = runTiles(input, s + 1, nullptr);
+        }
+    }
+    output.reshape(input.getWidth(), input.getHeight(), getStageChannels(input.getChannels(), stageCount));
+    runTiles(input, stageCount, &output);
+}
+
+/**
+ * @brief Push every tile through stages [0, stageCount)
+ *
+ * Working back from a tile of output rows, each stage must produce the rows the next one
+ * reads: its output range grows by the next stage's halo on either side, clipped to the
+ * image. The first stage reads the input directly and the last writes straight into the
+ * output; the stages in between write to two strips per thread used in turn, which grow
+ * to the largest strip once and are reused for every tile.
+ *
+ * @param input Input image
+ * @param stageCount Number of stages to run
+ * @param output Output of the last stage, or null to find the last stage's maximum instead
+ * @return The maximum if output is null, 0 otherwise
+ */
+double FilterPipeline::runTiles(const Image& input, int stageCount, Image* output) const {
+    const int width = input.getWidth();
+    const int height = input.getHeight();
+    const int rowsPerTile = getTileRows(width, input.getHeight(), input.getChannels());
+    const int tileCount = (height + rowsPerTile - 1) / rowsPerTile;
+
+    double maximum = 0;
+    std::mutex maxMutex; // Guards maximum while the threads merge their maxima
+    const RowWindow source(input.getView());
+
+    ThreadPool::shared().parallelFor(0, tileCount, [&](int tileBegin, int tileEnd) {
+        // Per-thread strips and row ranges, grown once and reused by every call
+        static thread_local std::vector<unsigned char> strips[2];
+        static thread_local std::vector<int> rowBegin, rowEnd;
+        rowBegin.resize(stageCount);
+        rowEnd.resize(stageCount);
+        double threadMax = 0;
+        for (int tile = tileBegin; tile < tileEnd; tile++) {
+            // Output rows each stage must produce for this tile
+            rowBegin[stageCount - 1] = tile * rowsPerTile;
+            rowEnd[stageCount - 1] = std::min(rowBegin[stageCount - 1] + rowsPerTile, height);
+            for (int s = stageCount - 2; s >= 0; s--) {
+                int halo = stages[s + 1]->getRowHalo();
+                rowBegin[s] = std::max(rowBegin[s + 1] - halo, 0);
+                rowEnd[s] = std::min(rowEnd[s + 1] + halo, height);
+            }
+
+            RowWindow in = source;
+            int channels = input.getChannels();
+            for (int s = 0; s < stageCount - 1; s++) {
+                channels = stages[s]->getOutputChannels(channels);
+                const int rows = rowEnd[s] - rowBegin[s];
+                const int rowBytes = width * channels;
+                std::vector<unsigned char>& strip = strips[s % 2];
+                if (strip.size() < static_cast<std::size_t>(rows) * rowBytes) {
+                    strip.resize(static_cast<std::size_t>(rows) * rowBytes);
+                }
+                MutableRowWindow out(ImageView(strip.data(), width, rows, channels, rowBytes),
+                                     rowBegin[s], height);
+                stages[s]->applyRows(in, out, rowBegin[s], rowEnd[s], maxima[s]);
+                in = out;
+            }
+
+            const Filter& last = *stages[stageCount - 1];
+            if (output) {
+                last.applyRows(in, MutableRowWindow(output->getView()), rowBegin[stageCount - 1],
+                               rowEnd[stageCount - 1], maxima[stageCount - 1]);
+            } else {
+                threadMax = std::max(threadMax, last.computeRowsMaximum(in, rowBegin[stageCount - 1],
+                                                                         rowEnd[stageCount - 1]));
+            }
+        }
+        std::lock_guard<std::mutex> lock(maxMutex);
+        maximum = std::max(maximum, threadMax);
+    });
+    return maximum;
+}
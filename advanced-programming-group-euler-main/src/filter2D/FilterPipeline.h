@@ -0,0 +1,157 @@
+/**
+ * @file FilterPipeline.h
+ * @brief Declaration of the FilterPipeline class, which runs a chain of 2D filters tile by tile
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef FILTER_PIPELINE_H
+#define FILTER_PIPELINE_H
+
+#include "Filter.h"
+#include "../Image.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Applies a chain of filters to an image one tile of rows at a time
+ *
+ * Applying filters one after another writes a whole intermediate image per stage. The
+ * pipeline instead splits the output into tiles of full-width rows and pushes each tile
+ * through every stage before moving on: a stage computes just the rows the next stage
+ * reads (its tile plus the next stage's halo), into a strip small enough to stay in
+ * cache. Tiles are spread across the shared ThreadPool, and apart from a few strips per
+ * thread the only images in memory are the input and the output.
+ *
+ * A stage that scales its output by a maximum over the whole image (edge detection) is
+ * run in two phases: first every tile is pushed through the stages up to it to find the
+ * maximum, then the full pass uses it. The stages before it are therefore computed twice
+ * instead of storing their output.
+ *
+ * Only filters that can work on strips of rows (Filter::getRowHalo() >= 0) can be stages.
+ * The result is identical to applying the stages in sequence, for any tile size and
+ * thread count. The pipeline is itself a Filter, so it can be applied as one step of a
+ * FilterChain.
+ */
+class FilterPipeline : public Filter {
+public:
+    static constexpr std::size_t DEFAULT_TILE_BYTES = 256 * 1024; ///< Target size of a tile's largest strip
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // CONSTRUCTORS & BUILDING THE CHAIN
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Construct an empty pipeline
+     */
+    FilterPipeline();
+
+    /**
+     * @brief Append a stage to the chain
+     *
+     * @param stage Filter to apply after the current last stage
+     * @throws std::invalid_argument If stage is null or needs the whole image at once
+     */
+    void addStage(std::unique_ptr<Filter> stage);
+
+    /**
+     * @brief Remove every stage
+     */
+    void clear();
+
+    bool empty() const;
+    std::size_t size() const;
+
+    /**
+     * @brief Set the number of rows per tile
+     *
+     * @param rows Rows per tile, or 0 to size tiles from DEFAULT_TILE_BYTES (the default)
+     * @throws std::invalid_argument If rows is negative
+     */
+    void setTileRows(int rows);
+
+    /**
+     * @brief Rows per tile for an input image
+     *
+     * @param width Width of the input
+     * @param height Height of the input
+     * @param channels Channels of the input
+     * @return int Rows per tile (between 1 and height)
+     */
+    int getTileRows(int width, int height, int channels) const;
+
+    // *******************************************************************************************
+    // -------------------------------------------------------------------------------------------
+    // APPLY FUNCTIONS
+    // -------------------------------------------------------------------------------------------
+    // *******************************************************************************************
+
+    /**
+     * @brief Apply every stage to the image
+     *
+     * Chains of two or more stages run tile by tile; a lone stage is applied with its own
+     * Filter::apply(), which has no intermediate images to save.
+     *
+     * @param input Input image
+     * @return Image The result of the last stage (a copy of the input if there are no stages)
+     */
+    Image apply(const Image& input) override;
+
+    /**
+     * @brief Apply every stage, writing the result into an existing image
+     *
+     * Once the per-thread strips have grown to the tile size, this allocates nothing.
+     *
+     * @param input Input image
+     * @param output Receives the result of the last stage; must not be `input`
+     */
+    void applyInto(const Image& input, Image& output) override;
+
+    /**
+     * @brief Apply every stage to the image tile by tile, whatever the number of stages
+     *
+     * @param input Input image
+     * @return Image The result of the last stage (a copy of the input if there are no stages)
+     */
+    Image applyTiled(const Image& input);
+
+private:
+    std::vector<std::unique_ptr<Filter>> stages; ///< Filters in the order they are applied
+    int tileRows = 0;                            ///< Rows per tile, 0 for automatic
+    std::vector<double> maxima;                  ///< Global maximum of each stage, reused per call
+
+    /**
+     * @brief Channels of the result of the first `stageCount` stages
+     */
+    int getStageChannels(int inputChannels, int stageCount) const;
+
+    /**
+     * @brief Tile by tile application into `output` (reshaped to the result's size)
+     */
+    void applyTiledInto(const Image& input, Image& output);
+
+    /**
+     * @brief Push every tile through stages [0, stageCount)
+     *
+     * @param input Input image
+     * @param stageCount Number of stages to run
+     * @param output Output of the last stage, or null to return the last stage's maximum
+     *               over the image instead of applying it
+     * @return double The maximum if output is null, 0 otherwise
+     */
+    double runTiles(const Image& input, int stageCount, Image* output) const;
+};
+
+#endif // FILTER_PIPELINE_H
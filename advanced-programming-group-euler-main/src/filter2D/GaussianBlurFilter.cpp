@@ -14,6 +14,11 @@
  */
 
 #include "GaussianBlurFilter.h"
+#include "BorderPolicy.h"
+#include "../FourierTransform.h"
+#include "../ThreadPool.h"
+
+#include <algorithm>
 
 
  // *******************************************************************************************
@@ -33,31 +38,62 @@
  * @param sigma Standard deviation for the Gaussian distribution.
  * @throws std::invalid_argument if kernelSize is even or less than 3.
  */
-GaussianBlurFilter::GaussianBlurFilter(int kernelSize, float sigma)
-    : Filter("Gaussian Blur"), kernelSize(kernelSize), sigma(sigma) {
+GaussianBlurFilter::GaussianBlurFilter(int kernelSize, float sigma, Method method)
+    : Filter("Gaussian Blur"), kernelSize(kernelSize), sigma(sigma), method(method) {
     if (kernelSize % 2 == 0 || kernelSize < 3) {
         throw std::invalid_argument("Kernel size must be odd and at least 3");
     }
+    kernel = createKernel();
 }
 
-std::vector<std::vector<double>> GaussianBlurFilter::createKernel() {
-    std::vector<std::vector<double>> kernel(kernelSize, std::vector<double>(kernelSize, 0.0));
+/**
+ * @brief Resolves Method::Auto into the implementation apply() will run.
+ * 
+ * The recursive filter models the untruncated Gaussian, so it is only chosen when the
+ * window reaches at least 3σ on each side (the truncated tail is then < 0.3% of the mass)
+ * and the kernel is large enough for its constant cost to pay off. Deriche's fit loses
+ * accuracy for very narrow Gaussians, hence the lower bound on σ. Other very large
+ * windows go through Fourier transforms, whose cost hardly depends on the kernel size.
+ * 
+ * @return Method Separable, Recursive or Fourier.
+ */
+GaussianBlurFilter::Method GaussianBlurFilter::getEffectiveMethod() const {
+    if (method != Method::Auto) {
+        return method;
+    }
+    int half = kernelSize / 2;
+    bool coversTail = half >= 3.0f * sigma;
+    if (kernelSize >= RECURSIVE_MIN_KERNEL_SIZE && coversTail && sigma >= 1.0f) {
+        return Method::Recursive;
+    }
+    if (kernelSize >= FOURIER_MIN_KERNEL_SIZE) {
+        return Method::Fourier;
+    }
+    return Method::Separable;
+}
+
+/**
+ * @brief Creates the normalised 1D Gaussian kernel.
+ * 
+ * The 2D kernel exp(-(x²+y²)/2σ²) normalised over the window is exactly the outer
+ * product of this kernel with itself.
+ * 
+ * @return std::vector<double> kernelSize weights summing to 1.
+ */
+std::vector<double> GaussianBlurFilter::createKernel() const {
+    std::vector<double> kernel(kernelSize, 0.0);
     int half = kernelSize / 2;
     double sum = 0.0;
     double s = 2.0 * sigma * sigma;
 
-    for (int y = -half; y <= half; y++) {
-        for (int x = -half; x <= half; x++) {
-            double value = exp(-(x*x + y*y) / s) / (M_PI * s);
-            kernel[y+half][x+half] = value;
-            sum += value;
-        }
+    for (int i = -half; i <= half; i++) {
+        double value = exp(-(i*i) / s);
+        kernel[i+half] = value;
+        sum += value;
     }
     // Normalize the kernel
-    for (int i = 0; i < kernelSize; i++) {
-        for (int j = 0; j < kernelSize; j++) {
-            kernel[i][j] /= sum;
-        }
+    for (double& value : kernel) {
+        value /= sum;
     }
     return kernel;
 }
@@ -76,40 +112,282 @@ std::vector<std::vector<double>> GaussianBlurFilter::createKernel() {
  * @return Image The resulting blurred image.
  */
 Image GaussianBlurFilter::apply(const Image& input) {
+    Method effective = getEffectiveMethod();
+    if (effective == Method::Recursive) {
+        return applyRecursive(input);
+    }
+    // Separable passes cost 2 * kernelSize taps per sample; small images may not pay for transforms
+    if (effective == Method::Fourier &&
+        (method == Method::Fourier ||
+         FourierConvolution::isCheaper(2.0 * kernelSize, input.getWidth(), input.getHeight(), 1,
+                                       kernelSize, kernelSize, 1))) {
+        return applyFourier(input);
+    }
+    return applySeparable(input);
+}
+
+/**
+ * @brief Separable implementation: horizontal 1D pass into a ring of kernelSize rows,
+ * then a vertical 1D pass over the ring.
+ * 
+ * Out-of-bounds taps are skipped in both passes, which is exactly the zero padding the
+ * 2D kernel used. Results are truncated to 8 bits like before.
+ * 
+ * @param input The input image to process.
+ * @return Image The resulting blurred image.
+ */
+Image GaussianBlurFilter::applySeparable(const Image& input) const {
+    Image output(input.getWidth(), input.getHeight(), input.getChannels());
+    RowWindow in(input.getView());
+    MutableRowWindow out(output.getView());
+
+    // Bands of output rows are independent: each one blurs the input rows it needs itself
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        applyRows(in, out, bandBegin, bandEnd);
+    });
+    return output;
+}
+
+// The separable method reads half a kernel above and below; the others whole columns
+int GaussianBlurFilter::getRowHalo() const {
+    if (getEffectiveMethod() == Method::Recursive || getEffectiveMethod() == Method::Fourier) {
+        return -1;
+    }
+    return kernelSize / 2;
+}
+
+/**
+ * @brief Separable blur of rows [rowBegin, rowEnd), see applySeparable().
+ * 
+ * @param input Input rows [rowBegin - kernelSize / 2, rowEnd + kernelSize / 2), clipped to the image.
+ * @param output Output window holding rows [rowBegin, rowEnd).
+ * @param rowBegin First row to blur.
+ * @param rowEnd One past the last row to blur.
+ * @throws std::logic_error If the effective method is Recursive.
+ */
+void GaussianBlurFilter::applyRows(const RowWindow& input, const MutableRowWindow& output,
+                                   int rowBegin, int rowEnd, double) const {
+    if (getEffectiveMethod() == Method::Recursive) {
+        throw std::logic_error("Recursive Gaussian blur cannot be applied to a strip of rows");
+    }
     int width = input.getWidth();
     int height = input.getHeight();
     int channels = input.getChannels();
-    Image output(width, height, channels);
 
-    auto kernel = createKernel();
-    int half = kernelSize / 2;
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            double sumR = 0, sumG = 0, sumB = 0, sumA = 0;
-            for (int j = -half; j <= half; j++) {
-                for (int i = -half; i <= half; i++) {
-                    int nx = x + i;
-                    int ny = y + j;
-                    if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                        Pixel p = input.getPixel(nx, ny);
-                        double weight = kernel[j+half][i+half];
-                        sumR += p.getR() * weight;
-                        sumG += p.getG() * weight;
-                        sumB += p.getB() * weight;
-                        sumA += p.getA() * weight;
+    const int half = kernelSize / 2;
+    const int rowSamples = width * channels;
+
+    // Per-thread scratch, grown once and reused by every call
+    static thread_local std::vector<double> ring;
+    static thread_local std::vector<double> acc;
+
+    // Horizontally blurred rows, row r kept in slot r % kernelSize. Interior columns use
+    // every tap; the border strips skip the taps outside the row (zero padding).
+    ring.resize(static_cast<size_t>(kernelSize) * rowSamples);
+    const BorderPolicy::Span interior = BorderPolicy::interior(width, half, half);
+    auto blurRow = [&](int r) {
+        const unsigned char* src = input.getRow(r);
+        double* dst = &ring[static_cast<size_t>(r % kernelSize) * rowSamples];
+        auto blurColumns = [&](int xBegin, int xEnd) {
+            for (int x = xBegin; x < xEnd; x++) {
+                int lo = std::max(-half, -x);
+                int hi = std::min(half, width - 1 - x);
+                for (int c = 0; c < channels; c++) {
+                    double sum = 0.0;
+                    for (int i = lo; i <= hi; i++) {
+                        sum += src[(x + i) * channels + c] * kernel[i + half];
                     }
+                    dst[x * channels + c] = sum;
                 }
             }
-            output.setPixel(x, y, Pixel(
-                static_cast<unsigned char>(sumR),
-                static_cast<unsigned char>(sumG),
-                static_cast<unsigned char>(sumB),
-                static_cast<unsigned char>(sumA)
-            ));
+        };
+        blurColumns(0, interior.begin);
+        for (int x = interior.begin; x < interior.end; x++) {
+            for (int c = 0; c < channels; c++) {
+                double sum = 0.0;
+                for (int i = -half; i <= half; i++) {
+                    sum += src[(x + i) * channels + c] * kernel[i + half];
+                }
+                dst[x * channels + c] = sum;
+            }
+        }
+        blurColumns(interior.end, width);
+    };
+
+    acc.resize(rowSamples);
+    int nextRow = std::max(rowBegin - half, 0); // Next input row to blur horizontally
+    for (int y = rowBegin; y < rowEnd; y++) {
+        int lo = std::max(-half, -y);
+        int hi = std::min(half, height - 1 - y);
+        while (nextRow <= y + hi) {
+            blurRow(nextRow++);
+        }
+
+        std::fill(acc.begin(), acc.end(), 0.0);
+        for (int j = lo; j <= hi; j++) {
+            const double* row = &ring[static_cast<size_t>((y + j) % kernelSize) * rowSamples];
+            double weight = kernel[j + half];
+            for (int i = 0; i < rowSamples; i++) {
+                acc[i] += row[i] * weight;
+            }
+        }
+
+        unsigned char* dst = output.getRow(y);
+        for (int i = 0; i < rowSamples; i++) {
+            dst[i] = static_cast<unsigned char>(std::clamp(acc[i], 0.0, 255.0));
         }
     }
+}
+
+/**
+ * @brief Recursive implementation (Deriche, 1993, fourth order).
+ * 
+ * The Gaussian is split into a causal part (n >= 0) and an anti-causal part (n < 0), each
+ * a fourth-order recursion run over the *input* samples, so the cost per pixel does not
+ * depend on σ or the kernel size. Both recursions start from zero state, which is exactly
+ * the zero padding of the direct filter at either end of a line.
+ * 
+ * @param input The input image to process.
+ * @return Image The resulting blurred image.
+ */
+Image GaussianBlurFilter::applyRecursive(const Image& input) const {
+    int width = input.getWidth();
+    int height = input.getHeight();
+    int channels = input.getChannels();
+    Image output(width, height, channels);
+
+    // Deriche's fit of the unit Gaussian, scaled to sigma
+    const double a0 = 1.680, a1 = 3.735, b0 = 1.783, b1 = 1.723;
+    const double c0 = -0.6803, c1 = -0.2598, w0 = 0.6318, w1 = 1.997;
+    const double sig = sigma;
+    const double cw0 = std::cos(w0 / sig), sw0 = std::sin(w0 / sig);
+    const double cw1 = std::cos(w1 / sig), sw1 = std::sin(w1 / sig);
+    const double e0 = std::exp(-b0 / sig), e1 = std::exp(-b1 / sig);
+
+    double n[4], d[4], m[4];
+    n[0] = a0 + c0;
+    n[1] = e1 * (c1 * sw1 - (c0 + 2.0 * a0) * cw1) + e0 * (a1 * sw0 - (2.0 * c0 + a0) * cw0);
+    n[2] = 2.0 * e0 * e1 * ((a0 + c0) * cw1 * cw0 - a1 * cw1 * sw0 - c1 * cw0 * sw1)
+           + c0 * e0 * e0 + a0 * e1 * e1;
+    n[3] = e1 * e0 * e0 * (c1 * sw1 - c0 * cw1) + e0 * e1 * e1 * (a1 * sw0 - a0 * cw0);
+    d[0] = -2.0 * e1 * cw1 - 2.0 * e0 * cw0;
+    d[1] = 4.0 * cw1 * cw0 * e0 * e1 + e1 * e1 + e0 * e0;
+    d[2] = -2.0 * cw0 * e0 * e1 * e1 - 2.0 * cw1 * e1 * e0 * e0;
+    d[3] = e0 * e0 * e1 * e1;
+    for (int i = 0; i < 3; i++) {
+        m[i] = n[i + 1] - d[i] * n[0];
+    }
+    m[3] = -d[3] * n[0];
+
+    // Normalise so the response sums to one
+    double denominator = 1.0 + d[0] + d[1] + d[2] + d[3];
+    double gain = (n[0] + n[1] + n[2] + n[3] + m[0] + m[1] + m[2] + m[3]) / denominator;
+    for (int i = 0; i < 4; i++) {
+        n[i] /= gain;
+        m[i] /= gain;
+    }
+
+    // Filter `length` samples spaced `step` apart from `src` into `dst`
+    // (causal and anti-causal parts summed); `causal` is scratch space of at least `length`
+    auto filterLine = [&](const float* src, float* dst, int length, std::ptrdiff_t step, double* causal) {
+        double x1 = 0, x2 = 0, x3 = 0, y1 = 0, y2 = 0, y3 = 0, y4 = 0;
+        for (int k = 0; k < length; k++) {
+            double x0 = src[k * step];
+            double y0 = n[0] * x0 + n[1] * x1 + n[2] * x2 + n[3] * x3
+                      - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+            causal[k] = y0;
+            x3 = x2; x2 = x1; x1 = x0;
+            y4 = y3; y3 = y2; y2 = y1; y1 = y0;
+        }
+        double x4 = 0;
+        x1 = x2 = x3 = 0;
+        y1 = y2 = y3 = y4 = 0;
+        for (int k = length - 1; k >= 0; k--) {
+            double y0 = m[0] * x1 + m[1] * x2 + m[2] * x3 + m[3] * x4
+                      - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+            x4 = x3; x3 = x2; x2 = x1; x1 = src[k * step];
+            y4 = y3; y3 = y2; y2 = y1; y1 = y0;
+            dst[k * step] = static_cast<float>(causal[k] + y0);
+        }
+    };
+
+    // Horizontal pass, one line per row and channel (rows split across threads)
+    const int rowSamples = width * channels;
+    std::vector<float> samples(static_cast<size_t>(height) * rowSamples);
+    std::vector<float> blurred(samples.size());
+    ThreadPool& pool = ThreadPool::shared();
+    pool.parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        std::vector<double> causal(width);
+        for (int y = bandBegin; y < bandEnd; y++) {
+            const unsigned char* src = input.getRow(y);
+            float* row = &samples[static_cast<size_t>(y) * rowSamples];
+            for (int i = 0; i < rowSamples; i++) {
+                row[i] = src[i];
+            }
+            for (int c = 0; c < channels; c++) {
+                filterLine(row + c, &blurred[static_cast<size_t>(y) * rowSamples] + c, width, channels, causal.data());
+            }
+        }
+    });
+
+    // Vertical pass, one line per column and channel (columns split across threads)
+    pool.parallelFor(0, rowSamples, [&](int bandBegin, int bandEnd) {
+        std::vector<double> causal(height);
+        for (int i = bandBegin; i < bandEnd; i++) {
+            filterLine(&blurred[i], &samples[i], height, rowSamples, causal.data());
+        }
+    });
+    pool.parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; y++) {
+            const float* row = &samples[static_cast<size_t>(y) * rowSamples];
+            unsigned char* dst = output.getRow(y);
+            for (int i = 0; i < rowSamples; i++) {
+                dst[i] = static_cast<unsigned char>(std::clamp(row[i], 0.0f, 255.0f));
+            }
+        }
+    });
     return output;
 }
 
+/**
+ * @brief Fourier implementation: the separable kernel correlated with the zero-padded
+ * image through FourierConvolution, one channel at a time.
+ * 
+ * Zero padding gives the same darkened borders as the skipped taps of the separable
+ * method. Results are truncated to 8 bits like the other methods.
+ * 
+ * @param input The input image to process.
+ * @return Image The resulting blurred image.
+ */
+Image GaussianBlurFilter::applyFourier(const Image& input) const {
+    int width = input.getWidth();
+    int height = input.getHeight();
+    int channels = input.getChannels();
+    Image output(width, height, channels);
+
+    const int half = kernelSize / 2;
+    std::vector<float> taps(kernel.begin(), kernel.end());
+    FourierConvolution convolution(width, height, 1, taps, taps, std::vector<float>{1.0f});
+    const int gridWidth = convolution.getGridWidth();
 
+    for (int c = 0; c < channels; c++) {
+        convolution.correlate(
+            [&](int y, int, float* row) {
+                std::fill(row, row + gridWidth, 0.0f);
+                if (y < half || y >= height + half) {
+                    return;
+                }
+                const unsigned char* src = input.getRow(y - half);
+                for (int x = 0; x < width; x++) {
+                    row[x + half] = src[x * channels + c];
+                }
+            },
+            [&](int y, int, const float* row) {
+                unsigned char* dst = output.getRow(y);
+                for (int x = 0; x < width; x++) {
+                    dst[x * channels + c] = static_cast<unsigned char>(std::clamp(row[x], 0.0f, 255.0f));
+                }
+            });
+    }
+    return output;
+}
@@ -25,9 +25,34 @@
 
 /**
  * @brief Gaussian blur filter that replaces each pixel with a weighted average of its neighbors.
+ *
+ * The kernel exp(-(x²+y²)/2σ²) is normalised over the kernelSize x kernelSize window and
+ * taps falling outside the image contribute nothing (no renormalisation, so borders darken).
+ * Two implementations are available:
+ * - Separable: one horizontal and one vertical 1D pass, 2k multiply-adds per pixel.
+ *   Equal to the full 2D convolution up to floating point rounding.
+ * - Recursive: Deriche's fourth-order recursive (IIR) Gaussian, constant cost per pixel
+ *   whatever the kernel size. It approximates the untruncated Gaussian, so it is only picked
+ *   automatically when the window covers at least ±3σ.
+ * - Fourier: the exact truncated kernel through Fourier transforms of the whole image
+ *   (see FourierConvolution), for large windows that cut the Gaussian short. Within one
+ *   grey level of the separable method.
  */
 class GaussianBlurFilter : public Filter {
 public:
+    /**
+     * @brief Implementation used by apply()
+     */
+    enum class Method {
+        Auto,      ///< Recursive for large kernels covering ±3σ, Fourier for other very large ones, separable otherwise
+        Separable, ///< Two 1D convolution passes
+        Recursive, ///< Deriche recursive Gaussian
+        Fourier    ///< Fourier transforms of the whole image
+    };
+
+    static constexpr int RECURSIVE_MIN_KERNEL_SIZE = 15; ///< Smallest kernel Auto runs recursively
+    static constexpr int FOURIER_MIN_KERNEL_SIZE = 31;   ///< Smallest kernel Auto may run through transforms
+
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
     // CONSTRUCTORS
@@ -38,9 +63,20 @@ public:
      * 
      * @param kernelSize Size of the convolution kernel (must be odd and >= 3).
      * @param sigma Standard deviation for the Gaussian distribution (default 2.0).
+     * @param method Implementation to use (default: chosen from kernel size and sigma).
      * @throws std::invalid_argument If kernelSize is even or less than 3.
      */
-    explicit GaussianBlurFilter(int kernelSize, float sigma = 2.0f);
+    explicit GaussianBlurFilter(int kernelSize, float sigma = 2.0f, Method method = Method::Auto);
+
+    /**
+     * @brief Get the implementation apply() will actually run (never Method::Auto).
+     *
+     * Method::Fourier chosen by Auto still falls back to the separable passes on images
+     * where FourierConvolution::isCheaper() says they cost less.
+     *
+     * @return Method Separable, Recursive or Fourier.
+     */
+    Method getEffectiveMethod() const;
     // *******************************************************************************************
     // -------------------------------------------------------------------------------------------
     // APPLY FUNCTION
@@ -54,10 +90,46 @@ public:
      */
     Image apply(const Image& input) override;
 
+    /**
+     * @brief Rows above and below an output row inside the window (kernelSize / 2)
+     *
+     * @return int The halo, or -1 for the recursive and Fourier methods, which need the whole image.
+     */
+    int getRowHalo() const override;
+
+    /**
+     * @brief Blur rows [rowBegin, rowEnd) with the separable method (see Filter::applyRows)
+     *
+     * @throws std::logic_error If the effective method is Recursive.
+     */
+    void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                   int rowBegin, int rowEnd, double globalMaximum = 0) const override;
+
 private:
     int kernelSize;
     float sigma;
-    std::vector<std::vector<double>> createKernel();
+    Method method;
+    std::vector<double> kernel; ///< Normalised 1D kernel of the separable method
+
+    /**
+     * @brief Create the normalised 1D kernel; the 2D kernel is its outer product.
+     */
+    std::vector<double> createKernel() const;
+
+    /**
+     * @brief Horizontal then vertical 1D convolution, skipping out-of-bounds taps.
+     */
+    Image applySeparable(const Image& input) const;
+
+    /**
+     * @brief Deriche recursive Gaussian along rows then columns.
+     */
+    Image applyRecursive(const Image& input) const;
+
+    /**
+     * @brief Correlation with the 2D kernel through Fourier transforms, zero-padded.
+     */
+    Image applyFourier(const Image& input) const;
 };
 
 #endif // GAUSSIAN_BLUR_FILTER_H
@@ -0,0 +1,236 @@
+/**
+ * @file GradientKernels.cpp
+ * @brief Implementation of the GradientKernels class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "GradientKernels.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+// The SIMD versions are compiled with per-function target attributes, so the rest of the
+// program still runs on any x86-64 CPU
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GRADIENT_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    using SpanFunction = void (*)(const unsigned char* const*, int, int, const int*, const int*,
+                                  int, int, int*);
+
+    // Portable version, also used for the columns the SIMD versions leave over
+    void gradientSpanScalar(const unsigned char* const* rows, int kernelSize, int origin,
+                            const int* kernelX, const int* kernelY, int xBegin, int xEnd,
+                            int* magnitudes) {
+        for (int x = xBegin; x < xEnd; ++x) {
+            int gx = 0;
+            int gy = 0;
+            for (int ky = 0; ky < kernelSize; ++ky) {
+                const unsigned char* row = rows[ky] + x - origin;
+                for (int kx = 0; kx < kernelSize; ++kx) {
+                    int pixelValue = row[kx];
+                    gx += pixelValue * kernelX[ky * kernelSize + kx];
+                    gy += pixelValue * kernelY[ky * kernelSize + kx];
+                }
+            }
+            magnitudes[x] = std::abs(gx) + std::abs(gy);
+        }
+    }
+
+    /**
+     * @brief Whether |Gx| + |Gy| fits in a signed 16-bit lane for any 8-bit input
+     *
+     * Each partial sum is bounded by the sum of |tap| * 255, so if both kernels keep that
+     * below 2^14 no lane can overflow, including the final addition of the two magnitudes.
+     */
+    bool fitsSixteenBits(int kernelSize, const int* kernelX, const int* kernelY) {
+        int taps = kernelSize * kernelSize;
+        if (taps > GradientKernels::MAX_SIMD_TAPS) {
+            return false;
+        }
+        long sumX = 0;
+        long sumY = 0;
+        for (int i = 0; i < taps; ++i) {
+            sumX += std::labs(kernelX[i]);
+            sumY += std::labs(kernelY[i]);
+        }
+        return sumX * 255 < (1 << 14) && sumY * 255 < (1 << 14);
+    }
+
+#ifdef GRADIENT_KERNELS_X86
+    __attribute__((target("sse4.1")))
+    void gradientSpanSse41(const unsigned char* const* rows, int kernelSize, int origin,
+                           const int* kernelX, const int* kernelY, int xBegin, int xEnd,
+                           int* magnitudes) {
+        // Non-zero taps and their broadcast weights
+        const unsigned char* tapRows[GradientKernels::MAX_SIMD_TAPS];
+        __m128i weightsX[GradientKernels::MAX_SIMD_TAPS];
+        __m128i weightsY[GradientKernels::MAX_SIMD_TAPS];
+        int taps = 0;
+        for (int ky = 0; ky < kernelSize; ++ky) {
+            for (int kx = 0; kx < kernelSize; ++kx) {
+                int tap = ky * kernelSize + kx;
+                if (kernelX[tap] != 0 || kernelY[tap] != 0) {
+                    tapRows[taps] = rows[ky] + kx - origin;
+                    weightsX[taps] = _mm_set1_epi16(static_cast<short>(kernelX[tap]));
+                    weightsY[taps] = _mm_set1_epi16(static_cast<short>(kernelY[tap]));
+                    ++taps;
+                }
+            }
+        }
+
+        int x = xBegin;
+        for (; x + 8 <= xEnd; x += 8) {
+            __m128i gx = _mm_setzero_si128();
+            __m128i gy = _mm_setzero_si128();
+            for (int t = 0; t < taps; ++t) {
+                __m128i pixels = _mm_cvtepu8_epi16(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tapRows[t] + x)));
+                gx = _mm_add_epi16(gx, _mm_mullo_epi16(pixels, weightsX[t]));
+                gy = _mm_add_epi16(gy, _mm_mullo_epi16(pixels, weightsY[t]));
+            }
+            __m128i magnitude = _mm_add_epi16(_mm_abs_epi16(gx), _mm_abs_epi16(gy));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(magnitudes + x), _mm_cvtepi16_epi32(magnitude));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(magnitudes + x + 4),
+                             _mm_cvtepi16_epi32(_mm_srli_si128(magnitude, 8)));
+        }
+        gradientSpanScalar(rows, kernelSize, origin, kernelX, kernelY, x, xEnd, magnitudes);
+    }
+
+    __attribute__((target("avx2")))
+    void gradientSpanAvx2(const unsigned char* const* rows, int kernelSize, int origin,
+                          const int* kernelX, const int* kernelY, int xBegin, int xEnd,
+                          int* magnitudes) {
+        // Non-zero taps and their broadcast weights
+        const unsigned char* tapRows[GradientKernels::MAX_SIMD_TAPS];
+        __m256i weightsX[GradientKernels::MAX_SIMD_TAPS];
+        __m256i weightsY[GradientKernels::MAX_SIMD_TAPS];
+        int taps = 0;
+        for (int ky = 0; ky < kernelSize; ++ky) {
+            for (int kx = 0; kx < kernelSize; ++kx) {
+                int tap = ky * kernelSize + kx;
+                if (kernelX[tap] != 0 || kernelY[tap] != 0) {
+                    tapRows[taps] = rows[ky] + kx - origin;
+                    weightsX[taps] = _mm256_set1_epi16(static_cast<short>(kernelX[tap]));
+                    weightsY[taps] = _mm256_set1_epi16(static_cast<short>(kernelY[tap]));
+                    ++taps;
+                }
+            }
+        }
+
+        int x = xBegin;
+        for (; x + 16 <= xEnd; x += 16) {
+            __m256i gx = _mm256_setzero_si256();
+            __m256i gy = _mm256_setzero_si256();
+            for (int t = 0; t < taps; ++t) {
+                __m256i pixels = _mm256_cvtepu8_epi16(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(tapRows[t] + x)));
+                gx = _mm256_add_epi16(gx, _mm256_mullo_epi16(pixels, weightsX[t]));
+                gy = _mm256_add_epi16(gy, _mm256_mullo_epi16(pixels, weightsY[t]));
+            }
+            __m256i magnitude = _mm256_add_epi16(_mm256_abs_epi16(gx), _mm256_abs_epi16(gy));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(magnitudes + x),
+                                _mm256_cvtepi16_epi32(_mm256_castsi256_si128(magnitude)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(magnitudes + x + 8),
+                                _mm256_cvtepi16_epi32(_mm256_extracti128_si256(magnitude, 1)));
+        }
+        gradientSpanScalar(rows, kernelSize, origin, kernelX, kernelY, x, xEnd, magnitudes);
+    }
+#endif
+
+    SpanFunction getFunction(GradientKernels::InstructionSet set) {
+        switch (set) {
+#ifdef GRADIENT_KERNELS_X86
+            case GradientKernels::InstructionSet::AVX2: return gradientSpanAvx2;
+            case GradientKernels::InstructionSet::SSE41: return gradientSpanSse41;
+#endif
+            default: return gradientSpanScalar;
+        }
+    }
+
+    GradientKernels::InstructionSet detectBest() {
+        if (GradientKernels::isSupported(GradientKernels::InstructionSet::AVX2)) {
+            return GradientKernels::InstructionSet::AVX2;
+        }
+        if (GradientKernels::isSupported(GradientKernels::InstructionSet::SSE41)) {
+            return GradientKernels::InstructionSet::SSE41;
+        }
+        return GradientKernels::InstructionSet::SCALAR;
+    }
+
+    // Chosen once at start-up
+    GradientKernels::InstructionSet activeSet = detectBest();
+    SpanFunction activeFunction = getFunction(activeSet);
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// GRADIENT MAGNITUDES
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+// Kernels whose sums could overflow 16 bits always take the scalar loop
+void GradientKernels::gradientSpan(const unsigned char* const* rows, int kernelSize, int origin,
+                                   const int* kernelX, const int* kernelY, int xBegin, int xEnd,
+                                   int* magnitudes) {
+    if (activeSet == InstructionSet::SCALAR || !fitsSixteenBits(kernelSize, kernelX, kernelY)) {
+        gradientSpanScalar(rows, kernelSize, origin, kernelX, kernelY, xBegin, xEnd, magnitudes);
+    } else {
+        activeFunction(rows, kernelSize, origin, kernelX, kernelY, xBegin, xEnd, magnitudes);
+    }
+}
+
+// *******************************************************************************************
+// -------------------------------------------------------------------------------------------
+// DISPATCH
+// -------------------------------------------------------------------------------------------
+// *******************************************************************************************
+
+bool GradientKernels::isSupported(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::SCALAR:
+            return true;
+#ifdef GRADIENT_KERNELS_X86
+        case InstructionSet::SSE41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1");
+        case InstructionSet::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+GradientKernels::InstructionSet GradientKernels::getActive() {
+    return activeSet;
+}
+
+void GradientKernels::setActive(InstructionSet set) {
+    if (!isSupported(set)) {
+        throw std::invalid_argument(std::string("Instruction set not supported: ") + getName(set));
+    }
+    activeSet = set;
+    activeFunction = getFunction(set);
+}
+
+const char* GradientKernels::getName(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::SSE41: return "sse4.1";
+        case InstructionSet::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
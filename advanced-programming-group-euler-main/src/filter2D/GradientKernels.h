@@ -0,0 +1,93 @@
+/**
+ * @file GradientKernels.h
+ * @brief Declaration of the GradientKernels class, the vectorised inner loop of edge detection
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#ifndef GRADIENT_KERNELS_H
+#define GRADIENT_KERNELS_H
+
+/**
+ * @brief Gradient magnitudes |Gx| + |Gy| of a span of greyscale pixels, with SIMD versions
+ *
+ * The edge detection filters (Sobel, Prewitt, Scharr, Roberts Cross) spend their time
+ * evaluating two small integer kernels at every pixel. Away from the left and right
+ * borders no tap needs clamping, so a row's interior can be evaluated many pixels at a
+ * time: samples are widened to 16 bits, multiplied by each non-zero tap and summed, 16
+ * pixels per instruction with AVX2 and 8 with SSE4.1. Every sum is exact in 16 bits (the
+ * SIMD paths are only used when the kernels guarantee it), so all versions give the same
+ * magnitudes as the scalar loop.
+ *
+ * The version is picked once at start-up from the instruction sets the CPU supports; the
+ * scalar version is always available and is the only one on non-x86 builds.
+ */
+class GradientKernels {
+public:
+    /**
+     * @brief Implementations of gradientSpan()
+     */
+    enum class InstructionSet {
+        SCALAR,  ///< Portable loop
+        SSE41,   ///< 8 pixels per instruction (x86 with SSE4.1)
+        AVX2     ///< 16 pixels per instruction (x86 with AVX2)
+    };
+
+    /**
+     * @brief Largest number of taps (kernelSize * kernelSize) the SIMD versions handle
+     */
+    static constexpr int MAX_SIMD_TAPS = 25;
+
+    /**
+     * @brief Magnitudes |Gx| + |Gy| of columns [xBegin, xEnd) of one output row
+     *
+     * Every tap must lie inside the rows, i.e. xBegin >= origin and
+     * xEnd + kernelSize - 1 - origin <= the row width.
+     *
+     * @param rows kernelSize row pointers; rows[ky] is the row under kernel row ky
+     * @param kernelSize Width and height of the kernels
+     * @param origin Kernel tap (origin, origin) lies on the output pixel
+     * @param kernelX Horizontal kernel, row-major
+     * @param kernelY Vertical kernel, row-major
+     * @param xBegin First column
+     * @param xEnd One past the last column
+     * @param magnitudes Receives the magnitude of column x at magnitudes[x]
+     */
+    static void gradientSpan(const unsigned char* const* rows, int kernelSize, int origin,
+                             const int* kernelX, const int* kernelY, int xBegin, int xEnd,
+                             int* magnitudes);
+
+    /**
+     * @brief Whether this build and CPU can run an instruction set
+     */
+    static bool isSupported(InstructionSet set);
+
+    /**
+     * @brief Instruction set gradientSpan() currently uses (the best supported one by default)
+     */
+    static InstructionSet getActive();
+
+    /**
+     * @brief Choose the instruction set used by gradientSpan()
+     *
+     * Meant for tests and benchmarks; must not be called while a filter is running.
+     *
+     * @throws std::invalid_argument If the set is not supported
+     */
+    static void setActive(InstructionSet set);
+
+    /**
+     * @brief Name of an instruction set ("scalar", "sse4.1", "avx2")
+     */
+    static const char* getName(InstructionSet set);
+};
+
+#endif // GRADIENT_KERNELS_H
@@ -14,6 +14,11 @@
  */
 
  #include "MedianBlurFilter.h"
+#include "BorderPolicy.h"
+#include "../MedianHistogram.h"
+#include "../ThreadPool.h"
+
+#include <cstdint>
 
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
@@ -43,55 +48,144 @@ MedianBlurFilter::MedianBlurFilter(int kernelSize)
 // -------------------------------------------------------------------------------------------
 // *******************************************************************************************
 
+namespace {
+    constexpr int BINS = MedianHistogram::BINS;
+    constexpr int COARSE_SHIFT = MedianHistogram::COARSE_SHIFT;
+    constexpr int COARSE_BINS = MedianHistogram::COARSE_BINS;
+
+    /// Window heights up to this add/remove single samples (Huang); taller windows
+    /// add/remove whole column histograms (Perreault-Hebert)
+    constexpr int SAMPLE_UPDATE_MAX_ROWS = 7;
+
+    /**
+     * @brief Median filters one channel of `input` into the same channel of `output`, for
+     * output rows [rowBegin, rowEnd).
+     *
+     * The window is clipped to the image, exactly like the sorted reference: the result is
+     * the element at index n/2 of the n in-bounds samples.
+     */
+    void medianChannel(const RowWindow& input, const MutableRowWindow& output, int channel,
+                       int kernelSize, int rowBegin, int rowEnd) {
+        const int width = input.getWidth();
+        const int height = input.getHeight();
+        const int channels = input.getChannels();
+        const int half = kernelSize / 2;
+        const bool columnHistograms = std::min(kernelSize, height) > SAMPLE_UPDATE_MAX_ROWS;
+
+        // Per-column histograms over the rows currently in the window (fine and coarse),
+        // per-thread scratch grown once and reused by every call
+        static thread_local std::vector<std::uint16_t> colFine;
+        static thread_local std::vector<std::uint16_t> colCoarse;
+        if (columnHistograms) {
+            colFine.assign(static_cast<size_t>(width) * BINS, 0);
+            colCoarse.assign(static_cast<size_t>(width) * COARSE_BINS, 0);
+        }
+        auto updateColumns = [&](int row, int delta) {
+            const unsigned char* src = input.getRow(row) + channel;
+            for (int x = 0; x < width; x++) {
+                unsigned char v = src[x * channels];
+                colFine[static_cast<size_t>(x) * BINS + v] += delta;
+                colCoarse[static_cast<size_t>(x) * COARSE_BINS + (v >> COARSE_SHIFT)] += delta;
+            }
+        };
+
+        MedianHistogram window;
+        int topRow = std::max(rowBegin - half, 0); // First row in the column histograms
+        int nextRow = topRow;                      // Next row to enter the column histograms
+        for (int y = rowBegin; y < rowEnd; y++) {
+            const int first = std::max(y - half, 0);
+            const int last = std::min(y + half, height - 1);
+            const int rows = last - first + 1;
+            if (columnHistograms) {
+                for (; topRow < first; topRow++) updateColumns(topRow, -1);
+                for (; nextRow <= last; nextRow++) updateColumns(nextRow, +1);
+            }
+
+            auto addColumn = [&](int x) {
+                if (columnHistograms) {
+                    window.addColumn(&colFine[static_cast<size_t>(x) * BINS],
+                                     &colCoarse[static_cast<size_t>(x) * COARSE_BINS]);
+                } else {
+                    for (int r = first; r <= last; r++) window.addSample(input.getRow(r)[x * channels + channel]);
+                }
+            };
+            auto removeColumn = [&](int x) {
+                if (columnHistograms) {
+                    window.removeColumn(&colFine[static_cast<size_t>(x) * BINS],
+                                        &colCoarse[static_cast<size_t>(x) * COARSE_BINS]);
+                } else {
+                    for (int r = first; r <= last; r++) window.removeSample(input.getRow(r)[x * channels + channel]);
+                }
+            };
+
+            window.clear();
+            for (int x = 0; x < std::min(half, width); x++) addColumn(x);
+
+            // Interior columns have a full window that both gains and loses a column; the
+            // border strips clip the window to the image
+            unsigned char* dst = output.getRow(y) + channel;
+            auto borderColumn = [&](int x) {
+                if (x + half < width) addColumn(x + half);
+                if (x - half - 1 >= 0) removeColumn(x - half - 1);
+                const int cols = std::min(x + half, width - 1) - std::max(x - half, 0) + 1;
+                dst[x * channels] = window.select(static_cast<std::uint32_t>(cols * rows) / 2);
+            };
+            const BorderPolicy::Span interior = BorderPolicy::interior(width, half + 1, half);
+            const std::uint32_t interiorRank = static_cast<std::uint32_t>(kernelSize * rows) / 2;
+            for (int x = 0; x < interior.begin; x++) borderColumn(x);
+            for (int x = interior.begin; x < interior.end; x++) {
+                addColumn(x + half);
+                removeColumn(x - half - 1);
+                dst[x * channels] = window.select(interiorRank);
+            }
+            for (int x = interior.end; x < width; x++) borderColumn(x);
+        }
+    }
+}
+
 /**
  * @brief Applies the median blur filter to the input image.
  * 
- * For each pixel in the input image, the method gathers the pixel values from the neighborhood
- * defined by the kernel. It then sorts the values of each color channel separately and selects
- * the median value.
+ * For each pixel in the input image, the method takes the median of the in-bounds pixel values
+ * in the kernel neighbourhood, separately for each colour channel.
+ * 
+ * Instead of sorting every neighbourhood, a 256-bin histogram of the window slides along each
+ * row (Huang): the column entering the window is added, the one leaving is removed, and the
+ * median is tracked incrementally. For tall windows the columns are themselves kept as
+ * histograms that slide down the image (Perreault & Hébert), so moving the window costs a
+ * constant number of histogram operations whatever the kernel size. Short windows update the
+ * histogram sample by sample, which is cheaper for the common 3x3 and 5x5 kernels.
  * 
  * @param input The input image to process.
  * @return Image The resulting blurred image.
  */
 Image MedianBlurFilter::apply(const Image& input) {
-    int width = input.getWidth();
-    int height = input.getHeight();
-    int channels = input.getChannels();
-    Image output(width, height, channels);
-
-    int half = kernelSize / 2;
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            // Vectors to store neighbor channel values
-            std::vector<unsigned char> reds, greens, blues, alphas;
-            for (int j = -half; j <= half; j++) {
-                for (int i = -half; i <= half; i++) {
-                    int nx = x + i;
-                    int ny = y + j;
-                    if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                        Pixel p = input.getPixel(nx, ny);
-                        reds.push_back(p.getR());
-                        greens.push_back(p.getG());
-                        blues.push_back(p.getB());
-                        alphas.push_back(p.getA());
-                    }
-                }
-            }
-            // Sort each vector and take the median value
-            std::sort(reds.begin(), reds.end());
-            std::sort(greens.begin(), greens.end());
-            std::sort(blues.begin(), blues.end());
-            std::sort(alphas.begin(), alphas.end());
-            
-            size_t medianIndex = reds.size() / 2;
-            output.setPixel(x, y, Pixel(
-                reds[medianIndex],
-                greens[medianIndex],
-                blues[medianIndex],
-                alphas[medianIndex]
-            ));
-        }
-    }
+    Image output(input.getWidth(), input.getHeight(), input.getChannels());
+    RowWindow in(input.getView());
+    MutableRowWindow out(output.getView());
+    // Bands of rows are independent: each builds its own column histograms
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        applyRows(in, out, bandBegin, bandEnd);
+    });
     return output;
 }
 
+// Output rows depend on the rows within half a kernel of them
+int MedianBlurFilter::getRowHalo() const {
+    return kernelSize / 2;
+}
+
+/**
+ * @brief Median filters rows [rowBegin, rowEnd), one channel at a time.
+ * 
+ * @param input Input rows [rowBegin - kernelSize / 2, rowEnd + kernelSize / 2), clipped to the image.
+ * @param output Output window holding rows [rowBegin, rowEnd).
+ * @param rowBegin First row to filter.
+ * @param rowEnd One past the last row to filter.
+ */
+void MedianBlurFilter::applyRows(const RowWindow& input, const MutableRowWindow& output,
+                                 int rowBegin, int rowEnd, double) const {
+    for (int c = 0; c < input.getChannels(); c++) {
+        medianChannel(input, output, c, kernelSize, rowBegin, rowEnd);
+    }
+}
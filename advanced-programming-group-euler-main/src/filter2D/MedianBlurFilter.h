@@ -26,8 +26,9 @@
 /**
  * @brief Median blur filter that replaces each pixel with the median value of its neighbors.
  * 
- * The MedianBlurFilter collects the pixel values within a defined neighborhood around each pixel,
- * sorts the values for each color channel individually, and then selects the median. 
+ * For every pixel, the filter takes the median of the in-bounds neighbourhood values for each
+ * colour channel individually. The median is tracked with sliding 256-bin histograms, so the
+ * cost per pixel does not grow with the kernel size.
  */
 class MedianBlurFilter : public Filter {
 public:
@@ -55,14 +56,25 @@ public:
     /**
      * @brief Applies the median blur filter to the input image.
      * 
-     * For each pixel in the input image, the filter gathers neighboring pixel values within the 
-     * kernel, sorts each channel separately, and uses the median value to form the output pixel.
+     * For each pixel in the input image, the filter takes the median of the neighbouring values
+     * within the kernel for each channel separately. Neighbours outside the image are ignored.
      * 
      * @param input The input image to process.
      * @return Image The resulting blurred image.
      */
     Image apply(const Image& input) override;
 
+    /**
+     * @brief Rows above and below an output row inside the window (kernelSize / 2)
+     */
+    int getRowHalo() const override;
+
+    /**
+     * @brief Filter rows [rowBegin, rowEnd) on the calling thread (see Filter::applyRows)
+     */
+    void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                   int rowBegin, int rowEnd, double globalMaximum = 0) const override;
+
 private:
     int kernelSize;
 };
@@ -0,0 +1,144 @@
+/**
+ * @file PointOperationChain.h
+ * @brief Declaration of the PointOperationChain class, which fuses consecutive per-pixel filters
+ * @group [Euler]
+ * 
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+ #ifndef POINT_OPERATION_CHAIN_H
+ #define POINT_OPERATION_CHAIN_H
+ 
+ #include "Filter.h"
+ #include "../Image.h"
+ 
+ #include <array>
+ #include <cstddef>
+ #include <vector>
+ 
+ /**
+  * @brief Filter that applies a run of brightness, greyscale and threshold steps in one pass
+  * 
+  * Each step gives the same result as the matching SimpleFilters method
+  * (applyBrightness(), applyGreyscale(), applyThresholding()) applied in sequence, but
+  * the whole run is compiled into lookup tables and every pixel is read and written
+  * once. Steps on a single sample value (any step on a greyscale image, or any step
+  * after the first greyscale/threshold step) fold into one 256-entry table; steps before
+  * that on a colour image fold into a per-sample table.
+  * 
+  * Brightness 0 (normalise to the mean luminance) depends on the whole image and is not
+  * a point operation, so it cannot be added.
+  */
+ class PointOperationChain : public Filter {
+ public:
+     /**
+      * @brief Kinds of step the chain can hold
+      */
+     enum class Operation {
+         BRIGHTNESS,  ///< Add a value to every colour sample, clamped to 0-255
+         GREYSCALE,   ///< Replace each pixel by its rounded luminance (one channel)
+         THRESHOLD    ///< Black below the threshold luminance, white otherwise
+     };
+ 
+ private:
+     struct Step {
+         Operation operation;
+         int value;  ///< Brightness offset or threshold
+     };
+     std::vector<Step> steps;  ///< Steps in the order they are applied
+ 
+     using Lut = std::array<unsigned char, 256>;
+ 
+     /**
+      * @brief The steps compiled for an input with a given number of channels
+      */
+     struct Program {
+         int channels;            ///< Channels of the input
+         int outputChannels;      ///< Channels of the output
+         Lut sampleLut;           ///< Steps on each colour sample before the reduction
+         Lut valueLut;            ///< Steps on the reduced value
+         bool hasReduction;       ///< Whether a greyscale or threshold step reduces colour pixels
+         Step reduction;          ///< The reducing step
+     };
+ 
+     /**
+      * @brief Compile the steps into lookup tables
+      */
+     Program compile(int channels) const;
+ 
+     /**
+      * @brief Map rows [rowBegin, rowEnd) of the input through a compiled program
+      */
+     void mapRows(const Program& program, const RowWindow& input, const MutableRowWindow& output,
+                  int rowBegin, int rowEnd) const;
+ 
+ public:
+     /**
+      * @brief Construct an empty chain (applying it copies the image)
+      */
+     PointOperationChain();
+ 
+     /**
+      * @brief Append a brightness adjustment
+      * 
+      * @param brightness Value added to the R, G and B samples
+      * @throws std::invalid_argument If brightness is 0, which normalises the image instead
+      */
+     void addBrightness(int brightness);
+ 
+     /**
+      * @brief Append a greyscale conversion
+      */
+     void addGreyscale();
+ 
+     /**
+      * @brief Append a luminance threshold
+      * 
+      * @param threshold Luminance at and above which pixels become white
+      */
+     void addThreshold(int threshold);
+ 
+     /**
+      * @brief Remove every step
+      */
+     void clear();
+ 
+     bool empty() const;
+     std::size_t size() const;
+ 
+     /**
+      * @brief Apply every step to the image in a single pass
+      * 
+      * @param input Input image
+      * @return Image One channel if the chain contains a greyscale step, otherwise the
+      *         input's channel count
+      */
+     Image apply(const Image& input) override;
+ 
+     /**
+      * @brief Point operations read no neighbouring rows
+      * 
+      * @return int Always 0
+      */
+     int getRowHalo() const override;
+ 
+     /**
+      * @brief One channel if the chain contains a greyscale step, otherwise `inputChannels`
+      */
+     int getOutputChannels(int inputChannels) const override;
+ 
+     /**
+      * @brief Apply every step to rows [rowBegin, rowEnd) on the calling thread
+      */
+     void applyRows(const RowWindow& input, const MutableRowWindow& output,
+                    int rowBegin, int rowEnd, double globalMaximum = 0) const override;
+ };
+ 
+ #endif // POINT_OPERATION_CHAIN_H
@@ -20,7 +20,7 @@
  */
 PrewittFilter::PrewittFilter()
     : ConvolutionFilter("Prewitt", KERNEL_SIZE) {
-    // Additional initialization if needed
+    setGradientKernels(&kernelX[0][0], &kernelY[0][0], 1);
 }
 
 /**
@@ -29,57 +29,5 @@ PrewittFilter::PrewittFilter()
  * @return Edge-detected image after applying the filter
  */
 Image PrewittFilter::apply(const Image& input) {
-    // Convert to greyscale if needed
-    Image greyscale = input;
-    if (input.getChannels() > 1) {
-        greyscale = input.toGreyscale();
-    }
-
-    int width = greyscale.getWidth();
-    int height = greyscale.getHeight();
-    Image output(width, height, 1); // Resulting edge image (greyscale)
-
-    int maxGradient = 0;
-    std::vector<std::vector<int>> gradientMagnitude(height, std::vector<int>(width, 0));
-
-    // Compute horizontal (Gx) and vertical (Gy) gradients
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int gx = 0;
-            int gy = 0;
-
-            // Convolution with 3x3 kernels
-            for (int ky = -1; ky <= 1; ++ky) {
-                for (int kx = -1; kx <= 1; ++kx) {
-                    int nx = std::max(0, std::min(width - 1, x + kx));
-                    int ny = std::max(0, std::min(height - 1, y + ky));
-                    unsigned char pixelValue = greyscale.getPixel(nx, ny).getR();
-
-                    gx += pixelValue * kernelX[ky + 1][kx + 1];
-                    gy += pixelValue * kernelY[ky + 1][kx + 1];
-                }
-            }
-
-            // Approximate gradient magnitude
-            int magnitude = std::abs(gx) + std::abs(gy);
-            gradientMagnitude[y][x] = magnitude;
-            if (magnitude > maxGradient) {
-                maxGradient = magnitude;
-            }
-        }
-    }
-
-    // Normalise gradient to [0, 255]
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            unsigned char val = 0;
-            if (maxGradient > 0) {
-                val = static_cast<unsigned char>((gradientMagnitude[y][x] * 255) / maxGradient);
-            }
-            Pixel p(val, val, val);
-            output.setPixel(x, y, p);
-        }
-    }
-
-    return output;
+    return applyGradient(input);
 }
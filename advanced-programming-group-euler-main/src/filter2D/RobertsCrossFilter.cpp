@@ -15,13 +15,12 @@
 
 #include "RobertsCrossFilter.h"
 
-
 /**
  * @brief Constructor for the RobertsCrossFilter class
  */
 RobertsCrossFilter::RobertsCrossFilter()
     : ConvolutionFilter("RobertsCross", KERNEL_SIZE) {
-    // Additional initialization if needed
+    setGradientKernels(&kernel1[0][0], &kernel2[0][0], 0);
 }
 
 /**
@@ -30,57 +29,5 @@ RobertsCrossFilter::RobertsCrossFilter()
  * @return Edge-detected image after applying the filter
  */
 Image RobertsCrossFilter::apply(const Image& input) {
-    // Convert to greyscale if needed
-    Image greyscale = input;
-    if (input.getChannels() > 1) {
-        greyscale = input.toGreyscale();
-    }
-
-    int width = greyscale.getWidth();
-    int height = greyscale.getHeight();
-    Image output(width, height, 1); // Resulting edge image (greyscale)
-
-    int maxGradient = 0;
-    std::vector<std::vector<int>> gradientMagnitude(height, std::vector<int>(width, 0));
-
-    // For each pixel, apply the two 2x2 kernels
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int g1 = 0;
-            int g2 = 0;
-
-            for (int ky = 0; ky < 2; ++ky) {
-                for (int kx = 0; kx < 2; ++kx) {
-                    // Boundary check
-                    int nx = std::max(0, std::min(width - 1, x + kx));
-                    int ny = std::max(0, std::min(height - 1, y + ky));
-                    unsigned char pixelValue = greyscale.getPixel(nx, ny).getR();
-
-                    g1 += pixelValue * kernel1[ky][kx];
-                    g2 += pixelValue * kernel2[ky][kx];
-                }
-            }
-
-            // Approximate gradient magnitude: |G| = |G1| + |G2|
-            int magnitude = std::abs(g1) + std::abs(g2);
-            gradientMagnitude[y][x] = magnitude;
-            if (magnitude > maxGradient) {
-                maxGradient = magnitude;
-            }
-        }
-    }
-
-    // Normalize gradient to [0, 255]
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            unsigned char val = 0;
-            if (maxGradient > 0) {
-                val = static_cast<unsigned char>((gradientMagnitude[y][x] * 255) / maxGradient);
-            }
-            Pixel p(val, val, val);
-            output.setPixel(x, y, p);
-        }
-    }
-
-    return output;
+    return applyGradient(input);
 }
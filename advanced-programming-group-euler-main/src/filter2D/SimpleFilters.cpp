@@ -15,6 +15,10 @@
 
 
 #include "SimpleFilters.h"
+#include "../ThreadPool.h"
+
+#include <array>
+#include <mutex>
 
 // *******************************************************************************************
 // -------------------------------------------------------------------------------------------
@@ -102,13 +106,15 @@ Image SimpleFilters::applyBrightness(const Image& input, int brightness) {
         brightness = 128 - avgBrightness;  // Adjust brightness to reach 128
     }
 
-    // Apply brightness adjustment
-    for (int y = 0; y < input.getHeight(); ++y) {
-        for (int x = 0; x < input.getWidth(); ++x) {
-            Pixel p = input.getPixel(x, y).adjustBrightness(brightness);
-            output.setPixel(x, y, p);
+    // Apply brightness adjustment (bands of rows in parallel)
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            for (int x = 0; x < input.getWidth(); ++x) {
+                Pixel p = input.getPixel(x, y).adjustBrightness(brightness);
+                output.setPixel(x, y, p);
+            }
         }
-    }
+    });
 
     return output;
 }
@@ -142,14 +148,46 @@ std::vector<unsigned char> SimpleFilters::computeHistogramEqualizationMap(const
 // Convert an RGB image to greyscale
 Image SimpleFilters::applyGreyscale(const Image& input) {
     Image greyscale(input.getWidth(), input.getHeight(), 1);
-    for (int y = 0; y < input.getHeight(); ++y) {
-        for (int x = 0; x < input.getWidth(); ++x) {
-            greyscale.setPixel(x, y, input.getPixel(x, y).toGreyscale());
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            for (int x = 0; x < input.getWidth(); ++x) {
+                greyscale.setPixel(x, y, input.getPixel(x, y).toGreyscale());
+            }
         }
-    }
+    });
     return greyscale;
 }
 
+namespace {
+    /**
+     * @brief 256-bin histogram of value(row, x) over the image, counted in parallel.
+     *
+     * Each band of rows counts into its own 1 KB histogram on the stack, which is added
+     * to the total under a lock once the band is done, so memory stays fixed whatever
+     * the image size and the bands never contend while counting.
+     */
+    template <typename Value>
+    std::vector<int> parallelHistogram(const Image& input, Value value) {
+        std::vector<int> histogram(256, 0);
+        std::mutex histogramMutex; // Guards histogram while the bands merge their counts
+        int width = input.getWidth();
+        ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+            std::array<int, 256> counts{};
+            for (int y = bandBegin; y < bandEnd; ++y) {
+                const unsigned char* row = input.getRow(y);
+                for (int x = 0; x < width; ++x) {
+                    counts[value(row, x)]++;
+                }
+            }
+            std::lock_guard<std::mutex> lock(histogramMutex);
+            for (int i = 0; i < 256; ++i) {
+                histogram[i] += counts[i];
+            }
+        });
+        return histogram;
+    }
+}
+
 // Apply Histogram Equalization to a greyscale image
 Image SimpleFilters::applyGreyscaleHistogramEqualization(const Image& input) {
     int width = input.getWidth();
@@ -158,31 +196,32 @@ Image SimpleFilters::applyGreyscaleHistogramEqualization(const Image& input) {
     if (input.getChannels() != 1) {
         throw std::invalid_argument("Greyscale histogram equalization requires a single-channel image.");
     }
-    // Compute histogram (256 bins)
-    std::vector<int> histogram(256, 0);
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int intensity = input.getPixel(x, y).getR();
-            histogram[intensity]++;
-        }
-    }
+    // Compute histogram (256 bins, one per band, then merged)
+    std::vector<int> histogram = parallelHistogram(input, [](const unsigned char* row, int x) {
+        return row[x];
+    });
     // Compute equalization map
     std::vector<unsigned char> equalizationMap = computeHistogramEqualizationMap(histogram);
 
-    // Apply equalization
+    // Apply equalization (bands of rows in parallel, one table lookup per sample)
     Image output(width, height, 1);
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int oldIntensity = input.getPixel(x, y).getR();
-            unsigned char newIntensity = equalizationMap[oldIntensity];
-            output.setPixel(x, y, Pixel(newIntensity, newIntensity, newIntensity));
+    ThreadPool::shared().parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            const unsigned char* in = input.getRow(y);
+            unsigned char* out = output.getRow(y);
+            for (int x = 0; x < width; ++x) {
+                out[x] = equalizationMap[in[x]];
+            }
         }
-    }
+    });
 
     return output;
 }
 
 // Apply Histogram Equalization to an image (calls greyscale version if needed)
+// V of HSV is max(R, G, B) / 255, so the histogram pass needs no HSV conversion; only the
+// remapping converts, once per coloured pixel. Scaling RGB by newV / V directly would skip
+// it, but rounds differently from the HSV round trip by up to 2 levels.
 Image SimpleFilters::applyHistogramEqualization(const Image& input) {
     int width = input.getWidth();
     int height = input.getHeight();
@@ -191,40 +230,39 @@ Image SimpleFilters::applyHistogramEqualization(const Image& input) {
     if (channels == 1) {
         return applyGreyscaleHistogramEqualization(input);
     }
-    // Process only RGB channels
-    Image output(width, height, 3); 
-    std::vector<int> histogram(256, 0);
-    std::vector<unsigned char> vValues;
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            Pixel pixel = input.getPixel(x, y);
-            float h, s, v;
-            pixel.RGBtoHSV(h, s, v);
-
-            int intensity = static_cast<int>(v * 255.0f);
-            vValues.push_back(intensity);
-            histogram[intensity]++;
-        }
-    }
-
+    // Samples read as R, G and B, as in Pixel::fromSamples()
+    int blueOffset = (channels > 2) ? 2 : 0;
+    auto value = [channels, blueOffset](const unsigned char* row, int x) {
+        const unsigned char* p = row + x * channels;
+        return std::max({p[0], p[1], p[blueOffset]});
+    };
+
+    std::vector<int> histogram = parallelHistogram(input, value);
     std::vector<unsigned char> equalizationMap = computeHistogramEqualizationMap(histogram);
 
-    int index = 0;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            Pixel pixel = input.getPixel(x, y);
-            float h, s, v;
-            pixel.RGBtoHSV(h, s, v);
-
-            int oldIntensity = vValues[index++];
-            float newV = equalizationMap[oldIntensity] / 255.0f;
+    // Remap V (bands of rows in parallel), keeping H and S; grey pixels have S = 0 and
+    // map straight to the new V
+    Image output(width, height, 3);
+    ThreadPool::shared().parallelFor(0, height, [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            const unsigned char* in = input.getRow(y);
+            unsigned char* out = output.getRow(y);
+            for (int x = 0; x < width; ++x, out += 3) {
+                const unsigned char* p = in + x * channels;
+                unsigned char newIntensity = equalizationMap[value(in, x)];
+                if (p[0] == p[1] && p[0] == p[blueOffset]) {
+                    out[0] = out[1] = out[2] = newIntensity;
+                    continue;
+                }
+                float h, s, v;
+                Pixel(p[0], p[1], p[blueOffset]).RGBtoHSV(h, s, v);
 
-            Pixel newPixel;
-            newPixel.HSVtoRGB(h, s, newV);
-            output.setPixel(x, y, newPixel);
+                Pixel newPixel;
+                newPixel.HSVtoRGB(h, s, newIntensity / 255.0f);
+                newPixel.toSamples(out, 3);
+            }
         }
-    }
+    });
 
     return output;
 }
@@ -257,14 +295,16 @@ Image SimpleFilters::applySaltAndPepperNoise(const Image& input, float noisePerc
 // Apply thresholding to an image
 Image SimpleFilters::applyThresholding(const Image& input, int threshold) {
     Image output = input;
-    for (int y = 0; y < input.getHeight(); ++y) {
-        for (int x = 0; x < input.getWidth(); ++x) {
-            Pixel p = input.getPixel(x, y);
-            float intensity = p.getLuminance();
-            Pixel newPixel = (intensity < threshold) ? Pixel(0, 0, 0) : Pixel(255, 255, 255);
-            output.setPixel(x, y, newPixel);
+    ThreadPool::shared().parallelFor(0, input.getHeight(), [&](int bandBegin, int bandEnd) {
+        for (int y = bandBegin; y < bandEnd; ++y) {
+            for (int x = 0; x < input.getWidth(); ++x) {
+                Pixel p = input.getPixel(x, y);
+                float intensity = p.getLuminance();
+                Pixel newPixel = (intensity < threshold) ? Pixel(0, 0, 0) : Pixel(255, 255, 255);
+                output.setPixel(x, y, newPixel);
+            }
         }
-    }
+    });
     return output;
 }
 
@@ -15,13 +15,17 @@
 
  #include "Gaussian3DFilter.h"
  #include "../Volume.h"
+ #include "../FourierTransform.h"
+ #include "../filter2D/BorderPolicy.h"
+ #include "../ThreadPool.h"
  #include <cmath>
  #include <stdexcept>
  #include <tuple>
+ #include <algorithm>
  
  // Constructor with kernel size and sigma
- Gaussian3DFilter::Gaussian3DFilter(int kernelSize, float sigma)
-     : VolumeFilter("Gaussian3D", kernelSize), sigma(sigma) {
+ Gaussian3DFilter::Gaussian3DFilter(int kernelSize, float sigma, Method method)
+     : VolumeFilter("Gaussian3D", kernelSize), sigma(sigma), method(method) {
      // Generate the kernel
      kernel = generateKernel();
  }
@@ -42,38 +46,31 @@
      kernel = generateKernel();
  }
  
- // Generate the 3D Gaussian kernel
+ // Fourier transforms when forced, or when they beat three 1D passes of kernelSize taps
+ bool Gaussian3DFilter::usesFourierTransform(int width, int height, int depth) const {
+     if (method != Method::Auto) {
+         return method == Method::Fourier;
+     }
+     return FourierConvolution::isCheaper(3.0 * kernelSize, width, height, depth,
+                                          kernelSize, kernelSize, kernelSize);
+ }
+ 
+ // Generate the 1D Gaussian kernel
  std::vector<float> Gaussian3DFilter::generateKernel() const {
      // Calculate radius (half kernel size)
      int radius = kernelSize / 2;
      
-     // Create flattened 3D kernel
-     std::vector<float> k(kernelSize * kernelSize * kernelSize);
+     std::vector<float> k(kernelSize);
      
-     // Calculate normalization constant
+     // The 3D kernel is the product of three of these, so the (2πσ²)^(-3/2) factor
+     // cancels in the normalisation and is left out
      float sigma2 = sigma * sigma;
-     float norm = 1.0f / (std::pow(2.0f * M_PI * sigma2, 1.5f));
-     
-     // Calculate kernel values
      float sum = 0.0f; // For normalization
      
-     for (int z = -radius; z <= radius; ++z) {
-         for (int y = -radius; y <= radius; ++y) {
-             for (int x = -radius; x <= radius; ++x) {
-                 // Calculate 3D Gaussian function
-                 float exp_val = -(x*x + y*y + z*z) / (2.0f * sigma2);
-                 float value = norm * std::exp(exp_val);
-                 
-                 // Store value in flattened array
-                 int idx = (z + radius) * kernelSize * kernelSize + 
-                          (y + radius) * kernelSize + 
-                          (x + radius);
-                 k[idx] = value;
-                 
-                 // Accumulate for normalization
-                 sum += value;
-             }
-         }
+     for (int i = -radius; i <= radius; ++i) {
+         float value = std::exp(-(i * i) / (2.0f * sigma2));
+         k[i + radius] = value;
+         sum += value;
      }
      
      // Normalize to ensure the kernel sums to 1
@@ -86,6 +83,191 @@
      return k;
  }
  
+ // Anonymous namespace to make these functions local to this file
+ namespace {
+     // Blur `count` lines of `length` samples (C channels each) along one axis.
+     // Sample i of line n lives at base + n * lineStride + i * step. Taps falling outside
+     // the line are skipped and the remaining weights renormalised, which matches the
+     // in-bounds renormalisation of the full 3D kernel (the in-bounds region is a box,
+     // so its weight is the product of the three 1D in-bounds weights). Only the border
+     // strips at either end of a line have such taps; the interior uses every tap and
+     // the full kernel weight, summed once.
+     template <int C, typename In, typename Out, typename Store>
+     void blurLines(const In* in, Out* out, int count, std::ptrdiff_t lineStride,
+                    int length, std::ptrdiff_t step, const std::vector<float>& kernel,
+                    std::vector<float>& scratch, Store store) {
+         int radius = static_cast<int>(kernel.size()) / 2;
+         scratch.resize(static_cast<size_t>(length) * C);
+         const BorderPolicy::Span interior = BorderPolicy::interior(length, radius, radius);
+         float full_weight = 0.0f;
+         for (float k_value : kernel) {
+             full_weight += k_value;
+         }
+         
+         for (int n = 0; n < count; ++n) {
+             const In* src = in + n * lineStride;
+             Out* dst = out + n * lineStride;
+             
+             // Gather the line first so in-place passes read unmodified samples
+             for (int i = 0; i < length; ++i) {
+                 for (int c = 0; c < C; ++c) {
+                     scratch[i * C + c] = static_cast<float>(src[i * step + c]);
+                 }
+             }
+             
+             auto blurBorder = [&](int begin, int end) {
+                 for (int i = begin; i < end; ++i) {
+                     int lo = std::max(-radius, -i);
+                     int hi = std::min(radius, length - 1 - i);
+                     float sums[C] = {};
+                     float weight_sum = 0.0f;
+                     for (int k = lo; k <= hi; ++k) {
+                         float k_value = kernel[k + radius];
+                         const float* sample = &scratch[(i + k) * C];
+                         for (int c = 0; c < C; ++c) {
+                             sums[c] += sample[c] * k_value;
+                         }
+                         weight_sum += k_value;
+                     }
+                     for (int c = 0; c < C; ++c) {
+                         store(dst[i * step + c], (weight_sum > 0) ? sums[c] / weight_sum : sums[c]);
+                     }
+                 }
+             };
+             
+             blurBorder(0, interior.begin);
+             for (int i = interior.begin; i < interior.end; ++i) {
+                 float sums[C] = {};
+                 for (int k = -radius; k <= radius; ++k) {
+                     float k_value = kernel[k + radius];
+                     const float* sample = &scratch[(i + k) * C];
+                     for (int c = 0; c < C; ++c) {
+                         sums[c] += sample[c] * k_value;
+                     }
+                 }
+                 for (int c = 0; c < C; ++c) {
+                     store(dst[i * step + c], (full_weight > 0) ? sums[c] / full_weight : sums[c]);
+                 }
+             }
+             blurBorder(interior.end, length);
+         }
+     }
+     
+     // Separable Gaussian over Z slabs, one per thread. Each slab keeps a ring of the
+     // X- and Y-blurred float planes its Z taps reach (min(kernelSize, depth) planes, the
+     // halo of a strip filter), blurring every plane as it enters the ring; the Z pass then
+     // writes each output slice from the planes around it. Planes in the halo of two slabs
+     // are blurred by both, so memory stays at a few planes per thread instead of a float
+     // copy of the whole volume.
+     template <int C>
+     void convolveSamples(const Volume& volume, Volume& result, const std::vector<float>& kernel) {
+         int width, height, depth;
+         std::tie(width, height, depth) = volume.getDimensions3D();
+         
+         const std::ptrdiff_t xStride = volume.getXStride();
+         const std::ptrdiff_t yStride = volume.getYStride();
+         const std::ptrdiff_t zStride = volume.getZStride();
+         const int radius = static_cast<int>(kernel.size()) / 2;
+         const int ringPlanes = std::min(static_cast<int>(kernel.size()), depth);
+         auto keep = [](float& dst, float value) { dst = value; };
+         
+         ThreadPool::shared().parallelFor(0, depth, [&](int slabBegin, int slabEnd) {
+             std::vector<float> ring(static_cast<size_t>(zStride) * ringPlanes);
+             std::vector<float> sums(zStride);
+             std::vector<float> scratch;
+             auto plane = [&](int z) { return ring.data() + (z % ringPlanes) * zStride; };
+             
+             int nextPlane = std::max(slabBegin - radius, 0); // Next plane to enter the ring
+             for (int z = slabBegin; z < slabEnd; ++z) {
+                 int lo = std::max(-radius, -z);
+                 int hi = std::min(radius, depth - 1 - z);
+                 
+                 // X pass (one line per row) and Y pass (one line per column, in place)
+                 // of the planes entering the window
+                 for (; nextPlane <= z + hi; ++nextPlane) {
+                     float* slice = plane(nextPlane);
+                     blurLines<C>(volume.getData() + nextPlane * zStride, slice,
+                                  height, yStride, width, xStride, kernel, scratch, keep);
+                     blurLines<C>(slice, slice, width, xStride, height, yStride, kernel, scratch, keep);
+                 }
+                 
+                 // Z pass: a weighted sum of whole planes, accumulated plane by plane
+                 // (same order of operations as a line-by-line pass)
+                 std::fill(sums.begin(), sums.end(), 0.0f);
+                 float weight_sum = 0.0f;
+                 for (int k = lo; k <= hi; ++k) {
+                     float k_value = kernel[k + radius];
+                     const float* blurred = plane(z + k);
+                     for (std::ptrdiff_t i = 0; i < zStride; ++i) {
+                         sums[i] += blurred[i] * k_value;
+                     }
+                     weight_sum += k_value;
+                 }
+                 unsigned char* dst = result.getData() + z * zStride;
+                 for (std::ptrdiff_t i = 0; i < zStride; ++i) {
+                     float value = (weight_sum > 0) ? sums[i] / weight_sum : sums[i];
+                     dst[i] = static_cast<unsigned char>(std::round(std::min(std::max(value, 0.0f), 255.0f)));
+                 }
+             }
+         });
+     }
+     
+     // In-bounds weight of the 1D kernel centred on each of `length` samples
+     std::vector<float> inBoundsWeights(const std::vector<float>& kernel, int length) {
+         int radius = static_cast<int>(kernel.size()) / 2;
+         std::vector<float> weights(length, 0.0f);
+         for (int i = 0; i < length; ++i) {
+             for (int k = std::max(-radius, -i); k <= std::min(radius, length - 1 - i); ++k) {
+                 weights[i] += kernel[k + radius];
+             }
+         }
+         return weights;
+     }
+     
+     // Fourier path: each channel is correlated with the separable kernel over the
+     // zero-padded volume, and every sum divided by the product of the three 1D in-bounds
+     // weights, the same renormalisation as the separable passes.
+     void convolveFourier(const Volume& volume, Volume& result, const std::vector<float>& kernel) {
+         int width, height, depth;
+         std::tie(width, height, depth) = volume.getDimensions3D();
+         const int channels = volume.getChannels();
+         const std::ptrdiff_t xStride = volume.getXStride();
+         const std::ptrdiff_t yStride = volume.getYStride();
+         const std::ptrdiff_t zStride = volume.getZStride();
+         const int radius = static_cast<int>(kernel.size()) / 2;
+         
+         const std::vector<float> weightsX = inBoundsWeights(kernel, width);
+         const std::vector<float> weightsY = inBoundsWeights(kernel, height);
+         const std::vector<float> weightsZ = inBoundsWeights(kernel, depth);
+         FourierConvolution convolution(width, height, depth, kernel, kernel, kernel);
+         const int gridWidth = convolution.getGridWidth();
+         
+         for (int c = 0; c < channels; ++c) {
+             convolution.correlate(
+                 [&](int y, int z, float* row) {
+                     int sy = y - radius;
+                     int sz = z - radius;
+                     std::fill(row, row + gridWidth, 0.0f);
+                     if (sy < 0 || sy >= height || sz < 0 || sz >= depth) {
+                         return;
+                     }
+                     const unsigned char* src = volume.getData() + sz * zStride + sy * yStride + c;
+                     for (int x = 0; x < width; ++x) {
+                         row[x + radius] = src[x * xStride];
+                     }
+                 },
+                 [&](int y, int z, const float* row) {
+                     unsigned char* dst = result.getData() + z * zStride + y * yStride + c;
+                     float weightYZ = weightsY[y] * weightsZ[z];
+                     for (int x = 0; x < width; ++x) {
+                         float value = row[x] / (weightsX[x] * weightYZ);
+                         dst[x * xStride] = static_cast<unsigned char>(std::round(std::min(std::max(value, 0.0f), 255.0f)));
+                     }
+                 });
+         }
+     }
+ }
+ 
  // Apply the Gaussian blur filter to a volume
  std::unique_ptr<Volume> Gaussian3DFilter::apply(const Volume& volume) const {
      // Get volume dimensions
@@ -96,65 +278,18 @@
      // Create output volume
      auto result = std::make_unique<Volume>(width, height, depth, channels, volume.getName() + "_gaussian");
      
-     // Calculate radius (half kernel size)
-     int radius = kernelSize / 2;
+     if (usesFourierTransform(width, height, depth)) {
+         convolveFourier(volume, *result, kernel);
+         return result;
+     }
      
-     // Apply convolution
-     for (int z = 0; z < depth; ++z) {
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 float r_sum = 0.0f, g_sum = 0.0f, b_sum = 0.0f, a_sum = 0.0f;
-                 float weight_sum = 0.0f;
-                 
-                 // Apply kernel
-                 for (int kz = -radius; kz <= radius; ++kz) {
-                     for (int ky = -radius; ky <= radius; ++ky) {
-                         for (int kx = -radius; kx <= radius; ++kx) {
-                             // Calculate source coordinates
-                             int sz = z + kz;
-                             int sy = y + ky;
-                             int sx = x + kx;
-                             
-                             // Check if coordinates are valid
-                             if (sz >= 0 && sz < depth && sy >= 0 && sy < height && sx >= 0 && sx < width) {
-                                 // Get kernel value
-                                 int k_idx = (kz + radius) * kernelSize * kernelSize + 
-                                            (ky + radius) * kernelSize + 
-                                            (kx + radius);
-                                 float k_value = kernel[k_idx];
-                                 
-                                 // Get pixel value
-                                 Pixel pixel = volume.getVoxel(sx, sy, sz);
-                                 
-                                 // Accumulate weighted values
-                                 r_sum += pixel.getR() * k_value;
-                                 g_sum += pixel.getG() * k_value;
-                                 b_sum += pixel.getB() * k_value;
-                                 a_sum += pixel.getA() * k_value;
-                                 weight_sum += k_value;
-                             }
-                         }
-                     }
-                 }
-                 
-                 // Normalize if needed
-                 if (weight_sum > 0) {
-                     r_sum /= weight_sum;
-                     g_sum /= weight_sum;
-                     b_sum /= weight_sum;
-                     a_sum /= weight_sum;
-                 }
-                 
-                 // Set output voxel
-                 unsigned char r = static_cast<unsigned char>(std::round(std::min(std::max(r_sum, 0.0f), 255.0f)));
-                 unsigned char g = static_cast<unsigned char>(std::round(std::min(std::max(g_sum, 0.0f), 255.0f)));
-                 unsigned char b = static_cast<unsigned char>(std::round(std::min(std::max(b_sum, 0.0f), 255.0f)));
-                 unsigned char a = static_cast<unsigned char>(std::round(std::min(std::max(a_sum, 0.0f), 255.0f)));
-                 
-                 result->setVoxel(x, y, z, Pixel(r, g, b, a));
-             }
-         }
+     // Dispatch on the stored channel count
+     switch (channels) {
+         case 1: convolveSamples<1>(volume, *result, kernel); break;
+         case 2: convolveSamples<2>(volume, *result, kernel); break;
+         case 3: convolveSamples<3>(volume, *result, kernel); break;
+         default: convolveSamples<4>(volume, *result, kernel); break;
      }
      
      return result;
- }
\ No newline at end of file
+ }
@@ -25,19 +25,40 @@
   * This filter applies a 3D Gaussian blur by convolving the volume with a
   * 3D Gaussian kernel. The standard deviation (sigma) of the Gaussian
   * distribution can be configured.
+  *
+  * The 3D Gaussian is separable, so it is applied as three 1D passes (X, Y, Z),
+  * costing 3k instead of k³ multiply-adds per voxel. Taps outside the volume are
+  * skipped and the remaining weights renormalised in every pass, which gives the
+  * same border behaviour as renormalising the full 3D kernel.
+  *
+  * Very large kernels can instead be applied through 3D Fourier transforms (see
+  * FourierConvolution), whose cost hardly depends on the kernel size. The volume is
+  * zero-padded and every sum divided by the in-bounds weight, so borders match the
+  * separable passes; outputs are within one grey level of them.
   */
  class Gaussian3DFilter : public VolumeFilter {
+ public:
+     /**
+      * @brief Implementation used by apply()
+      */
+     enum class Method {
+         Auto,      ///< Fourier when FourierConvolution estimates it cheaper, separable otherwise
+         Separable, ///< Three 1D passes
+         Fourier    ///< Fourier transforms of each channel of the whole volume
+     };
+
  private:
      float sigma;                    ///< Standard deviation for the Gaussian filter
-     std::vector<float> kernel;      ///< Precomputed 3D Gaussian kernel flattened to 1D
+     Method method;                  ///< Implementation used by apply()
+     std::vector<float> kernel;      ///< Precomputed, normalised 1D Gaussian kernel
  
      /**
-      * @brief Generate the 3D Gaussian kernel
+      * @brief Generate the 1D Gaussian kernel
       * 
-      * Computes the weights for the 3D Gaussian kernel using the formula:
-      * G(x,y,z) = (1/(2*π*σ²)^(3/2)) * e^(-(x²+y²+z²)/(2*σ²))
+      * Computes the weights g(i) = e^(-i²/(2*σ²)) for i in [-radius, radius], normalised
+      * to sum to 1. The 3D kernel G(x,y,z) = g(x) * g(y) * g(z) is never built.
       * 
-      * @return std::vector<float> Flattened 3D kernel array
+      * @return std::vector<float> 1D kernel of kernelSize weights
       */
      std::vector<float> generateKernel() const;
  
@@ -47,9 +68,10 @@
       * 
       * @param kernelSize Size of the kernel (must be odd, e.g., 3, 5, 7)
       * @param sigma Standard deviation for the Gaussian filter (default: 2.0)
+      * @param method Implementation to use (default: chosen per volume by cost)
       * @throws std::invalid_argument If kernel size is not odd
       */
-     Gaussian3DFilter(int kernelSize = 3, float sigma = 2.0f);
+     Gaussian3DFilter(int kernelSize = 3, float sigma = 2.0f, Method method = Method::Auto);
  
      /**
       * @brief Get the standard deviation (sigma) of the Gaussian filter
@@ -64,6 +86,17 @@
       * @param sigma The new sigma value
       */
      void setSigma(float sigma);
+
+     /**
+      * @brief Whether apply() uses Fourier transforms for a volume of the given size
+      * 
+      * @param width Width of the volume
+      * @param height Height of the volume
+      * @param depth Depth of the volume
+      * @return bool True for Method::Fourier, or Method::Auto when the transforms are
+      *         estimated to cost less than 3 * kernelSize taps per sample
+      */
+     bool usesFourierTransform(int width, int height, int depth) const;
  
      /**
       * @brief Apply the Gaussian blur filter to a volume
@@ -15,40 +15,73 @@
 
  #include "Median3DFilter.h"
  #include "../Volume.h"
+ #include "../MedianHistogram.h"
+ #include "../ThreadPool.h"
  #include <iostream>
- #include <vector>
  #include <algorithm>
  #include <tuple>
  #include <array>
+ #include <cstdint>
  
  // Anonymous namespace to make this function local to this file
  namespace {
-     // Helper function to find median using counting approach
-     // This avoids using nth_element which is not allowed
-     unsigned char findMedian(const std::vector<unsigned char>& values) {
-         // Since unsigned char has a range of 0-255, we can use a counting approach
-         std::array<int, 256> counts = {0}; // Initialize all counts to 0
+     // Median-filter the compact voxel samples of slices [zBegin, zEnd) of `volume` into
+     // `result` (C is the channel count, so only the stored channels are tracked)
+     template <int C>
+     void medianSamples(const Volume& volume, Volume& result, int kernelSize, int zBegin, int zEnd) {
+         int width, height, depth;
+         std::tie(width, height, depth) = volume.getDimensions3D();
          
-         // Count occurrences of each value
-         for (unsigned char val : values) {
-             counts[val]++;
-         }
+         // Calculate radius (half kernel size)
+         int radius = kernelSize / 2;
+         const std::ptrdiff_t yStride = volume.getYStride();
+         const std::ptrdiff_t zStride = volume.getZStride();
          
-         // Find the middle position
-         size_t totalElements = values.size();
-         size_t medianPosition = totalElements / 2;
+         // One sliding histogram per stored channel
+         std::array<MedianHistogram, C> windows;
          
-         // Walk through counts until we reach the median position
-         size_t currentPos = 0;
-         for (int i = 0; i < 256; ++i) {
-             currentPos += counts[i];
-             if (currentPos > medianPosition) {
-                 return static_cast<unsigned char>(i);
+         for (int z = zBegin; z < zEnd; ++z) {
+             const int z0 = std::max(0, z - radius);
+             const int z1 = std::min(depth - 1, z + radius);
+             for (int y = 0; y < height; ++y) {
+                 const int y0 = std::max(0, y - radius);
+                 const int y1 = std::min(height - 1, y + radius);
+                 const int planeSize = (z1 - z0 + 1) * (y1 - y0 + 1);
+                 
+                 // Add (or remove) the in-bounds YZ plane of the window at column sx
+                 auto updatePlane = [&](int sx, bool entering) {
+                     for (int sz = z0; sz <= z1; ++sz) {
+                         const unsigned char* src = volume.getData() + sz * zStride + y0 * yStride + sx * C;
+                         for (int sy = y0; sy <= y1; ++sy, src += yStride) {
+                             for (int c = 0; c < C; ++c) {
+                                 if (entering) windows[c].addSample(src[c]);
+                                 else windows[c].removeSample(src[c]);
+                             }
+                         }
+                     }
+                 };
+                 
+                 for (auto& window : windows) {
+                     window.clear();
+                 }
+                 for (int sx = 0; sx < std::min(radius, width); ++sx) {
+                     updatePlane(sx, true);
+                 }
+                 
+                 // Slide along X: one plane enters and one leaves, O(k^2) per voxel
+                 unsigned char* dst = result.getVoxelPtr(0, y, z);
+                 for (int x = 0; x < width; ++x) {
+                     if (x + radius < width) updatePlane(x + radius, true);
+                     if (x - radius - 1 >= 0) updatePlane(x - radius - 1, false);
+                     
+                     const int columns = std::min(width - 1, x + radius) - std::max(0, x - radius) + 1;
+                     const std::uint32_t rank = static_cast<std::uint32_t>(columns * planeSize) / 2;
+                     for (int c = 0; c < C; ++c) {
+                         dst[x * C + c] = windows[c].select(rank);
+                     }
+                 }
              }
          }
-         
-         // In case of empty vector (shouldn't happen)
-         return 0;
      }
  }
  
@@ -67,77 +100,17 @@
      // Create output volume
      auto result = std::make_unique<Volume>(width, height, depth, channels, volume.getName() + "_median");
      
-     // Calculate radius (half kernel size)
-     int radius = kernelSize / 2;
-     
-     // Create temporary vectors to store neighborhood values for each channel
-     std::vector<unsigned char> r_values, g_values, b_values, a_values;
-     int maxNeighborhood = kernelSize * kernelSize * kernelSize;
-     r_values.reserve(maxNeighborhood);
-     if (channels > 1) g_values.reserve(maxNeighborhood);
-     if (channels > 2) b_values.reserve(maxNeighborhood);
-     if (channels > 3) a_values.reserve(maxNeighborhood);
-     
-     // Apply median filter to each voxel
-     for (int z = 0; z < depth; ++z) {
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 // Clear the vectors
-                 r_values.clear();
-                 g_values.clear();
-                 b_values.clear();
-                 a_values.clear();
-                 
-                 // Collect neighborhood values
-                 for (int kz = -radius; kz <= radius; ++kz) {
-                     for (int ky = -radius; ky <= radius; ++ky) {
-                         for (int kx = -radius; kx <= radius; ++kx) {
-                             // Calculate source coordinates
-                             int sz = z + kz;
-                             int sy = y + ky;
-                             int sx = x + kx;
-                             
-                             // Check if coordinates are valid
-                             if (sz >= 0 && sz < depth && sy >= 0 && sy < height && sx >= 0 && sx < width) {
-                                 // Get pixel value
-                                 Pixel pixel = volume.getVoxel(sx, sy, sz);
-                                 
-                                 // Store channel values
-                                 r_values.push_back(pixel.getR());
-                                 if (channels > 1) g_values.push_back(pixel.getG());
-                                 if (channels > 2) b_values.push_back(pixel.getB());
-                                 if (channels > 3) a_values.push_back(pixel.getA());
-                             }
-                         }
-                     }
-                 }
-                 
-                 // Find median for each channel using our custom median finder
-                 unsigned char r_median, g_median = 0, b_median = 0, a_median = 255;
-                 
-                 // Red channel (always present)
-                 r_median = findMedian(r_values);
-                 
-                 // Green channel (if present)
-                 if (channels > 1) {
-                     g_median = findMedian(g_values);
-                 }
-                 
-                 // Blue channel (if present)
-                 if (channels > 2) {
-                     b_median = findMedian(b_values);
-                 }
-                 
-                 // Alpha channel (if present)
-                 if (channels > 3) {
-                     a_median = findMedian(a_values);
-                 }
-                 
-                 // Set output voxel to median values
-                 result->setVoxel(x, y, z, Pixel(r_median, g_median, b_median, a_median));
-             }
+     // Split the volume into Z slabs, one per thread; every slab only reads the slices
+     // within kernelSize / 2 of its own, and each (y, z) row starts a fresh histogram
+     ThreadPool::shared().parallelFor(0, depth, [&](int slabBegin, int slabEnd) {
+         // Dispatch on the stored channel count
+         switch (channels) {
+             case 1: medianSamples<1>(volume, *result, kernelSize, slabBegin, slabEnd); break;
+             case 2: medianSamples<2>(volume, *result, kernelSize, slabBegin, slabEnd); break;
+             case 3: medianSamples<3>(volume, *result, kernelSize, slabBegin, slabEnd); break;
+             default: medianSamples<4>(volume, *result, kernelSize, slabBegin, slabEnd); break;
          }
-     }
+     });
      
      return result;
- }
\ No newline at end of file
+ }
@@ -22,7 +22,9 @@
   * @brief Class for applying a 3D median filter to a volume
   * 
   * This filter replaces each voxel with the median value of its neighborhood,
-  * effectively removing noise while preserving edges.
+  * effectively removing noise while preserving edges. Neighbours outside the volume
+  * are ignored. Per-channel 256-bin histograms (MedianHistogram) slide along X, so
+  * each voxel only adds the entering YZ plane of the window and removes the leaving one.
   */
  class Median3DFilter : public VolumeFilter {
  public:
@@ -16,27 +16,22 @@
  #include "AvgIntensityProj.h"
  #include "../Volume.h"
  #include "../Image.h"
+ #include "../ThreadPool.h"
  #include <algorithm>
  #include <tuple>
  #include <vector>
  #include <cmath>
  #include <array>
+ #include <cstdint>
+ #include <limits>
  
- // Anonymous namespace to make this function local to this file
+ // Anonymous namespace to make these helpers local to this file
  namespace {
-     // Helper function to find median using counting approach
-     // This avoids using nth_element which is not allowed
-     unsigned char findMedianValue(const std::vector<unsigned char>& values) {
-        // Since unsigned char has a range of 0-255, we can use a counting approach
-        std::array<int, 256> counts = {0}; // Initialize all counts to 0
-        
-        // Count occurrences of each value
-        for (unsigned char val : values) {
-            counts[val]++;
-        }
-        
+     // Median of `totalElements` values given their 256-bin histogram; for an even
+     // count the two middle values are averaged, rounding up
+     template <typename Count>
+     unsigned char medianFromCounts(const Count* counts, size_t totalElements) {
         // Find the middle position(s)
-        size_t totalElements = values.size();
         bool isEven = (totalElements % 2 == 0);
         size_t medianPosition1 = totalElements / 2 - (isEven ? 1 : 0);
         size_t medianPosition2 = totalElements / 2;
@@ -74,7 +69,183 @@
         // Return the average (rounded)
         return static_cast<unsigned char>((firstMedianValue + secondMedianValue + 1) / 2);
         // Note: The + 1 implements rounding instead of truncation
-    }
+     }
+     
+     // Helper function to find median using counting approach
+     // This avoids using nth_element which is not allowed
+     unsigned char findMedianValue(const std::vector<unsigned char>& values) {
+        // Since unsigned char has a range of 0-255, we can use a counting approach
+        std::array<int, 256> counts = {0}; // Initialize all counts to 0
+        
+        // Count occurrences of each value
+        for (unsigned char val : values) {
+            counts[val]++;
+        }
+        
+        return medianFromCounts(counts.data(), values.size());
+     }
+     
+     // Median of every Z-column of the slab [startZ, endZ], read straight from the voxel
+     // buffer one channel at a time; each thread owns a tile of output rows
+     void projectMedianColumns(const Volume& volume, int startZ, int endZ, Image& projection) {
+         int width, height, depth;
+         std::tie(width, height, depth) = volume.getDimensions3D();
+         const int channels = volume.getChannels();
+         ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+             std::vector<unsigned char> values(endZ - startZ + 1);
+             for (int y = tileBegin; y < tileEnd; ++y) {
+                 unsigned char* dst = projection.getRow(y);
+                 for (int x = 0; x < width; ++x) {
+                     ConstImageView column = volume.getColumnZ(x, y);
+                     for (int c = 0; c < channels; ++c) {
+                         for (int z = startZ; z <= endZ; ++z) {
+                             values[z - startZ] = column.getRow(z)[c];
+                         }
+                         // Calculate median using our custom median finder instead of nth_element
+                         dst[x * channels + c] = findMedianValue(values);
+                     }
+                 }
+             }
+         });
+     }
+     
+     // Running mean state: one sum per output sample
+     class MeanAccumulator : public ProjectionAccumulator {
+     public:
+         MeanAccumulator(int width, int height, int channels)
+             : width(width), height(height), channels(channels),
+               rowSamples(static_cast<size_t>(width) * channels),
+               sums(rowSamples * height, 0) {
+         }
+         
+         // Accumulate every sample along Z; each thread owns a tile of output rows
+         void addSlices(std::span<const ConstImageView> slices) override {
+             ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                 for (const ConstImageView& plane : slices) {
+                     for (int y = tileBegin; y < tileEnd; ++y) {
+                         // Samples are compact, so a row is one flat run whatever the channel count
+                         const unsigned char* src = plane.getRow(y);
+                         unsigned long* sum = sums.data() + y * rowSamples;
+                         for (size_t i = 0; i < rowSamples; ++i) {
+                             sum[i] += src[i];
+                         }
+                     }
+                 }
+             });
+             sliceCount += static_cast<int>(slices.size());
+         }
+         
+         // Calculate average values
+         Image result() override {
+             Image projection(width, height, channels);
+             if (sliceCount == 0) {
+                 return projection;
+             }
+             ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                 for (int y = tileBegin; y < tileEnd; ++y) {
+                     unsigned char* dst = projection.getRow(y);
+                     const unsigned long* sum = sums.data() + y * rowSamples;
+                     for (size_t i = 0; i < rowSamples; ++i) {
+                         dst[i] = static_cast<unsigned char>(sum[i] / sliceCount);
+                     }
+                 }
+             });
+             return projection;
+         }
+         
+     private:
+         int width, height, channels;
+         size_t rowSamples;
+         std::vector<unsigned long> sums;
+         int sliceCount = 0;
+     };
+     
+     // Running median state: a 256-bin histogram per output sample. Counts are
+     // 16-bit whenever the slab is short enough, halving the footprint.
+     template <typename Count>
+     class MedianAccumulator : public ProjectionAccumulator {
+     public:
+         MedianAccumulator(int width, int height, int channels)
+             : width(width), height(height), channels(channels),
+               rowSamples(static_cast<size_t>(width) * channels),
+               histograms(rowSamples * height * 256, 0) {
+         }
+         
+         void addSlices(std::span<const ConstImageView> slices) override {
+             ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                 for (const ConstImageView& plane : slices) {
+                     for (int y = tileBegin; y < tileEnd; ++y) {
+                         const unsigned char* src = plane.getRow(y);
+                         Count* histogram = histograms.data() + y * rowSamples * 256;
+                         for (size_t i = 0; i < rowSamples; ++i) {
+                             ++histogram[i * 256 + src[i]];
+                         }
+                     }
+                 }
+             });
+             sliceCount += slices.size();
+         }
+         
+         Image result() override {
+             Image projection(width, height, channels);
+             if (sliceCount == 0) {
+                 return projection;
+             }
+             ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                 for (int y = tileBegin; y < tileEnd; ++y) {
+                     unsigned char* dst = projection.getRow(y);
+                     const Count* histogram = histograms.data() + y * rowSamples * 256;
+                     for (size_t i = 0; i < rowSamples; ++i) {
+                         dst[i] = medianFromCounts(histogram + i * 256, sliceCount);
+                     }
+                 }
+             });
+             return projection;
+         }
+         
+     private:
+         int width, height, channels;
+         size_t rowSamples;
+         std::vector<Count> histograms;
+         size_t sliceCount = 0;
+     };
+     
+     // Median state for short slabs: the slab itself, whose columns go through the same
+     // in-memory path as apply(). One byte per sample and slice, against 256 counts per
+     // sample for the histograms.
+     class SlabMedianAccumulator : public ProjectionAccumulator {
+     public:
+         SlabMedianAccumulator(int width, int height, int channels, int sliceCount)
+             : slab(width, height, sliceCount, channels),
+               rowSamples(static_cast<size_t>(width) * channels) {
+         }
+         
+         void addSlices(std::span<const ConstImageView> slices) override {
+             int height = slab.getHeight();
+             ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                 for (size_t i = 0; i < slices.size(); ++i) {
+                     for (int y = tileBegin; y < tileEnd; ++y) {
+                         std::copy_n(slices[i].getRow(y), rowSamples,
+                                     slab.getVoxelPtr(0, y, sliceCount + static_cast<int>(i)));
+                     }
+                 }
+             });
+             sliceCount += static_cast<int>(slices.size());
+         }
+         
+         Image result() override {
+             Image projection(slab.getWidth(), slab.getHeight(), slab.getChannels());
+             if (sliceCount > 0) {
+                 projectMedianColumns(slab, 0, sliceCount - 1, projection);
+             }
+             return projection;
+         }
+         
+     private:
+         Volume slab;
+         size_t rowSamples;
+         int sliceCount = 0;
+     };
  }
  
  // Constructor
@@ -92,19 +263,35 @@
      return useMedian;
  }
  
+ // Histograms only pay off once the slab outweighs them
+ bool AvgIntensityProj::usesMedianHistograms(int sliceCount) {
+     return sliceCount >= MEDIAN_HISTOGRAM_MIN_SLICES;
+ }
+ 
+ // Create the running state for a streamed projection
+ std::unique_ptr<ProjectionAccumulator> AvgIntensityProj::createAccumulator(int width, int height, int channels,
+                                                                            int sliceCount) const {
+     if (!useMedian) {
+         return std::make_unique<MeanAccumulator>(width, height, channels);
+     }
+     if (!usesMedianHistograms(sliceCount)) {
+         return std::make_unique<SlabMedianAccumulator>(width, height, channels, sliceCount);
+     }
+     if (sliceCount <= std::numeric_limits<std::uint16_t>::max()) {
+         return std::make_unique<MedianAccumulator<std::uint16_t>>(width, height, channels);
+     }
+     return std::make_unique<MedianAccumulator<std::uint32_t>>(width, height, channels);
+ }
+ 
  // Apply the average intensity projection to a volume
  Image AvgIntensityProj::apply(const Volume& volume) const {
      // Get volume dimensions
      int width, height, depth;
      std::tie(width, height, depth) = volume.getDimensions3D();
      
-     // Validate slab range
-     int startZ = slabStart;
-     int endZ = (slabEnd == -1) ? depth - 1 : slabEnd;
-     
-     // Ensure bounds are valid
-     startZ = std::max(0, std::min(startZ, depth - 1));
-     endZ = std::max(startZ, std::min(endZ, depth - 1));
+     // Clamp the slab to the volume
+     int startZ, endZ;
+     std::tie(startZ, endZ) = getSlabRange(depth);
      
      // Number of slices in the slab
      int slabDepth = endZ - startZ + 1;
@@ -112,56 +299,20 @@
      // Create output image with the same number of channels as the volume
      Image projection(width, height, volume.getChannels());
      
+     const int channels = volume.getChannels();
+     
      if (useMedian) {
-         // For each pixel position in the output image
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 // Collect all values for this (x,y) position along Z
-                 std::vector<unsigned char> valuesR, valuesG, valuesB, valuesA;
-                 
-                 for (int z = startZ; z <= endZ; ++z) {
-                     Pixel current = volume.getVoxel(x, y, z);
-                     valuesR.push_back(current.getR());
-                     valuesG.push_back(current.getG());
-                     valuesB.push_back(current.getB());
-                     valuesA.push_back(current.getA());
-                 }
-                 
-                 // Calculate median using our custom median finder instead of nth_element
-                 unsigned char medianR = findMedianValue(valuesR);
-                 unsigned char medianG = findMedianValue(valuesG);
-                 unsigned char medianB = findMedianValue(valuesB);
-                 unsigned char medianA = findMedianValue(valuesA);
-                 
-                 // Set the median pixel in the projection
-                 projection.setPixel(x, y, Pixel(medianR, medianG, medianB, medianA));
-             }
-         }
+         projectMedianColumns(volume, startZ, endZ, projection);
      } else {
-         // For each pixel position in the output image (using mean)
-         for (int y = 0; y < height; ++y) {
-             for (int x = 0; x < width; ++x) {
-                 // Accumulate RGB values along Z-axis
-                 unsigned long sumR = 0, sumG = 0, sumB = 0, sumA = 0;
-                 
-                 for (int z = startZ; z <= endZ; ++z) {
-                     Pixel current = volume.getVoxel(x, y, z);
-                     sumR += current.getR();
-                     sumG += current.getG();
-                     sumB += current.getB();
-                     sumA += current.getA();
-                 }
-                 
-                 // Calculate average RGB values
-                 unsigned char avgR = static_cast<unsigned char>(sumR / slabDepth);
-                 unsigned char avgG = static_cast<unsigned char>(sumG / slabDepth);
-                 unsigned char avgB = static_cast<unsigned char>(sumB / slabDepth);
-                 unsigned char avgA = static_cast<unsigned char>(sumA / slabDepth);
-                 
-                 // Set the average pixel in the projection
-                 projection.setPixel(x, y, Pixel(avgR, avgG, avgB, avgA));
-             }
+         // Accumulate every sample along Z, one XY plane at a time; the whole slab is
+         // a single batch, so each thread visits its tile of rows once per plane
+         std::vector<ConstImageView> planes;
+         for (int z = startZ; z <= endZ; ++z) {
+             planes.push_back(volume.getViewXY(z));
          }
+         auto accumulator = createAccumulator(width, height, channels, slabDepth);
+         accumulator->addSlices(planes);
+         projection = accumulator->result();
      }
      
      return projection;
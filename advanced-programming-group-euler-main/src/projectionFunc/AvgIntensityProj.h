@@ -30,6 +30,10 @@ private:
     bool useMedian; ///< If true, use median instead of mean
 
 public:
+    /// Streamed medians hold the slab below this many slices and per-sample histograms
+    /// from here on, where 256 16-bit counts per sample become the smaller of the two
+    static constexpr int MEDIAN_HISTOGRAM_MIN_SLICES = 512;
+
     /**
      * @brief Constructor
      * 
@@ -60,6 +64,28 @@ public:
      * @return Image The resulting 2D projection
      */
     Image apply(const Volume& volume) const override;
+
+    /**
+     * @brief Create the running state used for streamed projections
+     * 
+     * The mean keeps one sum per output sample. The median of a short slab keeps the slab
+     * and takes the median of each column as apply() does; from MEDIAN_HISTOGRAM_MIN_SLICES
+     * slices on it keeps a 256-bin histogram per output sample instead (16-bit counts when
+     * sliceCount allows, 32-bit otherwise), so its memory stops growing with the slab.
+     * 
+     * @param width Width of the slices
+     * @param height Height of the slices
+     * @param channels Samples per pixel of the slices
+     * @param sliceCount Number of slices that will be added
+     * @return std::unique_ptr<ProjectionAccumulator> An empty accumulator
+     */
+    std::unique_ptr<ProjectionAccumulator> createAccumulator(int width, int height, int channels,
+                                                             int sliceCount) const override;
+
+    /**
+     * @brief Whether a streamed median over sliceCount slices counts histograms (rather than holding the slab)
+     */
+    static bool usesMedianHistograms(int sliceCount);
 };
 
 #endif // AVG_INTENSITY_PROJ_H
\ No newline at end of file
@@ -16,8 +16,11 @@
 #include "MaxIntensityProj.h"
 #include "../Volume.h"
 #include "../Image.h"
+#include "../ThreadPool.h"
 #include <algorithm>
 #include <tuple>
+#include <vector>
+#include <cstring>
 
 // Constructor
 MaxIntensityProj::MaxIntensityProj(int slabStart, int slabEnd, float threshold)
@@ -34,50 +37,93 @@ float MaxIntensityProj::getThreshold() const {
     return threshold;
 }
 
+// Anonymous namespace to make this class local to this file
+namespace {
+    // Running maximum-intensity state: the projection itself plus, for colour slices,
+    // the luminance of the pixel currently kept
+    class MaxIntensityAccumulator : public ProjectionAccumulator {
+    public:
+        MaxIntensityAccumulator(int width, int height, int channels, float threshold)
+            : projection(width, height, channels), width(width), height(height), channels(channels) {
+            if (channels == 1) {
+                // Greyscale fast path: luminance grows with the sample value, so the threshold
+                // becomes a lowest passing value and the projection a running byte maximum
+                for (int v = 255; v >= 0; --v) {
+                    unsigned char grey = static_cast<unsigned char>(v);
+                    if (Pixel(grey, grey, grey).getLuminance() < threshold) break;
+                    lowestPassing = v;
+                }
+            } else {
+                // Pixels that never pass the threshold keep the image's default black
+                maxIntensity.assign(static_cast<size_t>(width) * height, -1.0f);
+            }
+            this->threshold = threshold;
+        }
+        
+        // Each thread owns a tile of output rows and walks the batch over just those rows
+        void addSlices(std::span<const ConstImageView> slices) override {
+            ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                for (const ConstImageView& plane : slices) {
+                    for (int y = tileBegin; y < tileEnd; ++y) {
+                        const unsigned char* src = plane.getRow(y);
+                        unsigned char* dst = projection.getRow(y);
+                        if (channels == 1) {
+                            for (int x = 0; x < width; ++x) {
+                                unsigned char value = (src[x] >= lowestPassing) ? src[x] : 0;
+                                dst[x] = std::max(dst[x], value);
+                            }
+                            continue;
+                        }
+                        float* best = maxIntensity.data() + static_cast<size_t>(y) * width;
+                        for (int x = 0; x < width; ++x) {
+                            float intensity = Pixel::fromSamples(src + x * channels, channels).getLuminance();
+                            // Apply threshold if set
+                            if (intensity >= threshold && intensity > best[x]) {
+                                best[x] = intensity;
+                                std::memcpy(dst + x * channels, src + x * channels, channels);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+        
+        Image result() override {
+            return std::move(projection);
+        }
+        
+    private:
+        Image projection;
+        int width, height, channels;
+        float threshold = 0.0f;
+        int lowestPassing = 256;          ///< Smallest greyscale sample passing the threshold
+        std::vector<float> maxIntensity;  ///< Luminance of the kept pixel (colour only)
+    };
+}
+
+// Create the running state for a streamed projection
+std::unique_ptr<ProjectionAccumulator> MaxIntensityProj::createAccumulator(int width, int height, int channels,
+                                                                           int /*sliceCount*/) const {
+    return std::make_unique<MaxIntensityAccumulator>(width, height, channels, threshold);
+}
+
 // Apply the maximum intensity projection to a volume
 Image MaxIntensityProj::apply(const Volume& volume) const {
     // Get volume dimensions
     int width, height, depth;
     std::tie(width, height, depth) = volume.getDimensions3D();
     
-    // Validate slab range
-    int startZ = slabStart;
-    int endZ = (slabEnd == -1) ? depth - 1 : slabEnd;
-    
-    // Ensure bounds are valid
-    startZ = std::max(0, std::min(startZ, depth - 1));
-    endZ = std::max(startZ, std::min(endZ, depth - 1));
-    
-    // Create output image with the same number of channels as the volume
-    Image projection(width, height, volume.getChannels());
+    // Clamp the slab to the volume
+    int startZ, endZ;
+    std::tie(startZ, endZ) = getSlabRange(depth);
     
-    // For each pixel position in the output image
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Find maximum intensity along Z-axis
-            float maxIntensity = -1.0f;
-            Pixel maxPixel;
-            
-            for (int z = startZ; z <= endZ; ++z) {
-                Pixel current = volume.getVoxel(x, y, z);
-                float intensity = current.getLuminance();
-                
-                // Apply threshold if set
-                if (intensity >= threshold && intensity > maxIntensity) {
-                    maxIntensity = intensity;
-                    maxPixel = current;
-                }
-            }
-            
-            // If no pixel met the threshold, use a black pixel
-            if (maxIntensity < 0) {
-                maxPixel = Pixel(0, 0, 0);
-            }
-            
-            // Set the pixel with maximum intensity in the projection
-            projection.setPixel(x, y, maxPixel);
-        }
+    // Walk the slab one XY plane at a time so every read is sequential in memory;
+    // the whole slab is a single batch, so each thread visits its tile of rows once per plane
+    std::vector<ConstImageView> planes;
+    for (int z = startZ; z <= endZ; ++z) {
+        planes.push_back(volume.getViewXY(z));
     }
-    
-    return projection;
-}
\ No newline at end of file
+    auto accumulator = createAccumulator(width, height, volume.getChannels(), endZ - startZ + 1);
+    accumulator->addSlices(planes);
+    return accumulator->result();
+}
@@ -59,6 +59,18 @@ public:
      * @return Image The resulting 2D projection
      */
     Image apply(const Volume& volume) const override;
+
+    /**
+     * @brief Create the running maximum used for streamed projections
+     * 
+     * @param width Width of the slices
+     * @param height Height of the slices
+     * @param channels Samples per pixel of the slices
+     * @param sliceCount Number of slices that will be added (unused)
+     * @return std::unique_ptr<ProjectionAccumulator> An empty accumulator
+     */
+    std::unique_ptr<ProjectionAccumulator> createAccumulator(int width, int height, int channels,
+                                                             int sliceCount) const override;
 };
 
 #endif // MAX_INTENSITY_PROJ_H
\ No newline at end of file
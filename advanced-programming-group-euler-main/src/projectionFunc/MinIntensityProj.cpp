@@ -16,59 +16,96 @@
 #include "MinIntensityProj.h"
 #include "../Volume.h"
 #include "../Image.h"
+#include "../ThreadPool.h"
 #include <algorithm>
 #include <tuple>
+#include <vector>
+#include <cstring>
 
 // Constructor
 MinIntensityProj::MinIntensityProj(int slabStart, int slabEnd)
     : Projection(ProjectionType::MINIMUM_INTENSITY, slabStart, slabEnd) {
 }
 
+// Anonymous namespace to make this class local to this file
+namespace {
+    // Running minimum-intensity state: the projection itself plus, for colour slices,
+    // the luminance of the pixel currently kept
+    class MinIntensityAccumulator : public ProjectionAccumulator {
+    public:
+        MinIntensityAccumulator(int width, int height, int channels)
+            : projection(width, height, channels), width(width), height(height), channels(channels) {
+            if (channels == 1) {
+                // Greyscale fast path: luminance grows with the sample value, so the
+                // projection is a running byte minimum
+                for (int y = 0; y < height; ++y) {
+                    std::memset(projection.getRow(y), 255, width);
+                }
+            } else {
+                minIntensity.assign(static_cast<size_t>(width) * height, 256.0f); // Just above maximum possible intensity
+            }
+        }
+        
+        // Each thread owns a tile of output rows and walks the batch over just those rows
+        void addSlices(std::span<const ConstImageView> slices) override {
+            ThreadPool::shared().parallelFor(0, height, [&](int tileBegin, int tileEnd) {
+                for (const ConstImageView& plane : slices) {
+                    for (int y = tileBegin; y < tileEnd; ++y) {
+                        const unsigned char* src = plane.getRow(y);
+                        unsigned char* dst = projection.getRow(y);
+                        if (channels == 1) {
+                            for (int x = 0; x < width; ++x) {
+                                dst[x] = std::min(dst[x], src[x]);
+                            }
+                            continue;
+                        }
+                        float* best = minIntensity.data() + static_cast<size_t>(y) * width;
+                        for (int x = 0; x < width; ++x) {
+                            float intensity = Pixel::fromSamples(src + x * channels, channels).getLuminance();
+                            if (intensity < best[x]) {
+                                best[x] = intensity;
+                                std::memcpy(dst + x * channels, src + x * channels, channels);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+        
+        Image result() override {
+            return std::move(projection);
+        }
+        
+    private:
+        Image projection;
+        int width, height, channels;
+        std::vector<float> minIntensity;  ///< Luminance of the kept pixel (colour only)
+    };
+}
+
+// Create the running state for a streamed projection
+std::unique_ptr<ProjectionAccumulator> MinIntensityProj::createAccumulator(int width, int height, int channels,
+                                                                           int /*sliceCount*/) const {
+    return std::make_unique<MinIntensityAccumulator>(width, height, channels);
+}
+
 // Apply the minimum intensity projection to a volume
 Image MinIntensityProj::apply(const Volume& volume) const {
     // Get volume dimensions
     int width, height, depth;
     std::tie(width, height, depth) = volume.getDimensions3D();
     
-    // Validate slab range
-    int startZ = slabStart;
-    int endZ = (slabEnd == -1) ? depth - 1 : slabEnd;
+    // Clamp the slab to the volume
+    int startZ, endZ;
+    std::tie(startZ, endZ) = getSlabRange(depth);
     
-    // Ensure bounds are valid
-    startZ = std::max(0, std::min(startZ, depth - 1));
-    endZ = std::max(startZ, std::min(endZ, depth - 1));
-    
-    // Create output image with the same number of channels as the volume
-    Image projection(width, height, volume.getChannels());
-    
-    // Initialize with maximum possible intensity
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            projection.setPixel(x, y, Pixel(255, 255, 255));
-        }
-    }
-    
-    // For each pixel position in the output image
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Find minimum intensity along Z-axis
-            float minIntensity = 256.0f; // Just above maximum possible intensity
-            Pixel minPixel;
-            
-            for (int z = startZ; z <= endZ; ++z) {
-                Pixel current = volume.getVoxel(x, y, z);
-                float intensity = current.getLuminance();
-                
-                if (intensity < minIntensity) {
-                    minIntensity = intensity;
-                    minPixel = current;
-                }
-            }
-            
-            // Set the pixel with minimum intensity in the projection
-            projection.setPixel(x, y, minPixel);
-        }
+    // Walk the slab one XY plane at a time so every read is sequential in memory;
+    // the whole slab is a single batch, so each thread visits its tile of rows once per plane
+    std::vector<ConstImageView> planes;
+    for (int z = startZ; z <= endZ; ++z) {
+        planes.push_back(volume.getViewXY(z));
     }
-    
-    return projection;
-}
\ No newline at end of file
+    auto accumulator = createAccumulator(width, height, volume.getChannels(), endZ - startZ + 1);
+    accumulator->addSlices(planes);
+    return accumulator->result();
+}
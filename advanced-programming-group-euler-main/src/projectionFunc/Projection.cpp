@@ -15,7 +15,11 @@
 
 #include "Projection.h"
 #include "../Volume.h"
+#include "../Image.h"
+#include "../ThreadPool.h"
+#include <algorithm>
 #include <stdexcept>
+#include <tuple>
 
 // Constructor with projection type
 Projection::Projection(ProjectionType type, int slabStart, int slabEnd)
@@ -46,4 +50,60 @@ void Projection::setSlabRange(int start, int end) {
     
     slabStart = start;
     slabEnd = end;
-}
\ No newline at end of file
+}
+
+// Clamp the slab to the volume; every apply() and streaming path goes through here
+std::pair<int, int> Projection::getSlabRange(int depth) const {
+    int startZ = slabStart;
+    int endZ = (slabEnd == -1) ? depth - 1 : slabEnd;
+    startZ = std::max(0, std::min(startZ, depth - 1));
+    endZ = std::max(startZ, std::min(endZ, depth - 1));
+    return std::make_pair(startZ, endZ);
+}
+
+// Stream the slab through an accumulator, decoding one batch of slices at a time
+Image Projection::applyToFiles(const std::vector<std::string>& filenames, int batchSize) const {
+    int width, height, channels;
+    if (!Volume::readSliceHeaders(filenames, width, height, channels)) {
+        throw std::runtime_error("Failed to read slice headers: " +
+                                 (filenames.empty() ? "No files provided" : filenames[0] + " (and others)"));
+    }
+    int startZ, endZ;
+    std::tie(startZ, endZ) = getSlabRange(static_cast<int>(filenames.size()));
+    
+    ThreadPool& pool = ThreadPool::shared();
+    if (batchSize <= 0) {
+        batchSize = pool.getThreadCount();
+    }
+    batchSize = std::min(batchSize, endZ - startZ + 1);
+    
+    auto accumulator = createAccumulator(width, height, channels, endZ - startZ + 1);
+    
+    // One buffer for the batch, reused for every batch
+    const size_t sliceBytes = static_cast<size_t>(width) * height * channels;
+    std::vector<unsigned char> batch(sliceBytes * batchSize);
+    std::vector<ConstImageView> views;
+    std::vector<char> decoded(batchSize);
+    for (int i = 0; i < batchSize; ++i) {
+        views.emplace_back(batch.data() + i * sliceBytes, width, height, channels,
+                           static_cast<std::ptrdiff_t>(width) * channels);
+    }
+    
+    for (int first = startZ; first <= endZ; first += batchSize) {
+        int count = std::min(batchSize, endZ - first + 1);
+        pool.parallelFor(0, count, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                decoded[i] = Volume::decodeSlice(filenames[first + i], width, height, channels,
+                                                 batch.data() + i * sliceBytes);
+            }
+        });
+        for (int i = 0; i < count; ++i) {
+            if (!decoded[i]) {
+                throw std::runtime_error("Failed to load slice: " + filenames[first + i]);
+            }
+        }
+        accumulator->addSlices(std::span<const ConstImageView>(views.data(), count));
+    }
+    
+    return accumulator->result();
+}
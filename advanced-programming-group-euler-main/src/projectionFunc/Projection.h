@@ -16,7 +16,12 @@
 #ifndef PROJECTION_H
 #define PROJECTION_H
 
+#include "../ImageView.h"
+#include <memory>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Forward declarations
 class Volume;
@@ -31,6 +36,35 @@ enum class ProjectionType {
     AVERAGE_INTENSITY
 };
 
+/**
+ * @brief Running state of a projection that is fed XY slices in increasing Z order
+ *
+ * Every projection only needs one running value (or one histogram) per output pixel,
+ * so slices can be folded in as they are read and then dropped. This is what lets
+ * Projection::applyToFiles() project stacks that would not fit in memory as a Volume.
+ */
+class ProjectionAccumulator {
+public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~ProjectionAccumulator() = default;
+
+    /**
+     * @brief Fold a batch of consecutive XY slices into the running state
+     *
+     * @param slices Slices in increasing Z order, all of the accumulator's size and channels
+     */
+    virtual void addSlices(std::span<const ConstImageView> slices) = 0;
+
+    /**
+     * @brief Build the projection of every slice added so far
+     *
+     * @return Image The resulting 2D projection; the accumulator must not be used afterwards
+     */
+    virtual Image result() = 0;
+};
+
 /**
  * @brief Abstract base class for volume projections
  * 
@@ -73,6 +107,14 @@ public:
      * @param end Ending Z-index (inclusive)
      */
     void setSlabRange(int start, int end);
+
+    /**
+     * @brief Get the slab range clamped to a volume of the given depth
+     * 
+     * @param depth Number of slices in the volume
+     * @return std::pair<int, int> First and last Z-index to project (inclusive)
+     */
+    std::pair<int, int> getSlabRange(int depth) const;
     
     /**
      * @brief Apply the projection to a volume
@@ -81,6 +123,33 @@ public:
      * @return Image The resulting 2D projection
      */
     virtual Image apply(const Volume& volume) const = 0;
+
+    /**
+     * @brief Create the running state used to project slices one batch at a time
+     * 
+     * @param width Width of the slices
+     * @param height Height of the slices
+     * @param channels Samples per pixel of the slices
+     * @param sliceCount Number of slices that will be added
+     * @return std::unique_ptr<ProjectionAccumulator> An empty accumulator
+     */
+    virtual std::unique_ptr<ProjectionAccumulator> createAccumulator(int width, int height, int channels,
+                                                                     int sliceCount) const = 0;
+
+    /**
+     * @brief Apply the projection to a stack of slice images without loading it as a Volume
+     * 
+     * Slices in the slab range are decoded in batches on the shared ThreadPool and folded
+     * into an accumulator, so peak memory is one batch of slices plus the accumulator
+     * instead of the whole volume. The result is identical to loading the files into a
+     * Volume and calling apply().
+     * 
+     * @param filenames Slice images, in Z order
+     * @param batchSize Slices decoded per batch (0 means one per pool thread)
+     * @return Image The resulting 2D projection
+     * @throws std::runtime_error If a slice cannot be read or the slices differ in size
+     */
+    Image applyToFiles(const std::vector<std::string>& filenames, int batchSize = 0) const;
 };
 
 #endif // PROJECTION_H
\ No newline at end of file
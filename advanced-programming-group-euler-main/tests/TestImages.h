@@ -0,0 +1,71 @@
+/**
+ * @file TestImages.h
+ * @brief Pseudo-random test images and exact comparisons shared by the unit tests
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+#pragma once
+
+#include "../src/Image.h"
+#include "../src/Volume.h"
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Advance a linear congruential generator and return its next 16-bit value
+ *
+ * The same generator on every platform, so tests see the same samples everywhere.
+ */
+inline unsigned int nextNoise(unsigned int& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 16;
+}
+
+/**
+ * @brief Image of uniform noise, filled row by row from nextNoise(seed)
+ */
+inline Image makeNoiseImage(int width, int height, int channels, unsigned int seed = 7) {
+    Image image(width, height, channels);
+    for (int y = 0; y < height; y++) {
+        unsigned char* row = image.getRow(y);
+        for (int i = 0; i < width * channels; i++) {
+            row[i] = static_cast<unsigned char>(nextNoise(seed));
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief Whether two images have the same size, channels and samples (row padding ignored)
+ */
+inline bool sameImage(const Image& a, const Image& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() ||
+        a.getChannels() != b.getChannels()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); y++) {
+        auto rowA = a.getRowSpan(y);
+        auto rowB = b.getRowSpan(y);
+        if (!std::equal(rowA.begin(), rowA.end(), rowB.begin())) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Whether two volumes have the same dimensions, channels and samples
+ */
+inline bool sameVolume(const Volume& a, const Volume& b) {
+    if (a.getDimensions3D() != b.getDimensions3D() || a.getChannels() != b.getChannels()) {
+        return false;
+    }
+    std::size_t bytes = static_cast<std::size_t>(a.getZStride()) * a.getDepth();
+    return std::equal(a.getData(), a.getData() + bytes, b.getData());
+}
@@ -3,6 +3,7 @@
 
 // Forward declarations of test functions.
 
+void runImageTests();
 void runGaussian3DFilterTests();
 void runMedian3DFilterTests();
 void runVolumeTests();
@@ -16,11 +17,25 @@ void runPrewittFilterTests();
 void runRobertsCrossFilterTests();
 void runScharrFilterTests();
 void runSobelFilterTests();
+void runGaussianBlurFilterTests();
+void runBoxBlurFilterTests();
+void runMedianBlurFilterTests();
+void runThreadPoolTests();
+void runBrickedVolumeTests();
+void runPointOperationChainTests();
+void runFilterPipelineTests();
+void runFilterChainTests();
+void runGradientKernelsTests();
+void runConvolutionFilterTests();
+void runFourierTransformTests();
+void runBorderPolicyTests();
+void runSimpleFiltersTests();
 
 int main() {
     std::cout << "Running all unit tests..." << std::endl;
     
-    // runGaussian3DFilterTests();
+    runImageTests();
+    runGaussian3DFilterTests();
     runMedian3DFilterTests();
     runVolumeTests();
     runProjectionTests();
@@ -33,6 +48,19 @@ int main() {
     runRobertsCrossFilterTests();
     runScharrFilterTests();
     runSobelFilterTests();
+    runGaussianBlurFilterTests();
+    runBoxBlurFilterTests();
+    runMedianBlurFilterTests();
+    runThreadPoolTests();
+    runBrickedVolumeTests();
+    runPointOperationChainTests();
+    runFilterPipelineTests();
+    runFilterChainTests();
+    runGradientKernelsTests();
+    runConvolutionFilterTests();
+    runFourierTransformTests();
+    runBorderPolicyTests();
+    runSimpleFiltersTests();
     
     std::cout << "\nAll tests completed. "
               << passed << " passed, " << failed << " failed." << std::endl;
@@ -0,0 +1,88 @@
+/**
+ * @file testBorderPolicy.cpp
+ * @brief Tests for the BorderPolicy class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "../src/filter2D/BorderPolicy.h"
+#include <iostream>
+#include <vector>
+
+namespace {
+    using Mode = BorderPolicy::Mode;
+
+    // Positions -3 to length + 2 of a line, read through a policy
+    std::vector<int> extendedLine(Mode mode, int length) {
+        BorderPolicy policy(mode);
+        std::vector<int> indices;
+        for (int i = -3; i < length + 3; i++) {
+            indices.push_back(policy.sourceIndex(i, length));
+        }
+        return indices;
+    }
+}
+
+/**
+ * @brief Runs tests for the BorderPolicy class
+ *
+ * Tests include:
+ * - Samples read past either end of a line for every border rule, including lines
+ *   shorter than the reach (reflection folds back and forth)
+ * - Padded rows on several channels
+ * - Interior spans, empty when the line is too short
+ * - Names of the border rules
+ */
+void runBorderPolicyTests() {
+    std::cout << "  Testing BorderPolicy..." << std::endl;
+
+    // Test 1: Source indices
+    CHECK(extendedLine(Mode::CLAMP, 4) == std::vector<int>({0, 0, 0, 0, 1, 2, 3, 3, 3, 3}), "Clamp repeats the edge");
+    CHECK(extendedLine(Mode::REFLECT, 4) == std::vector<int>({3, 2, 1, 0, 1, 2, 3, 2, 1, 0}),
+          "Reflect mirrors about the edge without repeating it");
+    CHECK(extendedLine(Mode::REFLECT, 2) == std::vector<int>({1, 0, 1, 0, 1, 0, 1, 0}),
+          "Reflect folds back and forth on a short line");
+    CHECK(extendedLine(Mode::REFLECT, 1) == std::vector<int>(7, 0), "Reflect on a single sample reads it");
+    CHECK(extendedLine(Mode::ZERO, 4) == std::vector<int>({-1, -1, -1, 0, 1, 2, 3, -1, -1, -1}), "Zero reads nothing outside");
+    CHECK(extendedLine(Mode::RENORMALISE, 4) == extendedLine(Mode::ZERO, 4), "Renormalise pads with zeros");
+    CHECK(BorderPolicy(Mode::RENORMALISE).padsWithZeros() && !BorderPolicy().padsWithZeros(),
+          "Zero padding reported, and clamping is the default");
+
+    // Test 2: Padded rows
+    const std::vector<unsigned char> row = {10, 11, 20, 21, 30, 31};  // Three pixels, two channels
+    std::vector<unsigned char> padded(14);
+    BorderPolicy(Mode::CLAMP).padRow(row.data(), 3, 2, 2, 2, padded.data());
+    CHECK(padded == std::vector<unsigned char>({10, 11, 10, 11, 10, 11, 20, 21, 30, 31, 30, 31, 30, 31}),
+          "Clamped row padded on both sides");
+    BorderPolicy(Mode::REFLECT).padRow(row.data(), 3, 2, 2, 2, padded.data());
+    CHECK(padded == std::vector<unsigned char>({30, 31, 20, 21, 10, 11, 20, 21, 30, 31, 20, 21, 10, 11}),
+          "Reflected row padded on both sides");
+    std::vector<unsigned char> lopsided(10, 99);
+    BorderPolicy(Mode::ZERO).padRow(row.data(), 3, 2, 0, 2, lopsided.data());
+    CHECK(lopsided == std::vector<unsigned char>({10, 11, 20, 21, 30, 31, 0, 0, 0, 0}), "Zero row padded on one side");
+
+    // Test 3: Interior spans
+    BorderPolicy::Span span = BorderPolicy::interior(10, 2, 1);
+    CHECK(span.begin == 2 && span.end == 9, "Interior of a long line");
+    span = BorderPolicy::interior(3, 2, 2);
+    CHECK(span.begin == 2 && span.end == 2, "Line shorter than the reach has an empty interior");
+    span = BorderPolicy::interior(1, 3, 0);
+    CHECK(span.begin == 1 && span.end == 1, "Interior stays inside the line");
+
+    // Test 4: Names
+    bool roundTrip = true;
+    for (Mode mode : {Mode::CLAMP, Mode::REFLECT, Mode::ZERO, Mode::RENORMALISE}) {
+        roundTrip = roundTrip && BorderPolicy::fromName(BorderPolicy::getName(mode)) == mode;
+    }
+    CHECK(roundTrip, "Border rules round trip through their names");
+    CHECK_THROWS(BorderPolicy::fromName("wrap"), "Unknown border rule rejected");
+}
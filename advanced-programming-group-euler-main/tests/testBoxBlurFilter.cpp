@@ -0,0 +1,92 @@
+/**
+ * @file testBoxBlurFilter.cpp
+ * @brief Tests for the BoxBlurFilter class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/BoxBlurFilter.h"
+#include "../src/Image.h"
+#include "../src/Pixel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Reference: average of the in-bounds neighbours, computed directly per pixel
+    Image directBoxBlur(const Image& input, int kernelSize) {
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int half = kernelSize / 2;
+        Image output(width, height, input.getChannels());
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                double sums[4] = {0, 0, 0, 0};
+                int count = 0;
+                for (int j = -half; j <= half; j++) {
+                    for (int i = -half; i <= half; i++) {
+                        if (!input.isInBounds(x + i, y + j)) continue;
+                        Pixel p = input.getPixel(x + i, y + j);
+                        sums[0] += p.getR();
+                        sums[1] += p.getG();
+                        sums[2] += p.getB();
+                        sums[3] += p.getA();
+                        count++;
+                    }
+                }
+                output.setPixel(x, y, Pixel(static_cast<unsigned char>(sums[0] / count),
+                                            static_cast<unsigned char>(sums[1] / count),
+                                            static_cast<unsigned char>(sums[2] / count),
+                                            static_cast<unsigned char>(sums[3] / count)));
+            }
+        }
+        return output;
+    }
+
+}
+
+/**
+ * @brief Runs tests for the BoxBlurFilter class
+ *
+ * This function tests:
+ * - Constructor validation.
+ * - A uniform image stays unchanged, borders included.
+ * - The running sum implementation is bit-identical to the direct in-bounds average for
+ *   several channel counts and kernel sizes, including kernels larger than the image.
+ */
+void runBoxBlurFilterTests() {
+    std::cout << "  Testing BoxBlurFilter..." << std::endl;
+
+    // Test 1: Constructor validation
+    CHECK_THROWS(BoxBlurFilter(2), "Even kernel size throws");
+    CHECK_THROWS(BoxBlurFilter(1), "Kernel size below 3 throws");
+
+    // Test 2: Uniform image is unchanged
+    Image flat(9, 6, 3);
+    for (int y = 0; y < 6; y++) {
+        for (int x = 0; x < 9; x++) flat.setPixel(x, y, Pixel(40, 80, 120));
+    }
+    Image flatBlurred = BoxBlurFilter(5).apply(flat);
+    CHECK(flatBlurred.getPixel(0, 0) == Pixel(40, 80, 120), "Uniform corner unchanged");
+    CHECK(flatBlurred.getPixel(4, 3) == Pixel(40, 80, 120), "Uniform centre unchanged");
+
+    // Test 3: Bit-identical to the direct computation
+    for (int channels : {1, 2, 3, 4}) {
+        Image input = makeNoiseImage(37, 23, channels);
+        for (int kernelSize : {3, 7, 31, 51}) {
+            Image expected = directBoxBlur(input, kernelSize);
+            Image actual = BoxBlurFilter(kernelSize).apply(input);
+            CHECK(sameImage(expected, actual),
+                  "Box blur " << kernelSize << " matches direct average (" << channels << " channels)");
+        }
+    }
+}
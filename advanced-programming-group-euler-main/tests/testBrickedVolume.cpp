@@ -0,0 +1,146 @@
+/**
+ * @file testBrickedVolume.cpp
+ * @brief Tests for the BrickedVolume class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/BrickedVolume.h"
+#include "../src/Volume.h"
+#include "../src/Image.h"
+#include "../src/Slice.h"
+#include "../src/projectionFunc/MaxIntensityProj.h"
+#include "../src/projectionFunc/AvgIntensityProj.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+namespace {
+    // Smooth blobs on a flat background plus some noise, like a small CT scan
+    Volume makeTestVolume(int width, int height, int depth, int channels) {
+        Volume volume(width, height, depth, channels, "bricks");
+        unsigned int seed = 99;
+        for (int z = 0; z < depth; z++) {
+            for (int y = 0; y < height; y++) {
+                unsigned char* row = volume.getVoxelPtr(0, y, z);
+                for (int i = 0; i < width * channels; i++) {
+                    int x = i / channels;
+                    unsigned int noise = nextNoise(seed);
+                    bool inside = (x - 8) * (x - 8) + (y - 6) * (y - 6) + (z - 5) * (z - 5) < 30;
+                    row[i] = static_cast<unsigned char>(inside ? 180 + noise % 8 : 20 + i % channels);
+                }
+            }
+        }
+        return volume;
+    }
+
+}
+
+/**
+ * @brief Runs tests for the BrickedVolume class
+ *
+ * This function tests:
+ * - Lossless round trips through Volume::saveToBricked / loadFromBricked, with bricks
+ *   cut off at the volume edges.
+ * - Region, slice and slab-projection reads against the same operations on the loaded volume.
+ * - Reads of a cropped slab against the cropped volume.
+ * - Rejection of corrupt or foreign files.
+ */
+void runBrickedVolumeTests() {
+    std::cout << "  Testing BrickedVolume..." << std::endl;
+    const std::string file = "test_bricked_volume.apb";
+
+    for (int channels : {1, 3}) {
+        Volume volume = makeTestVolume(19, 14, 11, channels);
+
+        // Test 1: Round trip, with a brick size that leaves partial bricks on every axis
+        CHECK(volume.saveToBricked(file, 4), "Bricked volume saved (" << channels << " channels)");
+        Volume loaded(1, 1, 1, 1, "loaded");
+        CHECK(loaded.loadFromBricked(file), "Bricked volume loaded");
+        CHECK(sameVolume(volume, loaded), "Bricked round trip is lossless (" << channels << " channels)");
+
+        BrickedVolume bricks(file);
+        CHECK(bricks.getBrickCount() == 5 * 4 * 3, "One brick per 4x4x4 block, partial ones included");
+        CHECK(bricks.getCompressedSize() < static_cast<size_t>(volume.getZStride()) * volume.getDepth(),
+              "Bricks compress the background");
+
+        // Test 2: Region of interest across brick boundaries
+        auto region = bricks.loadRegion(3, 2, 5, 9, 7, 4);
+        bool regionMatches = true;
+        for (int z = 0; z < 4; z++) {
+            for (int y = 0; y < 7; y++) {
+                regionMatches &= std::equal(region->getVoxelPtr(0, y, z), region->getVoxelPtr(0, y, z) + 9 * channels,
+                                            volume.getVoxelPtr(3, y + 2, z + 5));
+            }
+        }
+        CHECK(regionMatches, "Region matches the volume (" << channels << " channels)");
+        CHECK_THROWS(bricks.loadRegion(15, 0, 0, 5, 1, 1), "Region past the edge throws");
+
+        // Test 3: Slices on every plane
+        for (auto [plane, position] : {std::make_pair(SlicePlane::XY, 7), std::make_pair(SlicePlane::XZ, 14),
+                                       std::make_pair(SlicePlane::YZ, 1)}) {
+            Slice slice(plane, position);
+            CHECK(sameImage(bricks.extractSlice(slice), volume.extractSlice(slice)),
+                  "Bricked slice matches (plane " << static_cast<int>(plane) << ")");
+        }
+        CHECK_THROWS(bricks.extractSlice(Slice(SlicePlane::XY, 12)), "Slice outside the volume throws");
+
+        // Test 4: Slab projections cross layers of bricks
+        MaxIntensityProj mip(2, 9);
+        AvgIntensityProj median(1, -1, true);
+        CHECK(sameImage(bricks.applyProjection(mip), volume.applyProjection(mip)), "Bricked MIP slab matches");
+        CHECK(sameImage(bricks.applyProjection(median), volume.applyProjection(median)),
+              "Bricked median AIP matches");
+
+        // Test 5: A slab that starts and ends inside bricks reads like the cropped volume
+        Volume slab(volume);
+        slab.cropDepth(3, 9);
+        bricks.cropDepth(3, 9);
+        CHECK(std::get<2>(bricks.getDimensions3D()) == 7, "Cropped bricked volume has the slab's depth");
+        CHECK(sameVolume(*bricks.load(), slab), "Cropped bricked volume loads the slab");
+        CHECK(sameImage(bricks.extractSlice(Slice(SlicePlane::YZ, 5)), slab.extractSlice(Slice(SlicePlane::YZ, 5))),
+              "Cropped bricked slice matches");
+        CHECK(sameImage(bricks.applyProjection(mip), slab.applyProjection(mip)), "Cropped bricked MIP matches");
+        CHECK_THROWS(bricks.cropDepth(0, 7), "Crop past the slab throws");
+    }
+
+    // Test 6: Bad files
+    // Brick offsets that wrap around past the end, or point back into the header and index
+    auto corruptFirstOffset = [&](std::uint64_t offset) {
+        Volume volume = makeTestVolume(19, 14, 11, 1);
+        volume.saveToBricked(file, 4);
+        std::fstream damaged(file, std::ios::in | std::ios::out | std::ios::binary);
+        damaged.seekp(64); // The first index entry follows the 64-byte header
+        damaged.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    };
+    corruptFirstOffset(~std::uint64_t(0));
+    CHECK_THROWS(BrickedVolume{file}, "Brick offset wrapping around the file size throws");
+    corruptFirstOffset(0);
+    CHECK_THROWS(BrickedVolume{file}, "Brick offset inside the header throws");
+    corruptFirstOffset(64);
+    CHECK_THROWS(BrickedVolume{file}, "Brick offset inside the index throws");
+    {
+        std::fstream damaged(file, std::ios::in | std::ios::out | std::ios::binary);
+        damaged.seekp(0);
+        damaged.put('X');
+    }
+    CHECK_THROWS(BrickedVolume{file}, "Wrong magic throws");
+    std::filesystem::resize_file(file, 100);
+    CHECK_THROWS(BrickedVolume{file}, "Truncated index throws");
+    std::filesystem::remove(file);
+    Volume missing(1, 1, 1, 1);
+    CHECK(!missing.loadFromBricked(file), "Missing bricked file fails to load");
+}
@@ -0,0 +1,510 @@
+/**
+ * @file testConvolutionFilter.cpp
+ * @brief Tests for the general convolution engine of the ConvolutionFilter class
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/ConvolutionFilter.h"
+#include "../src/filter2D/ConvolutionKernel.h"
+#include "../src/filter2D/FilterPipeline.h"
+#include "../src/filter2D/SharpeningFilter.h"
+#include "../src/Image.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    using Method = ConvolutionFilter::Method;
+    using OutputMode = ConvolutionFilter::OutputMode;
+
+    // Sample i of an image, counting row by row
+    unsigned char sampleAt(const Image& image, size_t i) {
+        size_t rowSamples = static_cast<size_t>(image.getWidth()) * image.getChannels();
+        return image.getRow(static_cast<int>(i / rowSamples))[i % rowSamples];
+    }
+
+    // Kernel sums of every sample computed directly, with clamped coordinates
+    std::vector<double> referenceSums(const Image& input, const ConvolutionKernel& kernel) {
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int channels = input.getChannels();
+        std::vector<double> sums(static_cast<size_t>(width) * height * channels);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < channels; c++) {
+                    double sum = 0.0;
+                    for (int ky = 0; ky < kernel.getHeight(); ky++) {
+                        int sy = std::clamp(y + ky - kernel.getOriginY(), 0, height - 1);
+                        for (int kx = 0; kx < kernel.getWidth(); kx++) {
+                            int sx = std::clamp(x + kx - kernel.getOriginX(), 0, width - 1);
+                            sum += input.getRow(sy)[sx * channels + c] *
+                                   static_cast<double>(kernel.getWeights()[ky * kernel.getWidth() + kx]);
+                        }
+                    }
+                    sums[(static_cast<size_t>(y) * width + x) * channels + c] = sum;
+                }
+            }
+        }
+        return sums;
+    }
+
+    // Kernel sums computed directly under a border rule (RENORMALISE rescales by the in-bounds weight)
+    std::vector<double> referenceBorderSums(const Image& input, const ConvolutionKernel& kernel, BorderPolicy::Mode mode) {
+        BorderPolicy policy(mode);
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int channels = input.getChannels();
+        const std::vector<float>& weights = kernel.getWeights();
+        double total = 0.0;
+        for (float weight : weights) total += weight;
+        std::vector<double> sums(static_cast<size_t>(width) * height * channels);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < channels; c++) {
+                    double sum = 0.0;
+                    double inBounds = 0.0;
+                    for (int ky = 0; ky < kernel.getHeight(); ky++) {
+                        int sy = policy.sourceIndex(y + ky - kernel.getOriginY(), height);
+                        for (int kx = 0; kx < kernel.getWidth(); kx++) {
+                            int sx = policy.sourceIndex(x + kx - kernel.getOriginX(), width);
+                            if (sx < 0 || sy < 0) continue;
+                            double weight = weights[ky * kernel.getWidth() + kx];
+                            sum += input.getRow(sy)[sx * channels + c] * weight;
+                            inBounds += weight;
+                        }
+                    }
+                    if (mode == BorderPolicy::Mode::RENORMALISE && total != 0.0 && inBounds != 0.0) {
+                        sum *= total / inBounds;
+                    }
+                    sums[(static_cast<size_t>(y) * width + x) * channels + c] = sum;
+                }
+            }
+        }
+        return sums;
+    }
+
+    // Output of CLAMP mode from reference sums, alpha copied
+    Image referenceClamp(const Image& input, const std::vector<double>& sums) {
+        int channels = input.getChannels();
+        Image output(input.getWidth(), input.getHeight(), channels);
+        for (int y = 0; y < input.getHeight(); y++) {
+            for (int i = 0; i < input.getWidth() * channels; i++) {
+                double sum = sums[static_cast<size_t>(y) * input.getWidth() * channels + i];
+                output.getRow(y)[i] = (channels == 4 && i % 4 == 3)
+                    ? input.getRow(y)[i]
+                    : static_cast<unsigned char>(std::floor(std::clamp(sum, 0.0, 255.0) + 0.5));
+            }
+        }
+        return output;
+    }
+
+    // Kernels covering the unrolled sizes and the generic loop
+    std::vector<ConvolutionKernel> makeKernels() {
+        std::vector<ConvolutionKernel> kernels;
+        for (int size : {1, 3, 5, 7, 9}) {
+            std::vector<int> weights(static_cast<size_t>(size) * size);
+            for (size_t i = 0; i < weights.size(); i++) {
+                weights[i] = static_cast<int>((i * 7) % 11) - 4;
+            }
+            kernels.push_back(ConvolutionKernel::fixed(size, size, weights, 4));
+        }
+        std::vector<float> box(25, 1.0f / 25.0f);
+        kernels.push_back(ConvolutionKernel::floating(5, 5, box));
+        // Rectangular kernel whose origin is not the centre
+        std::vector<int> rectangle(24);
+        for (size_t i = 0; i < rectangle.size(); i++) {
+            rectangle[i] = static_cast<int>(i % 5) - 2;
+        }
+        kernels.push_back(ConvolutionKernel::fixed(4, 6, rectangle, 0, 0, 4));
+        return kernels;
+    }
+
+    // Kernel equal to the sum of outer products column_i * row_i^T
+    ConvolutionKernel makeLowRankKernel(const std::vector<std::vector<float>>& columns,
+                                        const std::vector<std::vector<float>>& rows) {
+        int width = static_cast<int>(rows.front().size());
+        int height = static_cast<int>(columns.front().size());
+        std::vector<float> weights(static_cast<size_t>(width) * height, 0.0f);
+        for (size_t t = 0; t < columns.size(); t++) {
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    weights[y * width + x] += columns[t][y] * rows[t][x];
+                }
+            }
+        }
+        return ConvolutionKernel::floating(width, height, weights);
+    }
+
+    std::vector<float> gaussian(int size, float sigma) {
+        std::vector<float> weights(size);
+        float sum = 0.0f;
+        for (int i = 0; i < size; i++) {
+            float d = static_cast<float>(i - size / 2);
+            weights[i] = std::exp(-d * d / (2.0f * sigma * sigma));
+            sum += weights[i];
+        }
+        for (float& weight : weights) weight /= sum;
+        return weights;
+    }
+
+    // Largest difference between two images' samples
+    int largestDifference(const Image& a, const Image& b) {
+        int largest = 0;
+        size_t samples = static_cast<size_t>(a.getWidth()) * a.getHeight() * a.getChannels();
+        for (size_t i = 0; i < samples; i++) {
+            largest = std::max(largest, std::abs(sampleAt(a, i) - sampleAt(b, i)));
+        }
+        return largest;
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& text) {
+        std::ofstream file(path);
+        file << text;
+    }
+}
+
+/**
+ * @brief Runs tests for the general convolution engine
+ *
+ * Tests include:
+ * - Kernel validation: sizes, weight counts, origins, fraction bits and overflow
+ * - Fixed and float kernels of the unrolled sizes (3, 5, 7), other sizes and a
+ *   rectangular off-centre kernel matching a direct evaluation on 1 to 4 channels
+ * - ABS_NORMALISE and SIGNED_FLOAT output, and applySigned()
+ * - applyConvolution() matching its previous results
+ * - The sharpening filter matching identity + Laplacian, and the engine inside a pipeline
+ * - Separable and low-rank kernels found by the SVD, run as 1D passes within the stated
+ *   tolerance of direct convolution, and full-rank kernels left alone
+ * - Reading kernels from files
+ * - Fourier transforms within one grey level of direct convolution for every output mode,
+ *   with the same clamped borders and copied alpha, and the AUTO method's choices
+ * - Every border rule matching a direct evaluation, for direct, separable and Fourier
+ *   sums, with kernels that reach past both edges of small images
+ */
+void runConvolutionFilterTests() {
+    std::cout << "  Testing ConvolutionFilter engine..." << std::endl;
+
+    // Test 1: Kernel validation
+    CHECK_THROWS(ConvolutionKernel::fixed(0, 3, {}), "Empty kernel rejected");
+    CHECK_THROWS(ConvolutionKernel::fixed(3, 3, {1, 2, 3}), "Wrong weight count rejected");
+    CHECK_THROWS(ConvolutionKernel::fixed(3, 3, std::vector<int>(9, 1), 0, 3, 1), "Origin outside kernel rejected");
+    CHECK_THROWS(ConvolutionKernel::fixed(3, 3, std::vector<int>(9, 1), 17), "Too many fraction bits rejected");
+    CHECK_THROWS(ConvolutionKernel::fixed(3, 3, std::vector<int>(9, 1 << 20)), "Overflowing kernel rejected");
+    CHECK_THROWS(ConvolutionKernel::floating(1, 1, {NAN}), "Non-finite weight rejected");
+    CHECK_THROWS(ConvolutionKernel::fromRows({{1, 2}, {3}}), "Ragged rows rejected");
+    ConvolutionKernel centred = ConvolutionKernel::fixed(4, 6, std::vector<int>(24, 1));
+    CHECK(centred.getOriginX() == 2 && centred.getOriginY() == 3 && centred.getRowHalo() == 3,
+          "Default origin is the centre");
+
+    // Test 2: CLAMP matches a direct evaluation
+    std::vector<ConvolutionKernel> kernels = makeKernels();
+    for (int channels = 1; channels <= 4; channels++) {
+        Image input = makeNoiseImage(23, 19, channels, 11);
+        bool same = true;
+        for (const ConvolutionKernel& kernel : kernels) {
+            Image expected = referenceClamp(input, referenceSums(input, kernel));
+            same = same && sameImage(ConvolutionFilter("Test", kernel).apply(input), expected);
+        }
+        CHECK(same, "Clamped convolution on " << channels << " channels matches direct evaluation");
+    }
+
+    // Test 3: applySigned returns the sums, and SIGNED_FLOAT shows them around 128
+    {
+        Image input = makeNoiseImage(17, 13, 4, 11);
+        bool close = true;
+        bool shown = true;
+        for (const ConvolutionKernel& kernel : kernels) {
+            ConvolutionFilter filter("Test", kernel, OutputMode::SIGNED_FLOAT);
+            std::vector<double> expected = referenceSums(input, kernel);
+            std::vector<float> sums = filter.applySigned(input);
+            Image image = filter.apply(input);
+            for (size_t i = 0; i < sums.size(); i++) {
+                bool alpha = i % 4 == 3;
+                double want = alpha ? sampleAt(input, i) : expected[i];
+                close = close && std::abs(sums[i] - want) <= 1e-3 * (1.0 + std::abs(want));
+                if (!alpha) {
+                    int value = sampleAt(image, i);
+                    shown = shown && std::abs(value - std::clamp(128.0 + want, 0.0, 255.0)) <= 0.5 + 1e-3;
+                }
+            }
+        }
+        CHECK(close, "applySigned returns the kernel sums and copies alpha");
+        CHECK(shown, "SIGNED_FLOAT images show 128 + sum");
+    }
+
+    // Test 4: ABS_NORMALISE scales the largest |sum| to 255
+    {
+        Image input = makeNoiseImage(29, 11, 3, 11);
+        bool normalised = true;
+        for (const ConvolutionKernel& kernel : kernels) {
+            Image image = ConvolutionFilter("Test", kernel, OutputMode::ABS_NORMALISE).apply(input);
+            std::vector<double> sums = referenceSums(input, kernel);
+            double largest = 0.0;
+            for (double sum : sums) largest = std::max(largest, std::abs(sum));
+            for (size_t i = 0; i < sums.size(); i++) {
+                double want = largest > 0.0 ? std::abs(sums[i]) * 255.0 / largest : 0.0;
+                normalised = normalised && std::abs(sampleAt(image, i) - want) < 1.0 + 1e-3;
+            }
+        }
+        CHECK(normalised, "ABS_NORMALISE scales sums by the largest magnitude");
+        Image flat(8, 8, 1);
+        Image zero = ConvolutionFilter("Test", ConvolutionKernel::fromRows({{1, -1}}), OutputMode::ABS_NORMALISE).apply(flat);
+        bool black = true;
+        for (size_t i = 0; i < 64; i++) black = black && sampleAt(zero, i) == 0;
+        CHECK(black,
+              "ABS_NORMALISE of an all-zero response is black");
+    }
+
+    // Test 5: applyConvolution keeps its results (first channel, |sum| normalised)
+    {
+        Image input = makeNoiseImage(21, 16, 3, 11);
+        std::vector<std::vector<int>> laplacian = {{0, 1, 0}, {1, -4, 1}, {0, 1, 0}};
+        Image result = ConvolutionFilter("Test", 3).applyConvolution(input, laplacian);
+        std::vector<int> sums(21 * 16);
+        int largest = 0;
+        for (int y = 0; y < 16; y++) {
+            for (int x = 0; x < 21; x++) {
+                int sum = 0;
+                for (int ky = -1; ky <= 1; ky++) {
+                    for (int kx = -1; kx <= 1; kx++) {
+                        int sx = std::clamp(x + kx, 0, 20);
+                        int sy = std::clamp(y + ky, 0, 15);
+                        sum += input.getRow(sy)[sx * 3] * laplacian[ky + 1][kx + 1];
+                    }
+                }
+                sums[y * 21 + x] = std::abs(sum);
+                largest = std::max(largest, std::abs(sum));
+            }
+        }
+        bool same = result.getChannels() == 1;
+        for (int i = 0; same && i < 21 * 16; i++) {
+            same = sampleAt(result, i) == (sums[i] * 255) / largest;
+        }
+        CHECK(same, "applyConvolution gives the normalised |sum| of the first channel");
+    }
+
+    // Test 6: Sharpening is identity + Laplacian, and the engine works inside a pipeline
+    for (int channels = 1; channels <= 4; channels++) {
+        Image input = makeNoiseImage(31, 27, channels, 11);
+        ConvolutionKernel sharpen = ConvolutionKernel::fixed(3, 3, {0, -1, 0, -1, 5, -1, 0, -1, 0});
+        Image expected = referenceClamp(input, referenceSums(input, sharpen));
+        CHECK(sameImage(SharpeningFilter().apply(input), expected),
+              "Sharpening on " << channels << " channels matches identity + Laplacian");
+
+        std::vector<float> blurWeights = {1, 2, 1, 2, 4, 2, 1, 2, 1};
+        for (float& weight : blurWeights) weight /= 16.0f;
+        ConvolutionFilter blur("Blur", ConvolutionKernel::floating(3, 3, blurWeights));
+        Image direct = SharpeningFilter().apply(blur.apply(input));
+        FilterPipeline pipeline;
+        pipeline.addStage(std::make_unique<ConvolutionFilter>("Blur", ConvolutionKernel::floating(3, 3, blurWeights)));
+        pipeline.addStage(std::make_unique<SharpeningFilter>());
+        CHECK(sameImage(pipeline.apply(input), direct),
+              "Convolution stages in a pipeline on " << channels << " channels match separate passes");
+    }
+
+    // Test 7: Separable kernels run as 1D passes within tolerance of direct convolution
+    {
+        Image input = makeNoiseImage(41, 37, 3, 11);
+        std::vector<float> g15 = gaussian(15, 3.0f);
+        ConvolutionKernel gaussian15 = makeLowRankKernel({g15}, {g15});
+        ConvolutionFilter separated("Test", gaussian15);
+        CHECK(separated.separateKernel(), "15x15 Gaussian is separable");
+        CHECK(separated.getTapsPerPixel() == 30, "15x15 Gaussian needs 30 taps instead of 225");
+        CHECK(separated.getSeparationError() < 1e-3, "Separating a rank-1 kernel is exact");
+        ConvolutionFilter direct("Test", gaussian15);
+        CHECK(direct.getTapsPerPixel() == 225, "Direct 15x15 convolution needs 225 taps");
+        CHECK(largestDifference(separated.apply(input), direct.apply(input)) <= 1,
+              "Separated Gaussian within one grey level of direct convolution");
+
+        // Rank 2 and rectangular
+        ConvolutionKernel rankTwo = makeLowRankKernel({{1, 2, 3, 2, 1, 0, -1}, {1, -1, 1, -1, 1, -1, 1}},
+                                                      {{0.5f, 1, 0.5f, 0, -0.5f, -1, -0.5f, 0, 1},
+                                                       {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.4f, 0.3f, 0.2f, 0.1f}});
+        for (OutputMode mode : {OutputMode::CLAMP, OutputMode::ABS_NORMALISE, OutputMode::SIGNED_FLOAT}) {
+            ConvolutionFilter lowRank("Test", rankTwo, mode);
+            bool used = lowRank.separateKernel();
+            CHECK(used && lowRank.getTapsPerPixel() == 32, "Rank-2 9x7 kernel runs as two separable terms");
+            CHECK(largestDifference(lowRank.apply(input), ConvolutionFilter("Test", rankTwo, mode).apply(input)) <= 1,
+                  "Rank-2 kernel within one grey level of direct convolution");
+        }
+
+        // Fixed point binomial kernel
+        std::vector<int> binomial;
+        for (int a : {1, 4, 6, 4, 1}) for (int b : {1, 4, 6, 4, 1}) binomial.push_back(a * b);
+        ConvolutionKernel fixedBinomial = ConvolutionKernel::fixed(5, 5, binomial, 8);
+        ConvolutionFilter separatedBinomial("Test", fixedBinomial);
+        CHECK(separatedBinomial.separateKernel(), "Fixed point binomial kernel is separable");
+        CHECK(largestDifference(separatedBinomial.apply(input), ConvolutionFilter("Test", fixedBinomial).apply(input)) <= 1,
+              "Separated fixed point kernel within one grey level of direct convolution");
+    }
+
+    // Test 8: Full-rank kernels stay direct, and dropped terms are accounted for
+    {
+        ConvolutionFilter sharpen("Test", ConvolutionKernel::fixed(3, 3, {0, -1, 0, -1, 5, -1, 0, -1, 0}));
+        CHECK(!sharpen.separateKernel() && sharpen.getTapsPerPixel() == 9,
+              "Rank-2 3x3 kernel stays direct (12 taps would be more than 9)");
+        CHECK(!ConvolutionFilter("Test", kernels[2]).separateKernel(), "Full-rank 5x5 kernel stays direct");
+        CHECK(!ConvolutionFilter("Test", ConvolutionKernel::fixed(3, 3, std::vector<int>(9, 0))).separateKernel(),
+              "Zero kernel stays direct");
+
+        // Dropping the small second term changes sums by at most the reported error
+        ConvolutionKernel nearlySeparable = makeLowRankKernel({{1, 2, 3, 2, 1}, {0.01f, -0.01f, 0.01f, -0.01f, 0.01f}},
+                                                              {{1, 2, 3, 2, 1}, {1, 0, -1, 0, 1}});
+        ConvolutionFilter truncated("Test", nearlySeparable, OutputMode::SIGNED_FLOAT);
+        CHECK(truncated.separateKernel(0.01) && truncated.getTapsPerPixel() == 10, "Tolerance drops small singular values");
+        CHECK(truncated.getSeparationError() > 0.0, "Dropped terms give a non-zero error bound");
+        Image input = makeNoiseImage(19, 23, 1, 11);
+        std::vector<float> approximate = truncated.applySigned(input);
+        std::vector<double> exact = referenceSums(input, nearlySeparable);
+        bool bounded = true;
+        for (size_t i = 0; i < exact.size(); i++) {
+            bounded = bounded && std::abs(approximate[i] - exact[i]) <= truncated.getSeparationError() + 1e-2;
+        }
+        CHECK(bounded, "Truncated kernel sums stay within the reported error");
+    }
+
+    // Test 9: Kernel files
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path();
+        std::filesystem::path integers = directory / "euler_kernel_integers.txt";
+        std::filesystem::path floats = directory / "euler_kernel_floats.txt";
+        std::filesystem::path ragged = directory / "euler_kernel_ragged.txt";
+        std::filesystem::path text = directory / "euler_kernel_text.txt";
+        writeFile(integers, "# Laplacian\n0 -1 0\n-1 4 -1   # centre row\n\n0 -1 0\n");
+        writeFile(floats, "0.25 0.5 0.25\n");
+        writeFile(ragged, "1 2 3\n4 5\n");
+        writeFile(text, "1 two 3\n");
+
+        ConvolutionKernel laplacian = ConvolutionKernel::fromFile(integers.string());
+        CHECK(laplacian.isFixedPoint() && laplacian.getWidth() == 3 && laplacian.getHeight() == 3 &&
+              laplacian.getFixedWeights() == std::vector<int>({0, -1, 0, -1, 4, -1, 0, -1, 0}),
+              "Integer kernel file gives a fixed point kernel");
+        ConvolutionKernel row = ConvolutionKernel::fromFile(floats.string());
+        CHECK(!row.isFixedPoint() && row.getWidth() == 3 && row.getHeight() == 1 && row.getWeights()[1] == 0.5f,
+              "Kernel file with fractions gives a floating point kernel");
+        CHECK_THROWS(ConvolutionKernel::fromFile(ragged.string()), "Ragged kernel file rejected");
+        CHECK_THROWS(ConvolutionKernel::fromFile(text.string()), "Kernel file with text rejected");
+        CHECK_THROWS(ConvolutionKernel::fromFile((directory / "euler_kernel_missing.txt").string()),
+                     "Missing kernel file rejected");
+        for (const auto& path : {integers, floats, ragged, text}) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    // Test 10: Fourier transforms match direct convolution
+    {
+        // Off-centre float kernel, fixed point kernel and a separable Gaussian
+        std::vector<float> ramp(11 * 9);
+        for (size_t i = 0; i < ramp.size(); i++) {
+            ramp[i] = static_cast<float>((i * 5) % 13) / 200.0f - 0.02f;
+        }
+        std::vector<float> g = gaussian(15, 3.0f);
+        ConvolutionKernel gauss = makeLowRankKernel({g}, {g});
+        std::vector<ConvolutionKernel> large = {ConvolutionKernel::floating(11, 9, ramp, 2, 7), kernels[4], gauss};
+        for (int channels : {1, 3, 4}) {
+            Image input = makeNoiseImage(37, 29, channels, 11);
+            for (const ConvolutionKernel& kernel : large) {
+                for (OutputMode mode : {OutputMode::CLAMP, OutputMode::ABS_NORMALISE, OutputMode::SIGNED_FLOAT}) {
+                    ConvolutionFilter direct("Test", kernel, mode);
+                    ConvolutionFilter fourier("Test", kernel, mode);
+                    direct.setMethod(Method::DIRECT);
+                    fourier.setMethod(Method::FOURIER);
+                    fourier.separateKernel();
+                    CHECK(largestDifference(fourier.apply(input), direct.apply(input)) <= 1,
+                          kernel.getWidth() << "x" << kernel.getHeight() << " kernel through transforms within one grey level on "
+                          << channels << " channels (mode " << static_cast<int>(mode) << ")");
+                }
+            }
+            ConvolutionFilter fourier("Test", large[0]);
+            fourier.setMethod(Method::FOURIER);
+            std::vector<float> sums = fourier.applySigned(input);
+            std::vector<double> exact = referenceSums(input, large[0]);
+            bool close = true;
+            for (size_t i = 0; i < exact.size(); i++) {
+                bool alpha = channels == 4 && i % 4 == 3;
+                close = close && (alpha ? sums[i] == sampleAt(input, i) : std::abs(sums[i] - exact[i]) < 1e-3);
+            }
+            CHECK(close, "applySigned through transforms matches the direct sums on " << channels << " channels");
+        }
+
+        // AUTO streams small kernels in strips and filters large ones whichever way is cheaper
+        ConvolutionFilter small("Test", kernels[1]);
+        ConvolutionFilter big("Test", ConvolutionKernel::floating(31, 31, std::vector<float>(31 * 31, 1.0f / 961.0f)));
+        CHECK(small.getMethod() == Method::AUTO && small.getRowHalo() == 1 && !small.usesFourierTransform(4096, 4096),
+              "AUTO keeps a 3x3 kernel direct");
+        CHECK(big.getRowHalo() == -1 && big.usesFourierTransform(1024, 1024), "AUTO uses transforms for 31x31 on 1024x1024");
+        CHECK(big.separateKernel() && big.getRowHalo() == 15 && !big.usesFourierTransform(1024, 1024),
+              "AUTO keeps a separated 31x31 box direct (62 taps per sample)");
+
+        // A wide kernel on a narrow image costs less directly than its padded transforms
+        ConvolutionFilter wide("Test", ConvolutionKernel::floating(65, 1, std::vector<float>(65, 1.0f / 65.0f)));
+        CHECK(wide.getRowHalo() == -1 && !wide.usesFourierTransform(2, 300), "AUTO stays direct on a narrow image");
+        Image input = makeNoiseImage(2, 300, 3, 11);
+        wide.setMethod(Method::DIRECT);
+        Image expected = wide.apply(input);
+        wide.setMethod(Method::AUTO);
+        CHECK(sameImage(wide.apply(input), expected), "AUTO runs the strips on the whole image when it stays direct");
+    }
+
+    // Test 11: Border rules
+    {
+        std::vector<float> g = gaussian(7, 1.5f);
+        std::vector<ConvolutionKernel> bordered = {kernels[1], kernels[6], makeLowRankKernel({g}, {g})};
+        for (BorderPolicy::Mode mode : {BorderPolicy::Mode::CLAMP, BorderPolicy::Mode::REFLECT,
+                                        BorderPolicy::Mode::ZERO, BorderPolicy::Mode::RENORMALISE}) {
+            for (int channels : {1, 4}) {
+                for (const ConvolutionKernel& kernel : bordered) {
+                    // 5 x 3 images are narrower and shorter than the kernels' reach
+                    for (int width : {5, 23}) {
+                        Image input = makeNoiseImage(width, width == 5 ? 3 : 17, channels, 11);
+                        std::vector<double> exact = referenceBorderSums(input, kernel, mode);
+                        for (Method method : {Method::DIRECT, Method::FOURIER}) {
+                            ConvolutionFilter filter("Test", kernel, OutputMode::SIGNED_FLOAT);
+                            filter.setBorderMode(mode);
+                            filter.setMethod(method);
+                            filter.separateKernel();
+                            std::vector<float> sums = filter.applySigned(input);
+                            bool close = true;
+                            for (size_t i = 0; i < exact.size(); i++) {
+                                bool alpha = channels == 4 && i % 4 == 3;
+                                close = close && (alpha || std::abs(sums[i] - exact[i]) < 2e-3);
+                            }
+                            CHECK(close, BorderPolicy::getName(mode) << " border, " << kernel.getWidth() << "x"
+                                  << kernel.getHeight() << " kernel on " << width << " columns, " << channels
+                                  << " channels" << (method == Method::FOURIER ? " (transforms)" : ""));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Renormalised smoothing keeps a flat image flat up to the corners
+        Image flat(9, 6, 3);
+        for (int y = 0; y < 6; y++) std::fill_n(flat.getRow(y), 27, static_cast<unsigned char>(200));
+        ConvolutionFilter box("Test", ConvolutionKernel::floating(5, 5, std::vector<float>(25, 1.0f / 25.0f)));
+        box.setBorderMode(BorderPolicy::Mode::RENORMALISE);
+        CHECK(sameImage(box.apply(flat), flat), "Renormalised box blur keeps a flat image");
+        box.setBorderMode(BorderPolicy::Mode::ZERO);
+        CHECK(box.apply(flat).getRow(0)[0] == 72, "Zero border darkens the corner (9 of 25 taps inside)");
+        CHECK_THROWS(ConvolutionFilter("Test", 3).setBorderMode(BorderPolicy::Mode::ZERO),
+                     "Border rule without a kernel throws");
+    }
+
+    CHECK_THROWS(ConvolutionFilter("Test", 3).applySigned(makeNoiseImage(4, 4, 1, 11)), "applySigned without a kernel throws");
+}
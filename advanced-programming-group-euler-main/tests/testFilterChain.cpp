@@ -0,0 +1,161 @@
+/**
+ * @file testFilterChain.cpp
+ * @brief Tests for the FilterChain class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/FilterChain.h"
+#include "../src/filter2D/FilterPipeline.h"
+#include "../src/filter2D/BoxBlurFilter.h"
+#include "../src/filter2D/GaussianBlurFilter.h"
+#include "../src/filter2D/MedianBlurFilter.h"
+#include "../src/filter2D/PointOperationChain.h"
+#include "../src/filter2D/PrewittFilter.h"
+#include "../src/filter2D/SharpeningFilter.h"
+#include "../src/filter2D/SobelFilter.h"
+#include "../src/Image.h"
+#include "../src/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Every heap allocation in the test binary goes through these, so a test can count them
+namespace {
+    std::atomic<long> allocationCount{0};
+
+    void* countedAllocate(std::size_t size, std::size_t alignment) {
+        ++allocationCount;
+        void* pointer = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            pointer = std::malloc(size == 0 ? 1 : size);
+        } else if (posix_memalign(&pointer, alignment, size == 0 ? 1 : size) != 0) {
+            pointer = nullptr;
+        }
+        if (!pointer) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size, 0); }
+void* operator new[](std::size_t size) { return countedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+namespace {
+    // Run every filter through the chain, starting from a copy of input
+    void runChain(FilterChain& chain, const Image& input, const std::vector<Filter*>& filters) {
+        chain.assign(input);
+        for (Filter* filter : filters) {
+            chain.apply(*filter);
+        }
+    }
+}
+
+/**
+ * @brief Runs tests for the FilterChain class
+ *
+ * Tests include:
+ * - Chained results matching the filters applied one after another
+ * - No heap allocation when a warmed-up chain is run again, for 1 and 3 threads
+ * - Moving images without copying their samples
+ * - Steps given as functions
+ */
+void runFilterChainTests() {
+    std::cout << "  Testing FilterChain..." << std::endl;
+
+    // Filters whose steps should not allocate once warmed up
+    PointOperationChain pointOperations;
+    pointOperations.addBrightness(20);
+    pointOperations.addGreyscale();
+    BoxBlurFilter box(5);
+    GaussianBlurFilter gaussian(5, 2.0f);
+    MedianBlurFilter median3(3);
+    MedianBlurFilter median9(9);
+    SharpeningFilter sharpen;
+    SobelFilter sobel;
+    FilterPipeline pipeline;
+    pipeline.addStage(std::make_unique<BoxBlurFilter>(3));
+    pipeline.addStage(std::make_unique<SharpeningFilter>());
+    pipeline.addStage(std::make_unique<PrewittFilter>());
+    const std::vector<std::vector<Filter*>> chains = {
+        {&box, &gaussian, &sharpen}, {&median3, &median9, &sobel}, {&pipeline, &box},
+        {&sharpen, &pointOperations, &median3}, {&gaussian, &sobel, &pipeline},
+    };
+
+    for (int channels : {1, 3, 4}) {
+        const Image input = makeNoiseImage(37, 29, channels, 23);
+        for (int threads : {1, 3}) {
+            ThreadPool::setSharedThreadCount(threads);
+            bool same = true;
+            bool allocationFree = true;
+            for (const auto& filters : chains) {
+                Image expected = input;
+                for (Filter* filter : filters) {
+                    expected = filter->apply(expected);
+                }
+
+                // Test 1: The chain matches applying the filters in sequence
+                FilterChain chain(input);
+                runChain(chain, input, filters);
+                same = same && sameImage(chain.getImage(), expected);
+
+                // Test 2: A second run reuses the buffers and scratch space of the first
+                long before = allocationCount.load();
+                runChain(chain, input, filters);
+                allocationFree = allocationFree && allocationCount.load() == before;
+                same = same && sameImage(chain.getImage(), expected);
+            }
+            CHECK(same, "Chain matches sequential filters (" << channels << " channels, "
+                        << threads << " threads)");
+            CHECK(allocationFree, "Warmed-up chain allocates nothing (" << channels << " channels, "
+                                  << threads << " threads)");
+        }
+    }
+    ThreadPool::setSharedThreadCount(ThreadPool::defaultThreadCount());
+
+    // Test 3: Moving an image hands over its samples
+    Image image = makeNoiseImage(16, 8, 3, 23);
+    const unsigned char* samples = image.getRow(0);
+    long before = allocationCount.load();
+    Image moved(std::move(image));
+    CHECK(moved.getRow(0) == samples && allocationCount.load() == before,
+          "Moving an image keeps its samples without allocating");
+    FilterChain chain(std::move(moved));
+    CHECK(chain.getImage().getRow(0) == samples, "Chain takes over the image it starts from");
+    Image released = chain.release();
+    CHECK(released.getRow(0) == samples, "Release hands the result back without copying");
+
+    // Test 4: Steps given as functions
+    chain.assign(released);
+    chain.apply([&](const Image& current) { return box.apply(current); });
+    CHECK(sameImage(chain.getImage(), box.apply(released)), "Function step is applied");
+}
@@ -0,0 +1,118 @@
+/**
+ * @file testFilterPipeline.cpp
+ * @brief Tests for the FilterPipeline class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/FilterPipeline.h"
+#include "../src/filter2D/BoxBlurFilter.h"
+#include "../src/filter2D/GaussianBlurFilter.h"
+#include "../src/filter2D/MedianBlurFilter.h"
+#include "../src/filter2D/PointOperationChain.h"
+#include "../src/filter2D/PrewittFilter.h"
+#include "../src/filter2D/RobertsCrossFilter.h"
+#include "../src/filter2D/ScharrFilter.h"
+#include "../src/filter2D/SharpeningFilter.h"
+#include "../src/filter2D/SobelFilter.h"
+#include "../src/Image.h"
+#include "../src/ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    // A stage in the "box5", "gauss5", "median9", "sharpen", "sobel", "b40g" shorthand used below
+    std::unique_ptr<Filter> makeStage(const std::string& stage) {
+        if (stage == "box3") return std::make_unique<BoxBlurFilter>(3);
+        if (stage == "box5") return std::make_unique<BoxBlurFilter>(5);
+        if (stage == "gauss5") return std::make_unique<GaussianBlurFilter>(5, 2.0f);
+        if (stage == "gauss7") return std::make_unique<GaussianBlurFilter>(7, 1.0f);
+        if (stage == "median3") return std::make_unique<MedianBlurFilter>(3);
+        if (stage == "median9") return std::make_unique<MedianBlurFilter>(9);
+        if (stage == "sharpen") return std::make_unique<SharpeningFilter>();
+        if (stage == "sobel") return std::make_unique<SobelFilter>();
+        if (stage == "prewitt") return std::make_unique<PrewittFilter>();
+        if (stage == "scharr") return std::make_unique<ScharrFilter>();
+        if (stage == "roberts") return std::make_unique<RobertsCrossFilter>();
+        auto chain = std::make_unique<PointOperationChain>();
+        chain->addBrightness(40);
+        if (stage == "b40g") chain->addGreyscale();
+        return chain;
+    }
+}
+
+/**
+ * @brief Runs tests for the FilterPipeline class
+ *
+ * Tests include:
+ * - Tiled chains matching the stages applied one after another, for 1, 3 and 4 channels,
+ *   several tile sizes and thread counts, including chains with one or two edge detection
+ *   (global maximum) stages
+ * - A lone stage and an empty pipeline
+ * - Rejecting stages that need the whole image
+ */
+void runFilterPipelineTests() {
+    std::cout << "  Testing FilterPipeline..." << std::endl;
+
+    // Test 1: Tiled output is identical to applying the stages in sequence
+    const std::vector<std::vector<std::string>> chains = {
+        {"box5", "sharpen"}, {"gauss5", "sharpen", "sobel"}, {"b40g", "median3", "prewitt"},
+        {"sobel", "box3"}, {"roberts", "sharpen", "scharr"}, {"gauss7", "median9", "b40"},
+    };
+    for (const auto& stages : chains) {
+        bool same = true;
+        std::string name;
+        for (const std::string& stage : stages) {
+            name += " " + stage;
+        }
+        for (int channels : {1, 3, 4}) {
+            Image input = makeNoiseImage(29, 41, channels, 11);
+            Image expected = input;
+            FilterPipeline pipeline;
+            for (const std::string& stage : stages) {
+                expected = makeStage(stage)->apply(expected);
+                pipeline.addStage(makeStage(stage));
+            }
+            for (int threads : {1, 3}) {
+                ThreadPool::setSharedThreadCount(threads);
+                for (int tileRows : {0, 1, 3, 7, 64}) {
+                    pipeline.setTileRows(tileRows);
+                    same = same && sameImage(pipeline.applyTiled(input), expected);
+                }
+            }
+        }
+        CHECK(same, "Tiled chain" << name << " matches sequential filters");
+    }
+    ThreadPool::setSharedThreadCount(ThreadPool::defaultThreadCount());
+
+    // Test 2: A lone stage, an empty pipeline and automatic tile sizes
+    Image input = makeNoiseImage(31, 19, 3, 11);
+    FilterPipeline pipeline;
+    CHECK(pipeline.empty() && sameImage(pipeline.apply(input), input), "Empty pipeline copies the image");
+    pipeline.addStage(makeStage("sobel"));
+    CHECK(pipeline.size() == 1 && sameImage(pipeline.apply(input), SobelFilter().apply(input)),
+          "Lone stage matches the filter");
+    int rows = pipeline.getTileRows(31, 19, 3);
+    CHECK(rows >= 1 && rows <= 19, "Automatic tile rows lie within the image");
+    pipeline.clear();
+    CHECK(pipeline.empty(), "Clear removes every stage");
+
+    // Test 3: Stages must work on strips of rows
+    CHECK_THROWS(pipeline.addStage(std::make_unique<GaussianBlurFilter>(15, 2.0f)),
+                 "Recursive Gaussian blur cannot be a stage");
+    CHECK_THROWS(pipeline.addStage(nullptr), "Null stage is rejected");
+    CHECK_THROWS(pipeline.setTileRows(-1), "Negative tile rows are rejected");
+}
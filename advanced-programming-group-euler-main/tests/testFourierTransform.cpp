@@ -0,0 +1,186 @@
+/**
+ * @file testFourierTransform.cpp
+ * @brief Tests for the FourierTransform, RealFourierTransform and FourierConvolution classes
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/FourierTransform.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+namespace {
+    std::vector<float> makeNoise(size_t count, unsigned int seed) {
+        std::vector<float> values(count);
+        for (float& value : values) {
+            value = static_cast<float>(nextNoise(seed)) / 65535.0f * 2.0f - 1.0f;
+        }
+        return values;
+    }
+
+    // Direct DFT in double precision
+    std::vector<std::complex<double>> referenceTransform(const std::vector<std::complex<float>>& input) {
+        size_t n = input.size();
+        std::vector<std::complex<double>> output(n);
+        for (size_t k = 0; k < n; k++) {
+            for (size_t j = 0; j < n; j++) {
+                double angle = -2.0 * std::numbers::pi * static_cast<double>((j * k) % n) / n;
+                output[k] += std::complex<double>(input[j]) * std::polar(1.0, angle);
+            }
+        }
+        return output;
+    }
+
+    // Direct correlation of a padded grid with a kernel
+    std::vector<double> referenceCorrelation(const std::vector<float>& grid, int width, int height, int depth,
+                                             const std::vector<float>& kernel, int kw, int kh, int kd) {
+        int gw = width + kw - 1;
+        int gh = height + kh - 1;
+        std::vector<double> output(static_cast<size_t>(width) * height * depth);
+        for (int z = 0; z < depth; z++) {
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    double sum = 0.0;
+                    for (int k = 0; k < kd; k++) {
+                        for (int j = 0; j < kh; j++) {
+                            for (int i = 0; i < kw; i++) {
+                                sum += static_cast<double>(kernel[(k * kh + j) * kw + i]) *
+                                       grid[((z + k) * static_cast<size_t>(gh) + y + j) * gw + x + i];
+                            }
+                        }
+                    }
+                    output[(static_cast<size_t>(z) * height + y) * width + x] = sum;
+                }
+            }
+        }
+        return output;
+    }
+
+    // Largest difference between a FourierConvolution and the direct correlation
+    double convolutionError(const FourierConvolution& convolution, const std::vector<float>& grid,
+                            const std::vector<double>& expected, int width, int height, int gridHeight) {
+        int gridWidth = convolution.getGridWidth();
+        std::vector<float> result(expected.size());
+        convolution.correlate(
+            [&](int y, int z, float* row) {
+                std::copy_n(&grid[(static_cast<size_t>(z) * gridHeight + y) * gridWidth], gridWidth, row);
+            },
+            [&](int y, int z, const float* row) {
+                std::copy_n(row, width, &result[(static_cast<size_t>(z) * height + y) * width]);
+            });
+        double error = 0.0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            error = std::max(error, std::abs(result[i] - expected[i]));
+        }
+        return error;
+    }
+}
+
+/**
+ * @brief Runs tests for the Fourier transforms and FFT convolution
+ *
+ * Tests include:
+ * - Fast sizes (factors 2, 3 and 5 only)
+ * - Complex transforms of radix 2, 3, 4, 5, mixed and prime sizes matching a direct DFT,
+ *   and inverse transforms undoing them
+ * - Real transforms matching complex ones
+ * - 2D and 3D correlation with full and separable kernels matching direct evaluation
+ * - The cost model preferring direct convolution for small kernels and FFT for large ones
+ */
+void runFourierTransformTests() {
+    std::cout << "  Testing FourierTransform..." << std::endl;
+
+    // Test 1: Fast sizes
+    CHECK(FourierTransform::nextFastSize(1) == 1 && FourierTransform::nextFastSize(7) == 8 &&
+          FourierTransform::nextFastSize(97) == 100 && FourierTransform::nextFastSize(121) == 125,
+          "nextFastSize returns 2-3-5-smooth sizes");
+    CHECK_THROWS(FourierTransform(0), "Empty transform rejected");
+    CHECK_THROWS(RealFourierTransform(7), "Odd real transform rejected");
+
+    // Test 2: Complex transforms match a direct DFT and invert
+    for (int n : {1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 30, 49, 60, 64, 77, 120, 125, 243}) {
+        std::vector<float> noise = makeNoise(2 * static_cast<size_t>(n), n);
+        std::vector<std::complex<float>> data(n);
+        for (int j = 0; j < n; j++) data[j] = {noise[2 * j], noise[2 * j + 1]};
+        std::vector<std::complex<double>> expected = referenceTransform(data);
+        std::vector<std::complex<float>> transformed = data;
+        FourierTransform transform(n);
+        transform.forward(transformed.data());
+        double error = 0.0;
+        for (int k = 0; k < n; k++) error = std::max(error, std::abs(std::complex<double>(transformed[k]) - expected[k]));
+        transform.inverse(transformed.data());
+        double roundTrip = 0.0;
+        for (int j = 0; j < n; j++) roundTrip = std::max(roundTrip, static_cast<double>(std::abs(transformed[j] / static_cast<float>(n) - data[j])));
+        CHECK(error < 1e-5 * n + 1e-5 && roundTrip < 1e-5, "Transform of size " << n << " matches the DFT and inverts");
+    }
+
+    // Test 3: Real transforms match complex ones and invert
+    for (int n : {2, 4, 6, 10, 18, 64, 100}) {
+        std::vector<float> input = makeNoise(n, 3 * n);
+        std::vector<std::complex<float>> complexInput(input.begin(), input.end());
+        std::vector<std::complex<double>> expected = referenceTransform(complexInput);
+        RealFourierTransform transform(n);
+        std::vector<std::complex<float>> spectrum(n / 2 + 1);
+        transform.forward(input.data(), spectrum.data());
+        double error = 0.0;
+        for (int k = 0; k <= n / 2; k++) error = std::max(error, std::abs(std::complex<double>(spectrum[k]) - expected[k]));
+        std::vector<float> output(n);
+        transform.inverse(spectrum.data(), output.data());
+        double roundTrip = 0.0;
+        for (int j = 0; j < n; j++) roundTrip = std::max(roundTrip, static_cast<double>(std::abs(output[j] / n - input[j])));
+        CHECK(error < 1e-5 * n && roundTrip < 1e-5, "Real transform of size " << n << " matches and inverts");
+    }
+
+    // Test 4: Correlation matches direct evaluation
+    {
+        int width = 37, height = 23, kw = 9, kh = 6;
+        std::vector<float> grid = makeNoise(static_cast<size_t>(width + kw - 1) * (height + kh - 1), 17);
+        std::vector<float> kernel = makeNoise(static_cast<size_t>(kw) * kh, 29);
+        std::vector<double> expected = referenceCorrelation(grid, width, height, 1, kernel, kw, kh, 1);
+        FourierConvolution full(width, height, 1, kernel, kw, kh, 1);
+        CHECK(convolutionError(full, grid, expected, width, height, height + kh - 1) < 1e-4,
+              "2D correlation with a full kernel matches direct evaluation");
+
+        std::vector<float> kx = makeNoise(kw, 31), ky = makeNoise(kh, 37);
+        std::vector<float> outer(static_cast<size_t>(kw) * kh);
+        for (int j = 0; j < kh; j++) for (int i = 0; i < kw; i++) outer[j * kw + i] = kx[i] * ky[j];
+        expected = referenceCorrelation(grid, width, height, 1, outer, kw, kh, 1);
+        FourierConvolution separable(width, height, 1, kx, ky, {1.0f});
+        CHECK(convolutionError(separable, grid, expected, width, height, height + kh - 1) < 1e-4,
+              "2D correlation with a separable kernel matches direct evaluation");
+    }
+    {
+        int width = 11, height = 9, depth = 7, kw = 3, kh = 5, kd = 4;
+        std::vector<float> grid = makeNoise(static_cast<size_t>(width + kw - 1) * (height + kh - 1) * (depth + kd - 1), 41);
+        std::vector<float> kx = makeNoise(kw, 43), ky = makeNoise(kh, 47), kz = makeNoise(kd, 53);
+        std::vector<float> outer(static_cast<size_t>(kw) * kh * kd);
+        for (int k = 0; k < kd; k++) for (int j = 0; j < kh; j++) for (int i = 0; i < kw; i++) {
+            outer[(k * kh + j) * kw + i] = kx[i] * ky[j] * kz[k];
+        }
+        std::vector<double> expected = referenceCorrelation(grid, width, height, depth, outer, kw, kh, kd);
+        CHECK(convolutionError(FourierConvolution(width, height, depth, kx, ky, kz), grid, expected,
+                               width, height, height + kh - 1) < 1e-4,
+              "3D correlation with a separable kernel matches direct evaluation");
+        CHECK(convolutionError(FourierConvolution(width, height, depth, outer, kw, kh, kd), grid, expected,
+                               width, height, height + kh - 1) < 1e-4,
+              "3D correlation with a full kernel matches direct evaluation");
+    }
+
+    // Test 5: Cost model
+    CHECK(!FourierConvolution::isCheaper(9, 512, 512, 1, 3, 3, 1), "Direct convolution preferred for a 3x3 kernel");
+    CHECK(FourierConvolution::isCheaper(101 * 101, 512, 512, 1, 101, 101, 1), "FFT preferred for a 101x101 kernel");
+}
@@ -2,10 +2,12 @@
 #include "../src/Volume.h"
 #include "../src/Pixel.h"
 #include "TestCounters.h"
+#include "TestImages.h"
 #include <cmath>
 #include <iostream>
 #include <memory>
 #include <tuple>
+#include <algorithm>
 
 void test_constructor_validation() {
     // Test valid kernel sizes
@@ -109,6 +111,105 @@ void test_boundary_handling() {
     CHECK_NOTHROW(filtered->getVoxel(0, 0, 0), "Edge voxel accessible");
 }
 
+// Reference: the full k*k*k kernel with in-bounds renormalisation
+static Pixel bruteForceGaussian(const Volume& vol, int x, int y, int z, int kernelSize, float sigma) {
+    int width, height, depth;
+    std::tie(width, height, depth) = vol.getDimensions3D();
+    int radius = kernelSize / 2;
+    double sums[4] = {0, 0, 0, 0};
+    double weightSum = 0;
+    for (int kz = -radius; kz <= radius; ++kz) {
+        for (int ky = -radius; ky <= radius; ++ky) {
+            for (int kx = -radius; kx <= radius; ++kx) {
+                int sx = x + kx, sy = y + ky, sz = z + kz;
+                if (!vol.isInBounds3D(sx, sy, sz)) continue;
+                double w = std::exp(-(kx * kx + ky * ky + kz * kz) / (2.0 * sigma * sigma));
+                Pixel p = vol.getVoxel(sx, sy, sz);
+                sums[0] += p.getR() * w;
+                sums[1] += p.getG() * w;
+                sums[2] += p.getB() * w;
+                sums[3] += p.getA() * w;
+                weightSum += w;
+            }
+        }
+    }
+    auto toByte = [&](double v) { return static_cast<unsigned char>(std::round(v / weightSum)); };
+    return Pixel(toByte(sums[0]), toByte(sums[1]), toByte(sums[2]), toByte(sums[3]));
+}
+
+void test_separable_matches_full_kernel() {
+    // The separable passes must agree with the full 3D kernel to within one grey level,
+    // including the renormalised borders
+    for (int channels : {1, 3}) {
+        Volume vol(7, 6, 5, channels, "Noise");
+        unsigned int seed = 12345;
+        for (int z = 0; z < 5; z++) {
+            for (int y = 0; y < 6; y++) {
+                for (int x = 0; x < 7; x++) {
+                    unsigned int noise = nextNoise(seed);
+                    vol.setVoxel(x, y, z, Pixel(noise & 255, (seed >> 8) & 255, seed & 255));
+                }
+            }
+        }
+
+        for (int kernelSize : {3, 5}) {
+            Gaussian3DFilter filter(kernelSize, 1.3f);
+            auto filtered = filter.apply(vol);
+            int maxDiff = 0;
+            for (int z = 0; z < 5; z++) {
+                for (int y = 0; y < 6; y++) {
+                    for (int x = 0; x < 7; x++) {
+                        Pixel expected = bruteForceGaussian(vol, x, y, z, kernelSize, 1.3f);
+                        Pixel actual = filtered->getVoxel(x, y, z);
+                        maxDiff = std::max({maxDiff, std::abs(expected.getR() - actual.getR()),
+                                            std::abs(expected.getG() - actual.getG()),
+                                            std::abs(expected.getB() - actual.getB())});
+                    }
+                }
+            }
+            CHECK(maxDiff <= 1, "Separable Gaussian matches full 3D kernel (" << channels
+                  << " channels, kernel " << kernelSize << ")");
+        }
+    }
+}
+
+void test_fourier_matches_separable() {
+    // Fourier transforms of the zero-padded volume, renormalised at the borders, must
+    // agree with the separable passes to within one grey level
+    using Method = Gaussian3DFilter::Method;
+    for (int channels : {1, 3}) {
+        Volume vol(9, 8, 7, channels, "Noise");
+        unsigned int seed = 777;
+        for (int z = 0; z < 7; z++) {
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 9; x++) {
+                    unsigned int noise = nextNoise(seed);
+                    vol.setVoxel(x, y, z, Pixel(noise & 255, (seed >> 8) & 255, seed & 255));
+                }
+            }
+        }
+        for (int kernelSize : {3, 7}) {
+            auto separable = Gaussian3DFilter(kernelSize, 1.5f, Method::Separable).apply(vol);
+            auto fourier = Gaussian3DFilter(kernelSize, 1.5f, Method::Fourier).apply(vol);
+            int maxDiff = 0;
+            for (int z = 0; z < 7; z++) {
+                for (int y = 0; y < 8; y++) {
+                    for (int x = 0; x < 9; x++) {
+                        Pixel a = separable->getVoxel(x, y, z);
+                        Pixel b = fourier->getVoxel(x, y, z);
+                        maxDiff = std::max({maxDiff, std::abs(a.getR() - b.getR()),
+                                            std::abs(a.getG() - b.getG()), std::abs(a.getB() - b.getB())});
+                    }
+                }
+            }
+            CHECK(maxDiff <= 1, "Fourier Gaussian matches separable passes (" << channels
+                  << " channels, kernel " << kernelSize << ")");
+        }
+    }
+    CHECK(!Gaussian3DFilter(3, 1.0f).usesFourierTransform(256, 256, 256), "Auto keeps small kernels separable");
+    CHECK(Gaussian3DFilter(41, 10.0f).usesFourierTransform(256, 256, 256), "Auto uses transforms for very large kernels");
+}
+
 void runGaussian3DFilterTests() {
     std::cout << "\n=== Running Gaussian3DFilter Tests ===\n";
     test_constructor_validation();
@@ -117,5 +218,7 @@ void runGaussian3DFilterTests() {
     test_constant_volume();
     test_single_spike_volume();
     test_boundary_handling();
+    test_separable_matches_full_kernel();
+    test_fourier_matches_separable();
 
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**
+ * @file testGaussianBlurFilter.cpp
+ * @brief Tests for the GaussianBlurFilter class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/GaussianBlurFilter.h"
+#include "../src/Image.h"
+#include "../src/Pixel.h"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    // Reference: the original direct k x k convolution (kernel normalised over the window,
+    // out-of-bounds taps skipped without renormalisation, results truncated)
+    Image directGaussian(const Image& input, int kernelSize, float sigma) {
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int half = kernelSize / 2;
+        double s = 2.0 * sigma * sigma;
+        std::vector<double> kernel(kernelSize * kernelSize);
+        double sum = 0.0;
+        for (int y = -half; y <= half; y++) {
+            for (int x = -half; x <= half; x++) {
+                double value = std::exp(-(x * x + y * y) / s) / (M_PI * s);
+                kernel[(y + half) * kernelSize + (x + half)] = value;
+                sum += value;
+            }
+        }
+        for (double& value : kernel) value /= sum;
+
+        Image output(width, height, input.getChannels());
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                double sums[4] = {0, 0, 0, 0};
+                for (int j = -half; j <= half; j++) {
+                    for (int i = -half; i <= half; i++) {
+                        if (!input.isInBounds(x + i, y + j)) continue;
+                        Pixel p = input.getPixel(x + i, y + j);
+                        double w = kernel[(j + half) * kernelSize + (i + half)];
+                        sums[0] += p.getR() * w;
+                        sums[1] += p.getG() * w;
+                        sums[2] += p.getB() * w;
+                        sums[3] += p.getA() * w;
+                    }
+                }
+                output.setPixel(x, y, Pixel(static_cast<unsigned char>(sums[0]), static_cast<unsigned char>(sums[1]),
+                                            static_cast<unsigned char>(sums[2]), static_cast<unsigned char>(sums[3])));
+            }
+        }
+        return output;
+    }
+
+    // Smooth gradient plus noise, so both flat and busy areas are covered
+    Image makeTestImage(int width, int height, int channels) {
+        Image image(width, height, channels);
+        unsigned int seed = 2024;
+        for (int y = 0; y < height; y++) {
+            unsigned char* row = image.getRow(y);
+            for (int i = 0; i < width * channels; i++) {
+                int noise = static_cast<int>(nextNoise(seed) % 64);
+                row[i] = static_cast<unsigned char>((i / channels * 3 + y * 2 + noise) % 256);
+            }
+        }
+        return image;
+    }
+
+    // Largest per-sample difference between two images of the same shape
+    int maxDifference(const Image& a, const Image& b) {
+        int maxDiff = 0;
+        for (int y = 0; y < a.getHeight(); y++) {
+            auto rowA = a.getRowSpan(y);
+            auto rowB = b.getRowSpan(y);
+            for (size_t i = 0; i < rowA.size(); i++) {
+                maxDiff = std::max(maxDiff, std::abs(rowA[i] - rowB[i]));
+            }
+        }
+        return maxDiff;
+    }
+}
+
+/**
+ * @brief Runs tests for the GaussianBlurFilter class
+ *
+ * This function tests:
+ * - Constructor validation and automatic method selection.
+ * - The separable and recursive implementations against the original direct 2D
+ *   convolution. Both must stay within one grey level of it everywhere, borders included
+ *   (results are truncated, so floating point rounding alone can move a value by one).
+ * - The Fourier implementation against the separable one, and Auto falling back to the
+ *   separable passes on images too small for transforms to pay off.
+ */
+void runGaussianBlurFilterTests() {
+    std::cout << "  Testing GaussianBlurFilter..." << std::endl;
+
+    // Test 1: Constructor validation
+    CHECK_THROWS(GaussianBlurFilter(4, 1.0f), "Even kernel size throws");
+    CHECK_THROWS(GaussianBlurFilter(1, 1.0f), "Kernel size below 3 throws");
+
+    // Test 2: Automatic method selection
+    using Method = GaussianBlurFilter::Method;
+    CHECK(GaussianBlurFilter(5, 2.0f).getEffectiveMethod() == Method::Separable, "Small kernel is separable");
+    CHECK(GaussianBlurFilter(31, 5.0f).getEffectiveMethod() == Method::Recursive, "Large kernel is recursive");
+    CHECK(GaussianBlurFilter(29, 8.0f).getEffectiveMethod() == Method::Separable,
+          "Kernel truncating the Gaussian stays separable");
+    CHECK(GaussianBlurFilter(31, 8.0f).getEffectiveMethod() == Method::Fourier,
+          "Very large kernel truncating the Gaussian uses Fourier transforms");
+    CHECK(GaussianBlurFilter(31, 8.0f).getRowHalo() == -1, "Fourier method needs the whole image");
+    CHECK(GaussianBlurFilter(5, 2.0f, Method::Recursive).getEffectiveMethod() == Method::Recursive,
+          "Explicit method is honoured");
+
+    // Test 3: Accuracy against the direct convolution
+    for (int channels : {1, 3, 4}) {
+        Image input = makeTestImage(53, 41, channels);
+
+        Image reference5 = directGaussian(input, 5, 2.0f);
+        Image separable5 = GaussianBlurFilter(5, 2.0f, Method::Separable).apply(input);
+        CHECK(maxDifference(reference5, separable5) <= 1,
+              "Separable Gaussian 5 within one level (" << channels << " channels)");
+
+        Image reference21 = directGaussian(input, 21, 3.0f);
+        Image separable21 = GaussianBlurFilter(21, 3.0f, Method::Separable).apply(input);
+        Image recursive21 = GaussianBlurFilter(21, 3.0f, Method::Recursive).apply(input);
+        CHECK(maxDifference(reference21, separable21) <= 1,
+              "Separable Gaussian 21 within one level (" << channels << " channels)");
+        CHECK(maxDifference(reference21, recursive21) <= 1,
+              "Recursive Gaussian 21 within one level (" << channels << " channels)");
+    }
+
+    // Test 4: Fourier transforms against the separable passes, borders included
+    for (int channels : {1, 3, 4}) {
+        Image input = makeTestImage(53, 41, channels);
+        Image separable = GaussianBlurFilter(21, 8.0f, Method::Separable).apply(input);
+        Image fourier = GaussianBlurFilter(21, 8.0f, Method::Fourier).apply(input);
+        CHECK(maxDifference(separable, fourier) <= 1,
+              "Fourier Gaussian 21 within one level of separable (" << channels << " channels)");
+    }
+    {
+        // Too small for transforms to pay off: Auto runs the separable passes
+        Image input = makeTestImage(6, 5, 3);
+        Image separable = GaussianBlurFilter(31, 8.0f, Method::Separable).apply(input);
+        CHECK(maxDifference(GaussianBlurFilter(31, 8.0f).apply(input), separable) == 0,
+              "Auto falls back to separable passes on a tiny image");
+    }
+
+    // Test 5: Output keeps dimensions and channels
+    Image input = makeTestImage(20, 10, 2);
+    Image output = GaussianBlurFilter(15, 2.0f).apply(input);
+    CHECK(output.getWidth() == 20 && output.getHeight() == 10 && output.getChannels() == 2,
+          "Output dimensions and channels match input");
+}
@@ -0,0 +1,153 @@
+/**
+ * @file testGradientKernels.cpp
+ * @brief Tests for the GradientKernels class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/GradientKernels.h"
+#include "../src/filter2D/PrewittFilter.h"
+#include "../src/filter2D/RobertsCrossFilter.h"
+#include "../src/filter2D/ScharrFilter.h"
+#include "../src/filter2D/SobelFilter.h"
+#include "../src/Image.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    using InstructionSet = GradientKernels::InstructionSet;
+
+    struct Operator {
+        std::string name;
+        int size;
+        int origin;
+        std::vector<int> kernelX;
+        std::vector<int> kernelY;
+    };
+
+    const std::vector<Operator> operators = {
+        {"Sobel", 3, 1, {-1, 0, 1, -2, 0, 2, -1, 0, 1}, {-1, -2, -1, 0, 0, 0, 1, 2, 1}},
+        {"Prewitt", 3, 1, {-1, 0, 1, -1, 0, 1, -1, 0, 1}, {-1, -1, -1, 0, 0, 0, 1, 1, 1}},
+        {"Scharr", 3, 1, {-3, 0, 3, -10, 0, 10, -3, 0, 3}, {-3, -10, -3, 0, 0, 0, 3, 10, 3}},
+        {"RobertsCross", 2, 0, {1, 0, 0, -1}, {0, 1, -1, 0}},
+        {"Too wide for 16 bits", 3, 1, {-40, 0, 40, -80, 0, 80, -40, 0, 40}, {0, 0, 0, 0, 1, 0, 0, 0, 0}},
+    };
+
+    std::vector<unsigned char> makeNoiseRows(int width, int rows) {
+        std::vector<unsigned char> samples(static_cast<size_t>(width) * rows);
+        unsigned int seed = 5;
+        for (unsigned char& sample : samples) {
+            unsigned int noise = nextNoise(seed);
+            // Plenty of extremes, which give the largest sums
+            sample = (noise >> 12) < 4 ? (noise & 1 ? 255 : 0) : static_cast<unsigned char>(noise);
+        }
+        return samples;
+    }
+
+    Image makeExtremesImage(int width, int height, int channels) {
+        Image image(width, height, channels);
+        std::vector<unsigned char> samples = makeNoiseRows(width * channels, height);
+        for (int y = 0; y < height; y++) {
+            std::copy_n(&samples[static_cast<size_t>(y) * width * channels], width * channels, image.getRow(y));
+        }
+        return image;
+    }
+
+    // Magnitudes of every interior column, computed directly
+    std::vector<int> referenceSpan(const std::vector<unsigned char>& samples, int width, const Operator& op) {
+        std::vector<int> magnitudes(width, -1);
+        for (int x = op.origin; x + op.size - 1 - op.origin < width; x++) {
+            int gx = 0;
+            int gy = 0;
+            for (int ky = 0; ky < op.size; ky++) {
+                for (int kx = 0; kx < op.size; kx++) {
+                    int pixel = samples[static_cast<size_t>(ky) * width + x + kx - op.origin];
+                    gx += pixel * op.kernelX[ky * op.size + kx];
+                    gy += pixel * op.kernelY[ky * op.size + kx];
+                }
+            }
+            magnitudes[x] = std::abs(gx) + std::abs(gy);
+        }
+        return magnitudes;
+    }
+}
+
+/**
+ * @brief Runs tests for the GradientKernels class
+ *
+ * Tests include:
+ * - Every supported instruction set matching a direct evaluation, for each edge operator,
+ *   widths that leave every possible number of columns to the scalar tail, and kernels
+ *   too large for 16-bit lanes
+ * - Edge filters giving identical images with every supported instruction set
+ * - Dispatch: the scalar version is always supported and the best one is active
+ */
+void runGradientKernelsTests() {
+    std::cout << "  Testing GradientKernels..." << std::endl;
+
+    const InstructionSet best = GradientKernels::getActive();
+    std::vector<InstructionSet> sets;
+    for (InstructionSet set : {InstructionSet::SCALAR, InstructionSet::SSE41, InstructionSet::AVX2}) {
+        if (GradientKernels::isSupported(set)) {
+            sets.push_back(set);
+        }
+    }
+
+    // Test 1: Dispatch
+    CHECK(GradientKernels::isSupported(InstructionSet::SCALAR), "Scalar version is always supported");
+    CHECK(sets.back() == best, "Best supported instruction set (" << GradientKernels::getName(best)
+                               << ") is active at start-up");
+
+    // Test 2: Spans match a direct evaluation
+    for (InstructionSet set : sets) {
+        GradientKernels::setActive(set);
+        for (const Operator& op : operators) {
+            bool same = true;
+            for (int width = op.size; width <= 70; width++) {
+                std::vector<unsigned char> samples = makeNoiseRows(width, op.size);
+                const unsigned char* rows[3];
+                for (int ky = 0; ky < op.size; ky++) {
+                    rows[ky] = &samples[static_cast<size_t>(ky) * width];
+                }
+                std::vector<int> magnitudes(width, -1);
+                GradientKernels::gradientSpan(rows, op.size, op.origin, op.kernelX.data(), op.kernelY.data(),
+                                              op.origin, width - (op.size - 1 - op.origin), magnitudes.data());
+                same = same && magnitudes == referenceSpan(samples, width, op);
+            }
+            CHECK(same, op.name << " spans match with " << GradientKernels::getName(set));
+        }
+    }
+
+    // Test 3: Edge filters are identical with every instruction set
+    for (int channels : {1, 3}) {
+        Image input = makeExtremesImage(53, 17, channels);
+        GradientKernels::setActive(InstructionSet::SCALAR);
+        Image sobel = SobelFilter().apply(input);
+        Image prewitt = PrewittFilter().apply(input);
+        Image scharr = ScharrFilter().apply(input);
+        Image roberts = RobertsCrossFilter().apply(input);
+        for (InstructionSet set : sets) {
+            GradientKernels::setActive(set);
+            bool same = sameImage(SobelFilter().apply(input), sobel) &&
+                        sameImage(PrewittFilter().apply(input), prewitt) &&
+                        sameImage(ScharrFilter().apply(input), scharr) &&
+                        sameImage(RobertsCrossFilter().apply(input), roberts);
+            CHECK(same, "Edge filters on " << channels << " channels identical with "
+                        << GradientKernels::getName(set));
+        }
+    }
+    GradientKernels::setActive(best);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file testImage.cpp
+ * @brief Tests for the Image class storage layout and view API
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "../src/Image.h"
+#include "../src/ImageView.h"
+#include "../src/Pixel.h"
+#include <iostream>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Runs tests for the Image class
+ *
+ * This function tests:
+ * - Construction, default pixel values and channel validation.
+ * - Checked getPixel / setPixel, including out of bounds access.
+ * - Row stride and alignment of the contiguous sample buffer.
+ * - Row pointers, row spans and views agreeing with getPixel / setPixel.
+ * - Copying from a strided view and cloning.
+ */
+void runImageTests() {
+    std::cout << "  Testing Image..." << std::endl;
+
+    // Test 1: Construction and defaults
+    Image rgba(13, 7, 4);
+    CHECK(rgba.getWidth() == 13 && rgba.getHeight() == 7, "Image dimensions correct");
+    CHECK(rgba.getChannels() == 4, "Image channels correct");
+    CHECK(rgba.getPixel(12, 6) == Pixel(), "Default pixel is black and opaque");
+    CHECK_THROWS(Image(10, 10, 0), "Zero channels throws");
+    CHECK_THROWS(Image(10, 10, 5), "Five channels throws");
+    CHECK_THROWS(Image(0, 10, 3), "Zero width throws");
+
+    // Test 2: Checked access
+    Pixel p(10, 20, 30, 40);
+    rgba.setPixel(3, 2, p);
+    CHECK(rgba.getPixel(3, 2) == p, "Pixel set/get matches");
+    CHECK_THROWS(rgba.getPixel(13, 0), "X out of bounds throws");
+    CHECK_THROWS(rgba.setPixel(0, 7, p), "Y out of bounds throws");
+    CHECK_THROWS(rgba.getPixel(-1, 0), "Negative coordinate throws");
+
+    // Test 3: Row stride and alignment
+    CHECK(rgba.getRowStride() >= 13 * 4, "Row stride covers a full row");
+    CHECK(rgba.getRowStride() % Image::ROW_ALIGNMENT == 0, "Row stride is a multiple of the alignment");
+    bool aligned = true;
+    for (int y = 0; y < rgba.getHeight(); ++y) {
+        if (reinterpret_cast<std::uintptr_t>(rgba.getRow(y)) % Image::ROW_ALIGNMENT != 0) aligned = false;
+    }
+    CHECK(aligned, "Every row starts on an aligned address");
+
+    // Test 4: Raw rows, spans and views agree with checked access
+    const unsigned char* row = rgba.getRow(2);
+    CHECK(row[3 * 4] == 10 && row[3 * 4 + 1] == 20 && row[3 * 4 + 2] == 30 && row[3 * 4 + 3] == 40,
+          "Row pointer exposes interleaved samples");
+    CHECK(rgba.getRowSpan(2).size() == 13 * 4, "Row span excludes padding");
+    ImageView view = rgba.getView();
+    view.setPixel(5, 5, Pixel(1, 2, 3, 4));
+    CHECK(rgba.getPixel(5, 5) == Pixel(1, 2, 3, 4), "Writes through a view are visible in the image");
+    ConstImageView constView = view;
+    CHECK(constView.getPixel(3, 2) == p, "Const view reads the same pixel");
+
+    // Test 5: Single channel storage expands like loading does
+    Image grey(5, 5, 1);
+    grey.setPixel(1, 1, Pixel(200, 7, 9, 100));
+    CHECK(grey.getPixel(1, 1) == Pixel(200, 200, 200, 255), "Greyscale pixel keeps only one sample");
+    CHECK(grey.getRowSpan(0).size() == 5, "Greyscale row span is one byte per pixel");
+
+    // Test 6: Copy from a strided (every other column) view
+    ConstImageView everyOther(rgba.getRow(0), 7, 7, 4, rgba.getRowStride(), 8);
+    Image sub(everyOther);
+    CHECK(sub.getWidth() == 7 && sub.getChannels() == 4, "Strided copy dimensions correct");
+    CHECK(sub.getPixel(2, 5) == rgba.getPixel(4, 5), "Strided copy picks the right pixels");
+
+    // Test 7: Clone is a deep copy
+    auto copy = rgba.clone();
+    rgba.setPixel(3, 2, Pixel());
+    CHECK(copy->getPixel(3, 2) == p, "Clone is independent of the original");
+
+    // Test 8: Row greyscale conversion matches per-pixel conversion for every channel count
+    bool sameGrey = true;
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> samples(256 * channels);
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = static_cast<unsigned char>((i * 97 + i / channels * 31) % 256);
+        }
+        std::vector<unsigned char> greyRow(256);
+        Pixel::toGreyscaleRow(samples.data(), channels, 256, greyRow.data());
+        for (int x = 0; x < 256; x++) {
+            sameGrey = sameGrey &&
+                greyRow[x] == Pixel::fromSamples(&samples[x * channels], channels).toGreyscale().getR();
+        }
+    }
+    CHECK(sameGrey, "Row greyscale conversion matches Pixel::toGreyscale");
+}
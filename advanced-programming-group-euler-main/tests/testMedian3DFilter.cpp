@@ -73,8 +73,11 @@
 #include "../src/Volume.h"
 #include "../src/Pixel.h"
 #include "TestCounters.h"
+#include "TestImages.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 void test_constructor_validation_1() {
@@ -126,8 +129,8 @@ void test_single_spike_removal() {
     Median3DFilter filter(3);
     auto filtered = filter.apply(vol);
     
-    // Spike should be replaced with 50
-    CHECK(filtered->getVoxel(2, 2, 2) == Pixel(50, 0, 0), "Single spike removed");
+    // Spike should be replaced with 50 (single-channel voxels read back as grey)
+    CHECK(filtered->getVoxel(2, 2, 2) == Pixel(50, 50, 50), "Single spike removed");
 }
 
 void test_median_calculation() {
@@ -152,7 +155,7 @@ void test_median_calculation() {
     
     // Center voxel's neighborhood contains all 27 values
     // Sorted median of all values
-    CHECK(filtered->getVoxel(1, 1, 1) == Pixel(16, 0, 0), "Correct median calculation");
+    CHECK(filtered->getVoxel(1, 1, 1) == Pixel(16, 16, 16), "Correct median calculation");
 }
 
 void test_edge_handling() {
@@ -195,6 +198,51 @@ void test_multi_channel_support() {
     CHECK(p.getA() == 255, "Alpha preserved");
 }
 
+// Reference median: gather the in-bounds neighbourhood of every sample and sort it
+unsigned char bruteForceMedian(const Volume& vol, int x, int y, int z, int c, int radius) {
+    int width, height, depth;
+    std::tie(width, height, depth) = vol.getDimensions3D();
+    std::vector<unsigned char> values;
+    for (int sz = std::max(0, z - radius); sz <= std::min(depth - 1, z + radius); sz++) {
+        for (int sy = std::max(0, y - radius); sy <= std::min(height - 1, y + radius); sy++) {
+            for (int sx = std::max(0, x - radius); sx <= std::min(width - 1, x + radius); sx++) {
+                values.push_back(vol.getVoxelPtr(sx, sy, sz)[c]);
+            }
+        }
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+void test_sliding_matches_sorted_median() {
+    for (int channels : {1, 3}) {
+        Volume vol(11, 9, 7, channels, "NoiseVolume");
+        unsigned int seed = 12345;
+        unsigned char* data = vol.getData();
+        for (int i = 0; i < 11 * 9 * 7 * channels; i++) {
+            data[i] = static_cast<unsigned char>(nextNoise(seed));
+        }
+
+        for (int kernelSize : {3, 5}) {
+            auto filtered = Median3DFilter(kernelSize).apply(vol);
+            bool identical = true;
+            for (int z = 0; z < 7; z++) {
+                for (int y = 0; y < 9; y++) {
+                    for (int x = 0; x < 11; x++) {
+                        for (int c = 0; c < channels; c++) {
+                            if (filtered->getVoxelPtr(x, y, z)[c] != bruteForceMedian(vol, x, y, z, c, kernelSize / 2)) {
+                                identical = false;
+                            }
+                        }
+                    }
+                }
+            }
+            CHECK(identical, "Sliding median " << kernelSize << " matches sorted median ("
+                  << channels << " channels)");
+        }
+    }
+}
+
 void runMedian3DFilterTests() {
     std::cout << "\n=== Running Median3DFilter Tests ===\n";
     test_constructor_validation_1();
@@ -203,6 +251,7 @@ void runMedian3DFilterTests() {
     test_median_calculation();
     test_edge_handling();
     test_multi_channel_support();
+    test_sliding_matches_sorted_median();
     // std::cout << "\nMedian3DFilter Tests Summary: "
     //           << passed << " passed, " << failed << " failed\n";
 }
\ No newline at end of file
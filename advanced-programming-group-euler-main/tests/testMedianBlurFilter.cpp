@@ -0,0 +1,102 @@
+/**
+ * @file testMedianBlurFilter.cpp
+ * @brief Tests for the MedianBlurFilter class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/MedianBlurFilter.h"
+#include "../src/Image.h"
+#include "../src/Pixel.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace {
+    // Reference: sort the in-bounds samples of each channel and take index n / 2
+    Image sortedMedian(const Image& input, int kernelSize) {
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int channels = input.getChannels();
+        int half = kernelSize / 2;
+        Image output(width, height, channels);
+        std::vector<unsigned char> values;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < channels; c++) {
+                    values.clear();
+                    for (int j = std::max(y - half, 0); j <= std::min(y + half, height - 1); j++) {
+                        for (int i = std::max(x - half, 0); i <= std::min(x + half, width - 1); i++) {
+                            values.push_back(input.getRow(j)[i * channels + c]);
+                        }
+                    }
+                    std::sort(values.begin(), values.end());
+                    output.getRow(y)[x * channels + c] = values[values.size() / 2];
+                }
+            }
+        }
+        return output;
+    }
+
+    // Noise with salt-and-pepper outliers
+    Image makeNoisyImage(int width, int height, int channels) {
+        Image image(width, height, channels);
+        unsigned int seed = 99;
+        for (int y = 0; y < height; y++) {
+            unsigned char* row = image.getRow(y);
+            for (int i = 0; i < width * channels; i++) {
+                unsigned int r = nextNoise(seed);
+                row[i] = (r % 10 == 0) ? 255 : (r % 10 == 1) ? 0 : static_cast<unsigned char>(100 + r % 50);
+            }
+        }
+        return image;
+    }
+
+}
+
+/**
+ * @brief Runs tests for the MedianBlurFilter class
+ *
+ * This function tests:
+ * - Constructor validation.
+ * - Removal of an isolated outlier.
+ * - Bit-identical results to a sorted median, borders included, for small kernels (sample
+ *   by sample histogram updates) and tall kernels (column histograms).
+ */
+void runMedianBlurFilterTests() {
+    std::cout << "  Testing MedianBlurFilter..." << std::endl;
+
+    // Test 1: Constructor validation
+    CHECK_THROWS(MedianBlurFilter(4), "Even kernel size throws");
+    CHECK_THROWS(MedianBlurFilter(1), "Kernel size below 3 throws");
+
+    // Test 2: An isolated outlier is removed
+    Image flat(7, 7, 1);
+    for (int y = 0; y < 7; y++) {
+        for (int x = 0; x < 7; x++) flat.setPixel(x, y, Pixel(60, 60, 60));
+    }
+    flat.setPixel(3, 3, Pixel(255, 255, 255));
+    Image cleaned = MedianBlurFilter(3).apply(flat);
+    CHECK(cleaned.getPixel(3, 3) == Pixel(60, 60, 60), "Salt pixel removed");
+
+    // Test 3: Bit-identical to the sorted median
+    for (int channels : {1, 3, 4}) {
+        Image input = makeNoisyImage(61, 47, channels);
+        for (int kernelSize : {3, 5, 9, 31, 41, 101}) {
+            Image expected = sortedMedian(input, kernelSize);
+            Image actual = MedianBlurFilter(kernelSize).apply(input);
+            CHECK(sameImage(expected, actual),
+                  "Median " << kernelSize << " matches sorted median (" << channels << " channels)");
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file testPointOperationChain.cpp
+ * @brief Tests for the PointOperationChain class functionality
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/PointOperationChain.h"
+#include "../src/filter2D/SimpleFilters.h"
+#include "../src/Image.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // One chain step in the "b100", "g", "t128" shorthand used below
+    void addStep(PointOperationChain& chain, const std::string& step) {
+        if (step[0] == 'b') chain.addBrightness(std::stoi(step.substr(1)));
+        else if (step[0] == 'g') chain.addGreyscale();
+        else chain.addThreshold(std::stoi(step.substr(1)));
+    }
+
+    // The same step through the unfused SimpleFilters pass
+    Image applyStep(const Image& image, const std::string& step) {
+        SimpleFilters filters("Reference");
+        if (step[0] == 'b') return filters.applyBrightness(image, std::stoi(step.substr(1)));
+        if (step[0] == 'g') return filters.applyGreyscale(image);
+        return filters.applyThresholding(image, std::stoi(step.substr(1)));
+    }
+}
+
+/**
+ * @brief Runs tests for the PointOperationChain class
+ *
+ * Tests include:
+ * - Fused chains matching the unfused SimpleFilters passes exactly, for 1 to 4 channels
+ * - Output channel count (greyscale drops to one channel)
+ * - Rejecting brightness 0, which is not a point operation
+ */
+void runPointOperationChainTests() {
+    std::cout << "  Testing PointOperationChain..." << std::endl;
+
+    // Test 1: Fused output is identical to the step-by-step filters
+    const std::vector<std::vector<std::string>> chains = {
+        {"b100"}, {"g"}, {"t128"}, {"b100", "g", "t128"}, {"b-60", "b90", "t77"},
+        {"t128", "b-30", "g"}, {"g", "b40", "g", "t200"}, {"b255", "b-255"}, {"t0", "t256"},
+    };
+    for (int channels = 1; channels <= 4; channels++) {
+        Image input = makeNoiseImage(23, 17, channels);
+        for (const auto& steps : chains) {
+            PointOperationChain chain;
+            Image expected = input;
+            std::string name;
+            for (const std::string& step : steps) {
+                addStep(chain, step);
+                expected = applyStep(expected, step);
+                name += " " + step;
+            }
+            CHECK(sameImage(chain.apply(input), expected),
+                  "Fused chain" << name << " matches unfused on " << channels << " channel(s)");
+        }
+    }
+
+    // Test 2: Channel counts and bookkeeping
+    PointOperationChain chain;
+    CHECK(chain.empty() && sameImage(chain.apply(makeNoiseImage(5, 4, 3)), makeNoiseImage(5, 4, 3)),
+          "Empty chain copies the image");
+    chain.addThreshold(100);
+    CHECK(chain.apply(makeNoiseImage(5, 4, 4)).getChannels() == 4, "Threshold keeps the channel count");
+    chain.addGreyscale();
+    CHECK(chain.size() == 2 && chain.apply(makeNoiseImage(5, 4, 4)).getChannels() == 1,
+          "Greyscale step gives one channel");
+    chain.clear();
+    CHECK(chain.empty(), "Clear removes every step");
+
+    // Test 3: Brightness 0 depends on the whole image
+    CHECK_THROWS(chain.addBrightness(0), "Brightness 0 cannot be fused");
+}
@@ -1,8 +1,41 @@
 #include "../src/projectionFunc/Projection.h"
 #include "../src/projectionFunc/MaxIntensityProj.h"  // Use for base class testing
+#include "../src/projectionFunc/MinIntensityProj.h"
+#include "../src/projectionFunc/AvgIntensityProj.h"
 #include "../src/Volume.h"
+#include "../src/Image.h"
 #include "TestCounters.h"
+#include "TestImages.h"
 #include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    // Write `depth` pseudo-random slices as PNGs and return their names in Z order
+    std::vector<std::string> writeRandomSlices(const std::filesystem::path& dir, int width, int height,
+                                               int depth, int channels) {
+        std::filesystem::create_directory(dir);
+        std::vector<std::string> files;
+        unsigned int seed = 7;
+        for (int z = 0; z < depth; z++) {
+            Volume slice(width, height, 1, channels, "slice");
+            unsigned char* samples = slice.getData();
+            for (int i = 0; i < width * height * channels; i++) {
+                samples[i] = static_cast<unsigned char>(nextNoise(seed));
+            }
+            if (channels == 4) {
+                for (int i = 3; i < width * height * 4; i += 4) samples[i] = 255;
+            }
+            files.push_back((dir / ("slice" + std::to_string(z) + ".png")).string());
+            slice.saveToFile(files.back());
+        }
+        return files;
+    }
+
+}
 
 
 void runProjectionTests() {
@@ -27,6 +60,37 @@ void runProjectionTests() {
         CHECK_THROWS(proj.setSlabRange(-2, 3), "Negative start throws");
     }
 
+    // Test 3: Streaming from files matches projecting the loaded volume
+    {
+        for (int channels : {1, 3}) {
+            std::filesystem::path dir = "test_projection_stream";
+            std::vector<std::string> files = writeRandomSlices(dir, 13, 9, 10, channels);
+            Volume volume(files, "stream");
+
+            std::vector<std::pair<std::string, std::unique_ptr<Projection>>> projections;
+            projections.emplace_back("MIP", std::make_unique<MaxIntensityProj>(0, -1, 60.0f));
+            projections.emplace_back("MinIP", std::make_unique<MinIntensityProj>());
+            projections.emplace_back("meanAIP", std::make_unique<AvgIntensityProj>(0, -1, false));
+            projections.emplace_back("medianAIP", std::make_unique<AvgIntensityProj>(0, -1, true));
+            projections.emplace_back("medianAIP slab", std::make_unique<AvgIntensityProj>(2, 6, true));
+            projections.emplace_back("meanAIP slab", std::make_unique<AvgIntensityProj>(3, 7, false));
+
+            for (const auto& [name, projection] : projections) {
+                Image expected = projection->apply(volume);
+                for (int batchSize : {1, 3, 0}) {
+                    CHECK(sameImage(projection->applyToFiles(files, batchSize), expected),
+                          "Streamed " << name << " matches in-memory (" << channels
+                          << " channels, batch " << batchSize << ")");
+                }
+            }
+
+            std::filesystem::remove_all(dir);
+        }
+
+        MaxIntensityProj mip;
+        CHECK_THROWS(mip.applyToFiles({"missing_slice.png"}), "Streaming a missing slice throws");
+    }
+
     // std::cout << "\nProjection Tests Summary: "
     //           << passed << " passed, " << failed << " failed\n";
 }
\ No newline at end of file
@@ -108,6 +108,42 @@ void test_use_median_flag() {
     CHECK(medianResult.getPixel(0, 0) == Pixel(0, 0, 0), "Median when useMedian=true");
 }
 
+void test_streamed_median_paths() {
+    // Short slabs are held and sorted by column; only deep slabs count histograms
+    CHECK(!AvgIntensityProj::usesMedianHistograms(64), "Streamed median of 64 slices holds the slab");
+    CHECK(!AvgIntensityProj::usesMedianHistograms(AvgIntensityProj::MEDIAN_HISTOGRAM_MIN_SLICES - 1),
+          "Streamed median holds the slab just below the threshold");
+    CHECK(AvgIntensityProj::usesMedianHistograms(AvgIntensityProj::MEDIAN_HISTOGRAM_MIN_SLICES),
+          "Streamed median counts histograms from the threshold on");
+
+    // Either path gives the same result as projecting the volume
+    AvgIntensityProj proj(0, -1, true);
+    for (int depth : {7, AvgIntensityProj::MEDIAN_HISTOGRAM_MIN_SLICES}) {
+        Volume vol(3, 2, depth, 3, "test");
+        for (int z = 0; z < depth; z++) {
+            for (int y = 0; y < 2; y++) {
+                for (int x = 0; x < 3; x++) {
+                    vol.setVoxel(x, y, z, Pixel((z * 37 + x) % 256, (z * z + y) % 256, (x * y * z) % 256));
+                }
+            }
+        }
+        auto accumulator = proj.createAccumulator(3, 2, 3, depth);
+        std::vector<ConstImageView> planes;
+        for (int z = 0; z < depth; z++) {
+            planes.push_back(vol.getViewXY(z));
+        }
+        accumulator->addSlices(planes);
+        Image streamed = accumulator->result();
+        Image expected = proj.apply(vol);
+        bool same = true;
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 3; x++) {
+                same = same && streamed.getPixel(x, y) == expected.getPixel(x, y);
+            }
+        }
+        CHECK(same, "Streamed median matches apply() for " << depth << " slices");
+    }
+}
 
 void runAvgIntensityProjTests() {
     std::cout << "\n=== Running AvgIntensityProj Tests ===\n";
@@ -115,6 +151,7 @@ void runAvgIntensityProjTests() {
     test_median_projection();
     test_slab_range();
     test_use_median_flag();
+    test_streamed_median_paths();
     // std::cout << "\nAvgIntensityProj Tests Summary: " 
     //             << passed << " passed, " << failed << " failed\n";
 }
\ No newline at end of file
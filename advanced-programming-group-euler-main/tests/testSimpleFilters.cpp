@@ -0,0 +1,107 @@
+/**
+ * @file testSimpleFilters.cpp
+ * @brief Tests for the SimpleFilters histogram equalization
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/filter2D/SimpleFilters.h"
+#include "../src/Image.h"
+#include <iostream>
+#include <vector>
+
+namespace {
+    // Noise with some grey pixels mixed in, so both remapping paths are used
+    Image makeGreyMixImage(int width, int height, int channels) {
+        Image image = makeNoiseImage(width, height, channels, 11);
+        for (int y = 0; y < height; y++) {
+            unsigned char* row = image.getRow(y);
+            for (int x = 0; x < width; x += 5) {
+                for (int c = 1; c < channels; c++) row[x * channels + c] = row[x * channels];
+            }
+        }
+        return image;
+    }
+
+    // Equalization pixel by pixel through HSV, as the filter computed it originally
+    Image referenceEqualization(const Image& input) {
+        int width = input.getWidth();
+        int height = input.getHeight();
+        bool grey = input.getChannels() == 1;
+        std::vector<int> histogram(256, 0);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                float h, s, v;
+                input.getPixel(x, y).RGBtoHSV(h, s, v);
+                histogram[grey ? input.getPixel(x, y).getR() : static_cast<int>(v * 255.0f)]++;
+            }
+        }
+        std::vector<unsigned char> map = SimpleFilters::computeHistogramEqualizationMap(histogram);
+
+        Image output(width, height, grey ? 1 : 3);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                Pixel pixel = input.getPixel(x, y);
+                if (grey) {
+                    unsigned char value = map[pixel.getR()];
+                    output.setPixel(x, y, Pixel(value, value, value));
+                    continue;
+                }
+                float h, s, v;
+                pixel.RGBtoHSV(h, s, v);
+                Pixel newPixel;
+                newPixel.HSVtoRGB(h, s, map[static_cast<int>(v * 255.0f)] / 255.0f);
+                output.setPixel(x, y, newPixel);
+            }
+        }
+        return output;
+    }
+
+}
+
+/**
+ * @brief Runs tests for the SimpleFilters histogram equalization
+ *
+ * Tests include:
+ * - Matching the per-pixel HSV equalization exactly, for 1 to 4 channels
+ * - Flat grey and black images
+ * - Rejecting colour images in the greyscale version
+ */
+void runSimpleFiltersTests() {
+    std::cout << "  Testing SimpleFilters..." << std::endl;
+
+    // Test 1: Banded histograms and the single remapping pass match the reference
+    for (int channels = 1; channels <= 4; channels++) {
+        Image input = makeGreyMixImage(37, 113, channels);
+        Image output = SimpleFilters("HistogramEqualization").apply(input);
+        CHECK(output.getChannels() == (channels == 1 ? 1 : 3), "Equalized image has one or three channels");
+        CHECK(sameImage(output, referenceEqualization(input)), "Equalization matches the per-pixel HSV version");
+    }
+
+    // Test 2: A flat grey image stretches to white; a black one hits the empty map and stays black
+    Image flat(16, 9, 3);
+    for (int y = 0; y < flat.getHeight(); y++) {
+        for (int x = 0; x < flat.getWidth(); x++) flat.setPixel(x, y, Pixel(120, 120, 120));
+    }
+    Image flatOutput = SimpleFilters("HistogramEqualization").apply(flat);
+    CHECK(flatOutput.getPixel(0, 0) == Pixel(255, 255, 255), "Flat grey image maps to white");
+    CHECK(flatOutput.getPixel(15, 8) == Pixel(255, 255, 255), "Flat grey image maps to white in the last band");
+    Image black(16, 9, 1);
+    Image blackOutput = SimpleFilters("HistogramEqualization").apply(black);
+    CHECK(blackOutput.getPixel(15, 8) == Pixel(0, 0, 0), "Black image stays black");
+
+    // Test 3: The greyscale version needs a single channel
+    SimpleFilters filters("HistogramEqualization");
+    CHECK_THROWS(filters.applyGreyscaleHistogramEqualization(makeNoiseImage(4, 4, 3)),
+                 "Greyscale equalization rejects colour images");
+}
@@ -0,0 +1,143 @@
+/**
+ * @file testThreadPool.cpp
+ * @brief Tests for the ThreadPool class and the determinism of the parallel 2D filters
+ * @group [Euler]
+ *
+ * Group members:
+ * - [Davide Baino] ([esemsc-db24])
+ * - [Qi Gao] ([esemsc-qg124])
+ * - [Daniel Kaupa] ([esemsc-dbk24])
+ * - [Leyao Liu] ([esemsc-ll1524])
+ * - [Jiayi Lu] ([esemsc-jl7324])
+ * - [Ananya Sinha] ([esemsc-as10524])
+ * - [Mingwei Yan] ([esemsc-my324])
+ */
+
+#include "TestCounters.h"      // Include test counters and assertion macros
+#include "TestImages.h"
+#include "../src/ThreadPool.h"
+#include "../src/Image.h"
+#include "../src/filter2D/BoxBlurFilter.h"
+#include "../src/filter2D/GaussianBlurFilter.h"
+#include "../src/filter2D/MedianBlurFilter.h"
+#include "../src/filter2D/PrewittFilter.h"
+#include "../src/filter2D/RobertsCrossFilter.h"
+#include "../src/filter2D/ScharrFilter.h"
+#include "../src/filter2D/SharpeningFilter.h"
+#include "../src/filter2D/SimpleFilters.h"
+#include "../src/filter2D/SobelFilter.h"
+#include "../src/Volume.h"
+#include "../src/filter3D/Gaussian3DFilter.h"
+#include "../src/filter3D/Median3DFilter.h"
+#include "../src/projectionFunc/AvgIntensityProj.h"
+#include "../src/projectionFunc/MaxIntensityProj.h"
+#include "../src/projectionFunc/MinIntensityProj.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Runs tests for the ThreadPool class
+ *
+ * This function tests:
+ * - Constructor validation.
+ * - parallelFor visiting every index exactly once, including ranges smaller than the pool.
+ * - Exceptions thrown in a band being rethrown by parallelFor.
+ * - Nested parallelFor calls running inline.
+ * - Every 2D filter, 3D filter and projection giving bit-identical output with one thread
+ *   and with several.
+ */
+void runThreadPoolTests() {
+    std::cout << "  Testing ThreadPool..." << std::endl;
+
+    // Test 1: Constructor validation
+    CHECK_THROWS(ThreadPool(0), "Zero threads throws");
+    CHECK(ThreadPool(3).getThreadCount() == 3, "Thread count includes the caller");
+
+    // Test 2: Every index visited exactly once
+    ThreadPool pool(4);
+    for (int count : {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> visits(count);
+        pool.parallelFor(0, count, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) visits[i]++;
+        });
+        bool once = std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v == 1; });
+        CHECK(once, "Each of " << count << " indices visited once");
+    }
+
+    // Test 3: Exceptions propagate to the caller
+    CHECK_THROWS(pool.parallelFor(0, 100, [](int begin, int) {
+        if (begin > 0) throw std::runtime_error("band failed");
+    }), "Exception in a band is rethrown");
+    std::atomic<int> total{0};
+    pool.parallelFor(0, 100, [&](int begin, int end) { total += end - begin; });
+    CHECK(total == 100, "Pool still usable after an exception");
+
+    // Test 4: Nested calls run inline
+    std::atomic<int> inner{0};
+    pool.parallelFor(0, 8, [&](int begin, int end) {
+        pool.parallelFor(begin, end, [&](int b, int e) { inner += e - b; });
+    });
+    CHECK(inner == 8, "Nested parallelFor covers its range");
+
+    // Test 5: Filters are bit-identical for any thread count
+    std::vector<std::pair<std::string, std::function<std::unique_ptr<Filter>()>>> filters = {
+        {"Box", [] { return std::make_unique<BoxBlurFilter>(7); }},
+        {"Gaussian separable", [] { return std::make_unique<GaussianBlurFilter>(5, 1.5f); }},
+        {"Gaussian recursive", [] { return std::make_unique<GaussianBlurFilter>(21, 3.0f); }},
+        {"Median", [] { return std::make_unique<MedianBlurFilter>(9); }},
+        {"Sharpening", [] { return std::make_unique<SharpeningFilter>(); }},
+        {"Sobel", [] { return std::make_unique<SobelFilter>(); }},
+        {"Prewitt", [] { return std::make_unique<PrewittFilter>(); }},
+        {"Scharr", [] { return std::make_unique<ScharrFilter>(); }},
+        {"RobertsCross", [] { return std::make_unique<RobertsCrossFilter>(); }},
+        {"Greyscale", [] { return std::make_unique<SimpleFilters>("Greyscale"); }},
+        {"HistogramEqualization", [] { return std::make_unique<SimpleFilters>("HistogramEqualization"); }},
+    };
+    Image input = makeNoiseImage(67, 45, 3, 31);
+    for (auto& [name, makeFilter] : filters) {
+        ThreadPool::setSharedThreadCount(1);
+        Image serial = makeFilter()->apply(input);
+        ThreadPool::setSharedThreadCount(5);
+        Image parallel = makeFilter()->apply(input);
+        CHECK(sameImage(serial, parallel), name << " identical with 1 and 5 threads");
+    }
+
+    // Test 6: 3D filters (Z slabs) and projections (row tiles) are bit-identical too
+    for (int channels : {1, 3}) {
+        Volume volume(19, 13, 11, channels, "Noise");
+        unsigned int seed = 5;
+        for (size_t i = 0; i < static_cast<size_t>(19) * 13 * 11 * channels; i++) {
+            volume.getData()[i] = static_cast<unsigned char>(nextNoise(seed));
+        }
+        std::vector<std::unique_ptr<Volume>> serialVolumes, parallelVolumes;
+        std::vector<Image> serialImages, parallelImages;
+        for (int threads : {1, 5}) {
+            ThreadPool::setSharedThreadCount(threads);
+            auto& volumes = (threads == 1) ? serialVolumes : parallelVolumes;
+            auto& images = (threads == 1) ? serialImages : parallelImages;
+            volumes.push_back(Gaussian3DFilter(5, 1.2f).apply(volume));
+            volumes.push_back(Median3DFilter(3).apply(volume));
+            images.push_back(MaxIntensityProj(0, -1, 40.0f).apply(volume));
+            images.push_back(MinIntensityProj().apply(volume));
+            images.push_back(AvgIntensityProj(2, 9, false).apply(volume));
+            images.push_back(AvgIntensityProj(0, -1, true).apply(volume));
+        }
+        CHECK(sameVolume(*serialVolumes[0], *parallelVolumes[0]),
+              "Gaussian3D identical with 1 and 5 threads (" << channels << " channels)");
+        CHECK(sameVolume(*serialVolumes[1], *parallelVolumes[1]),
+              "Median3D identical with 1 and 5 threads (" << channels << " channels)");
+        const char* projections[] = {"MIP", "MinIP", "mean AIP", "median AIP"};
+        for (int i = 0; i < 4; i++) {
+            CHECK(sameImage(serialImages[i], parallelImages[i]),
+                  projections[i] << " identical with 1 and 5 threads (" << channels << " channels)");
+        }
+    }
+    ThreadPool::setSharedThreadCount(ThreadPool::defaultThreadCount());
+}
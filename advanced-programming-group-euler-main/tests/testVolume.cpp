@@ -1,11 +1,20 @@
 #include "../src/Volume.h"
 #include "../src/Pixel.h"
 #include "../src/filter3D/Gaussian3DFilter.h"
+#include "../src/ThreadPool.h"
+#include "../src/SliceCache.h"
+#include "../src/Slice.h"
+#include "../src/Image.h"
+#include "../src/projectionFunc/MaxIntensityProj.h"
+#include "../src/projectionFunc/AvgIntensityProj.h"
 #include "TestCounters.h"
+#include "TestImages.h"
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 
 namespace fs = std::filesystem;
@@ -98,6 +107,214 @@ void test_file_io() {
     fs::remove_all(testDir);
 }
 
+void test_parallel_load() {
+    fs::path testDir = "test_volume_parallel";
+    fs::create_directory(testDir);
+
+    // Mixed channel counts: greyscale slices are widened to the RGB of the first slice
+    std::vector<std::string> files;
+    for (int z = 0; z < 9; z++) {
+        int sliceChannels = (z % 3 == 1) ? 1 : 3;
+        Volume sliceVol(4, 3, 1, sliceChannels, "slice");
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 4; x++) {
+                unsigned char v = static_cast<unsigned char>(z * 20 + y * 4 + x);
+                sliceVol.setVoxel(x, y, 0, Pixel(v, v + 1, v + 2));
+            }
+        }
+        files.push_back((testDir / ("slice_" + std::to_string(z) + ".png")).string());
+        sliceVol.saveToFile(files.back());
+    }
+
+    ThreadPool::setSharedThreadCount(1);
+    Volume serial(files, "serial");
+    ThreadPool::setSharedThreadCount(4);
+    Volume parallel(files, "parallel");
+
+    size_t bytes = static_cast<size_t>(serial.getZStride()) * serial.getDepth();
+    CHECK(parallel.getDepth() == 9 && parallel.getChannels() == 3, "Parallel load has correct shape");
+    CHECK(std::equal(serial.getData(), serial.getData() + bytes, parallel.getData()),
+          "Parallel load matches single-threaded load");
+    CHECK(parallel.getVoxel(1, 2, 4).getR() == parallel.getVoxel(1, 2, 4).getB() &&
+          parallel.getVoxel(1, 2, 3).getR() != parallel.getVoxel(1, 2, 3).getB(),
+          "Greyscale slice widened to RGB");
+
+    // A slice of a different size is still reported
+    Volume odd(5, 3, 1, 3, "odd");
+    std::string oddFile = (testDir / "slice_odd.png").string();
+    odd.saveToFile(oddFile);
+    files.push_back(oddFile);
+    bool reported = false;
+    try {
+        Volume mismatched(files, "mismatched");
+    } catch (const std::runtime_error& e) {
+        reported = std::string(e.what()).find("slice_odd.png differs from") != std::string::npos;
+    }
+    CHECK(reported, "Mismatched slice size is reported with the offending file");
+
+    // A missing slice fails the load
+    files.back() = (testDir / "missing.png").string();
+    CHECK_THROWS(Volume missing(files, "missing"), "Missing slice fails the load");
+
+    ThreadPool::setSharedThreadCount(ThreadPool::defaultThreadCount());
+    fs::remove_all(testDir);
+}
+
+void test_raw_format() {
+    fs::path rawFile = "test_volume_raw.apv";
+
+    Volume original(5, 4, 3, 3, "original");
+    for (int z = 0; z < 3; z++) {
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 5; x++) {
+                original.setVoxel(x, y, z, Pixel(x * 40, y * 60, z * 100));
+            }
+        }
+    }
+    CHECK(original.saveToRaw(rawFile.string()), "Raw volume saved");
+    CHECK(fs::file_size(rawFile) == 64 + 5 * 4 * 3 * 3, "Raw file is header plus samples");
+
+    Volume loaded(1, 1, 1, 1, "loaded");
+    CHECK(loaded.loadFromRaw(rawFile.string(), true), "Raw volume reopened with checksum check");
+    CHECK(loaded.getWidth() == 5 && loaded.getHeight() == 4 && loaded.getDepth() == 3 &&
+          loaded.getChannels() == 3, "Raw volume keeps its dimensions");
+    size_t bytes = static_cast<size_t>(original.getZStride()) * original.getDepth();
+    CHECK(std::equal(original.getData(), original.getData() + bytes, loaded.getData()),
+          "Raw volume keeps its samples");
+
+    // Writes stay in memory and copies do not share the mapping
+    Volume copy(loaded);
+    loaded.setVoxel(1, 1, 1, Pixel(7, 7, 7));
+    CHECK(copy.getVoxel(1, 1, 1).getR() == 40, "Copy of a mapped volume is independent");
+    Volume reopened(1, 1, 1, 1, "reopened");
+    reopened.loadFromRaw(rawFile.string());
+    CHECK(reopened.getVoxel(1, 1, 1).getR() == 40, "Writes to a mapped volume do not reach the file");
+
+    // A cropped mapped volume reads the same slab as a cropped copy in memory
+    reopened.cropDepth(1, 2);
+    Volume inMemory(original);
+    inMemory.cropDepth(1, 2);
+    CHECK(reopened.getDepth() == 2 && inMemory.getDepth() == 2, "Cropped volumes keep two slices");
+    CHECK(reopened.getVoxel(2, 3, 0).getB() == 100 && inMemory.getVoxel(2, 3, 1).getB() == 200,
+          "Cropped volumes start at the first kept slice");
+    CHECK(sameVolume(reopened, inMemory), "Mapped and in-memory crops agree");
+    CHECK_THROWS(reopened.cropDepth(1, 2), "Crop outside the volume throws");
+
+    // Corrupt one sample: the header is still valid, only the checksum catches it
+    {
+        std::fstream file(rawFile, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64 + 10);
+        file.put('\x55');
+    }
+    Volume corrupt(1, 1, 1, 1, "corrupt");
+    CHECK_THROWS(corrupt.loadFromRaw(rawFile.string(), true), "Checksum mismatch is reported");
+
+    // A file that is not a raw volume, and a missing one
+    fs::resize_file(rawFile, 20);
+    CHECK_THROWS(corrupt.loadFromRaw(rawFile.string()), "Truncated raw file throws");
+    fs::remove(rawFile);
+    CHECK(!corrupt.loadFromRaw(rawFile.string()), "Missing raw file fails to load");
+}
+
+void test_lazy_load() {
+    fs::path testDir = "test_volume_lazy";
+    fs::create_directory(testDir);
+
+    std::vector<std::string> files;
+    for (int z = 0; z < 6; z++) {
+        Volume sliceVol(5, 4, 1, 3, "slice");
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 5; x++) {
+                sliceVol.setVoxel(x, y, 0, Pixel(x * 50, y * 60 + z, z * 40));
+            }
+        }
+        files.push_back((testDir / ("slice_" + std::to_string(z) + ".png")).string());
+        sliceVol.saveToFile(files.back());
+    }
+    Volume eager(files, "eager");
+    const size_t sliceBytes = 5 * 4 * 3;
+
+    // Opening reads the headers only; one XY slice decodes one file
+    Volume lazy(1, 1, 1, 1, "lazy");
+    CHECK(lazy.loadFromFilesLazy(files), "Lazy volume opened");
+    CHECK(lazy.isLazy() && lazy.getWidth() == 5 && lazy.getHeight() == 4 && lazy.getDepth() == 6 &&
+          lazy.getChannels() == 3, "Lazy volume knows its dimensions");
+    SliceCache* cache = lazy.getSliceCache();
+    CHECK(cache->getDecodeCount() == 0, "Opening a lazy volume decodes nothing");
+    Image xy = lazy.extractSlice(Slice(SlicePlane::XY, 3));
+    CHECK(cache->getDecodeCount() == 1, "XY slice decodes a single file");
+    CHECK(xy.getPixel(2, 1).getG() == eager.getVoxel(2, 1, 2).getG(), "Lazy XY slice matches eager");
+    CHECK(lazy.getVoxel(4, 3, 2).getG() == eager.getVoxel(4, 3, 2).getG() && cache->getDecodeCount() == 1,
+          "Voxel read from a cached slice");
+
+    // Slices across Z and projections match the eager volume
+    for (SlicePlane plane : {SlicePlane::XZ, SlicePlane::YZ}) {
+        Image fromLazy = lazy.extractSlice(Slice(plane, 2));
+        Image fromEager = eager.extractSlice(Slice(plane, 2));
+        bool same = fromLazy.getWidth() == fromEager.getWidth() && fromLazy.getHeight() == fromEager.getHeight();
+        for (int y = 0; same && y < fromEager.getHeight(); y++) {
+            same = std::equal(fromEager.getRow(y), fromEager.getRow(y) + fromEager.getWidth() * 3, fromLazy.getRow(y));
+        }
+        CHECK(same, "Lazy " << (plane == SlicePlane::XZ ? "XZ" : "YZ") << " slice matches eager");
+    }
+    MaxIntensityProj mip(1, 3);
+    AvgIntensityProj median(0, -1, true);
+    for (const Projection* projection : {static_cast<const Projection*>(&mip), static_cast<const Projection*>(&median)}) {
+        Image fromLazy = lazy.applyProjection(*projection);
+        Image fromEager = eager.applyProjection(*projection);
+        bool same = true;
+        for (int y = 0; same && y < 4; y++) {
+            same = std::equal(fromEager.getRow(y), fromEager.getRow(y) + 5 * 3, fromLazy.getRow(y));
+        }
+        CHECK(same, "Lazy projection matches eager");
+    }
+
+    // A slab-limited projection decodes only its slab
+    Volume slab(1, 1, 1, 1, "slab");
+    slab.loadFromFilesLazy(files);
+    slab.applyProjection(mip);
+    CHECK(slab.getSliceCache()->getDecodeCount() == 3, "Slab projection decodes only the slab");
+
+    // The cache stays within its budget, evicting the least recently used slice
+    Volume bounded(1, 1, 1, 1, "bounded");
+    bounded.loadFromFilesLazy(files, 2 * sliceBytes);
+    SliceCache* boundedCache = bounded.getSliceCache();
+    bounded.getVoxel(0, 0, 0);
+    bounded.getVoxel(0, 0, 1);
+    bounded.getVoxel(0, 0, 0);
+    bounded.getVoxel(0, 0, 2);
+    CHECK(boundedCache->getCachedBytes() == 2 * sliceBytes, "Cache respects its budget");
+    bounded.getVoxel(0, 0, 0);
+    CHECK(boundedCache->getDecodeCount() == 3, "Recently used slice survives eviction");
+    bounded.getVoxel(0, 0, 1);
+    CHECK(boundedCache->getDecodeCount() == 4, "Least recently used slice was evicted");
+    bounded.extractSlice(Slice(SlicePlane::XZ, 1));
+    CHECK(boundedCache->getCachedBytes() <= 2 * sliceBytes, "Slice across Z stays within budget");
+    boundedCache->setBudget(0);
+    CHECK(boundedCache->getCachedBytes() == sliceBytes, "Shrinking the budget keeps one slice");
+
+    // The voxel buffer only exists once every slice is loaded
+    CHECK_THROWS(lazy.getData(), "Raw access to a lazy volume throws");
+    CHECK_THROWS(lazy.getViewXZ(0), "Views of a lazy volume throw");
+    auto blurred = lazy.applyGaussianFilter(3, 1.0f);
+    CHECK(lazy.isLazy() && !blurred->isLazy(), "Filtering a lazy volume leaves it lazy");
+    lazy.loadAllSlices();
+    size_t bytes = static_cast<size_t>(eager.getZStride()) * eager.getDepth();
+    CHECK(!lazy.isLazy() && lazy.getSliceCache() == nullptr &&
+          std::equal(eager.getData(), eager.getData() + bytes, lazy.getData()),
+          "Loading all slices matches the eager volume");
+
+    // Decoding errors surface when the slice is touched
+    files.push_back((testDir / "missing.png").string());
+    fs::copy_file(files[0], files.back());
+    Volume broken(1, 1, 1, 1, "broken");
+    CHECK(broken.loadFromFilesLazy(files), "Lazy volume opened before a slice goes missing");
+    fs::remove(files.back());
+    CHECK_THROWS(broken.getVoxel(0, 0, 6), "Missing slice throws when touched");
+
+    fs::remove_all(testDir);
+}
+
 // void test_cloning() {
 //     Volume original(5, 5, 5, 4, "original");
 //     original.setVoxel(2, 2, 2, Pixel(255, 0, 0));
@@ -120,14 +337,98 @@ void test_filtering() {
     CHECK(filtered->getVoxel(2, 2, 1).getR() > 0, "Gaussian creates blur effect");
 }
 
+void test_strided_views() {
+    Volume vol(4, 3, 2, 3, "views");
+    for (int z = 0; z < 2; z++) {
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 4; x++) {
+                vol.setVoxel(x, y, z, Pixel(x, y, z));
+            }
+        }
+    }
+
+    // Strides describe one contiguous buffer with X fastest
+    CHECK(vol.getYStride() == 4 * vol.getXStride(), "Y stride is one row");
+    CHECK(vol.getZStride() == 3 * vol.getYStride(), "Z stride is one slice");
+    CHECK(vol.getVoxelPtr(3, 2, 1) == vol.getData() + 3 * vol.getXStride() + 2 * vol.getYStride() + vol.getZStride(),
+          "Voxel pointer follows the strides");
+
+    // Plane views read the same voxels as getVoxel
+    const Volume& cvol = vol;
+    ConstImageView xy = cvol.getViewXY(1);
+    ConstImageView xz = cvol.getViewXZ(2);
+    ConstImageView yz = cvol.getViewYZ(3);
+    ConstImageView column = cvol.getColumnZ(1, 2);
+    CHECK(xy.getWidth() == 4 && xy.getHeight() == 3, "XY view dimensions");
+    CHECK(xz.getWidth() == 4 && xz.getHeight() == 2, "XZ view dimensions");
+    CHECK(yz.getWidth() == 3 && yz.getHeight() == 2, "YZ view dimensions");
+    CHECK(xy.getPixel(3, 2) == vol.getVoxel(3, 2, 1), "XY view matches voxel");
+    CHECK(xz.getPixel(1, 1) == vol.getVoxel(1, 2, 1), "XZ view matches voxel");
+    CHECK(yz.getPixel(2, 1) == vol.getVoxel(3, 2, 1), "YZ view matches voxel");
+    CHECK(column.getPixel(0, 1) == vol.getVoxel(1, 2, 1), "Z-column view matches voxel");
+
+    // Views do not copy: writes through a view show up in the volume
+    vol.getViewYZ(0).setPixel(1, 0, Pixel(9, 9, 9));
+    CHECK(vol.getVoxel(0, 1, 0) == Pixel(9, 9, 9), "Write through YZ view is visible");
+
+    CHECK_THROWS(cvol.getViewXY(2), "XY view out of range throws");
+    CHECK_THROWS(cvol.getViewYZ(-1), "YZ view out of range throws");
+
+    // Clone copies the whole buffer
+    auto copy = vol.clone();
+    vol.setVoxel(0, 0, 0, Pixel(1, 1, 1));
+    CHECK(static_cast<Volume*>(copy.get())->getVoxel(0, 0, 0) == Pixel(0, 0, 0), "Clone is independent of the original");
+    CHECK(static_cast<Volume*>(copy.get())->getVoxel(3, 2, 1) == Pixel(3, 2, 1), "Clone keeps voxel values");
+}
+
+void test_compact_storage() {
+    // Greyscale volumes store one byte per voxel, RGB three
+    Volume grey(4, 4, 4, 1, "grey");
+    Volume rgb(4, 4, 4, 3, "rgb");
+    CHECK(grey.getXStride() == 1 && grey.getZStride() == 16, "Greyscale volume stores one sample per voxel");
+    CHECK(rgb.getXStride() == 3 && rgb.getZStride() == 48, "RGB volume stores three samples per voxel");
+
+    // Single-channel voxels expand to grey pixels, like loaded greyscale slices
+    grey.setVoxel(1, 2, 3, Pixel(77, 5, 6, 10));
+    CHECK(*grey.getVoxelPtr(1, 2, 3) == 77, "Only the first sample is stored");
+    CHECK(grey.getVoxel(1, 2, 3) == Pixel(77, 77, 77), "Greyscale voxel reads back as grey");
+
+    // The greyscale fast paths agree with the Pixel based ones on an equivalent RGB volume
+    for (int z = 0; z < 4; z++) {
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                unsigned char v = static_cast<unsigned char>((x * 37 + y * 11 + z * 71) % 256);
+                grey.setVoxel(x, y, z, Pixel(v, v, v));
+                rgb.setVoxel(x, y, z, Pixel(v, v, v));
+            }
+        }
+    }
+    auto greyBlur = Gaussian3DFilter(3, 1.0f).apply(grey);
+    auto rgbBlur = Gaussian3DFilter(3, 1.0f).apply(rgb);
+    bool same = true;
+    for (int z = 0; z < 4; z++) {
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                if (greyBlur->getVoxel(x, y, z) != rgbBlur->getVoxel(x, y, z)) same = false;
+            }
+        }
+    }
+    CHECK(same, "Greyscale Gaussian matches RGB Gaussian");
+}
+
 void runVolumeTests() {
     std::cout << "\n=== Running Volume Tests ===\n";
     
     test_constructors();
     test_voxel_operations();
     test_file_io();
+    test_parallel_load();
+    test_raw_format();
+    test_lazy_load();
     // test_cloning();
     test_filtering();
+    test_strided_views();
+    test_compact_storage();
     
     // std::cout << "\nVolume Tests Summary: "
     //           << passed << " passed, " << failed << " failed\n";